@@ -20,6 +20,7 @@ TEMPLATE = app
 CONFIG += console
 CONFIG -= app_bundle
 CONFIG -= qt
+CONFIG += c++11
 
 CONFIG += link_pkgconfig
 PKGCONFIG += opencv
@@ -32,7 +33,19 @@ SOURCES += \
     src/master_frames.cpp \
     src/image_reconstruction.cpp \
     src/line_and_point_operations.cpp \
-    src/message_handler.cpp
+    src/message_handler.cpp \
+    src/semantic_cost_table.cpp \
+    src/frame_cache.cpp \
+    src/feature_store.cpp \
+    src/homography_interpolation.cpp \
+    src/feature_matcher.cpp \
+    src/feature_extractor.cpp \
+    src/reconstruction_window.cpp \
+    src/scratch_arena.cpp \
+    src/video_sink.cpp \
+    src/perspective_warp.cpp \
+    src/homography_ransac.cpp \
+    src/candidate_score_cache.cpp
 
 HEADERS += \
     definitions/experiments.h \
@@ -46,7 +59,20 @@ HEADERS += \
     headers/image_reconstruction.h \
     headers/line_and_point_operations.h \
     headers/message_handler.h \
-    headers/error_messages.h
+    headers/error_messages.h \
+    headers/semantic_cost_table.h \
+    headers/frame_cache.h \
+    headers/feature_store.h \
+    headers/blocking_queue.h \
+    headers/homography_interpolation.h \
+    headers/feature_matcher.h \
+    headers/feature_extractor.h \
+    headers/reconstruction_window.h \
+    headers/scratch_arena.h \
+    headers/video_sink.h \
+    headers/perspective_warp.h \
+    headers/homography_ransac.h \
+    headers/candidate_score_cache.h
 
 OTHER_FILES += \
     txt/Output_errors_description.txt \
@@ -70,6 +96,7 @@ LIBS += -L/usr/local/lib \
      -lboost_system \
      -lboost_filesystem \
      -larmadillo \
+     -lpthread \
      -fopenmp
 
 
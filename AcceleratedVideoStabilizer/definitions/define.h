@@ -44,6 +44,9 @@
 /** Print variable values for each step of processing in the homography cpp file.*/
 #define DEBUG_HOMOGRAPHY                0 /*true*/    /*false*/
 
+/** Compare the coverage given by the warped corners with the one given by a warped mask and print the mismatches.*/
+#define DEBUG_COVERAGE                  0 /*true*/    /*false*/
+
 /** Print variable values for each step of processing in the image_reconstruciton cpp file.*/
 #define DEBUG_RECONSTRUCTION            0 /*true*/    /*false*/
 
@@ -56,12 +59,58 @@
 /** Number maximum of images that could be used to reconstruct a image in the image_reconstruction.cpp */
 #define NUM_MAX_IMAGES_TO_RECONSTRUCT   30
 
+/** Reduction factor of the mask where the area covered by each neighbour is predicted, when planning the reconstruction. */
+#define RECONSTRUCTION_PLAN_SCALE       4
+
 /** The SURF Hessian minimum threshold */
 #define MIN_HESSIAN 400
 
+/** Maximum number of keypoints detected by ORB in a frame */
+#define ORB_NUM_FEATURES 2000
+
+/** Maximum reprojection error, in pixels, of the inliers of the homography estimated by RANSAC. */
+#define RANSAC_REPROJECTION_THRESHOLD 3
+
+/** Maximum number of hypotheses of the RANSAC, and confidence used to stop earlier given the inlier ratio, as the cv::findHomography. */
+#define RANSAC_MAX_ITERATIONS 2000
+#define RANSAC_CONFIDENCE 0.995
+
 /** Multiplier to the minimum distance from descriptors to set a threshold in matches search*/
 #define MATCHES_THRESHOLD_FACTOR 3
 
+/** Minimum threshold, in bits, of the "good" matches of binary descriptors, since their minimum distance is often 0. */
+#define MIN_BINARY_MATCHES_THRESHOLD 30
+
+/** Maximum ratio between the distances to the nearest and to the second nearest descriptor of a good match (Lowe ratio test), used by the FLANN matcher. */
+#define LOWE_RATIO 0.75f
+
+/** Number of randomized KD-trees built by the FLANN matcher. */
+#define FLANN_KDTREE_TREES 4
+
+/** Number of hash tables, size of the hash keys in bits and multi-probe level of the LSH index used by the FLANN matcher for binary descriptors. */
+#define FLANN_LSH_TABLES 6
+#define FLANN_LSH_KEY_SIZE 12
+#define FLANN_LSH_MULTI_PROBE_LEVEL 1
+
+/** Number of leaves checked in each search of the FLANN matcher. */
+#define FLANN_SEARCH_CHECKS 32
+
+/** Number of matchers (of different master frames) kept built at the same time. */
+#define FEATURE_MATCHER_CACHE_SIZE 8
+
+/** Use the RANSAC inliers of a pair of frames in both directions when choosing the master of a segment, computing half of the homographies.
+ *  The inliers are not symmetric, so it may select other masters than the first versions, which compute each direction (0). **/
+#define MASTER_SYMMETRIC_PAIRS          0 /*false*/    /*true*/
+
+/** Number of threads decoding the video in the parallel master frames search, each one reading a contiguous chunk of segments sequentially. **/
+#define MASTER_DECODER_THREADS          1
+
+/** Maximum number of segments given at once to a worker of the master frames search with the guided schedule. **/
+#define MASTER_GUIDED_MAX_SEGMENTS      8
+
+/** Only one of each MASTER_CANDIDATE_STRIDE frames of a segment is a candidate to master. 1 tries all the frames. **/
+#define MASTER_CANDIDATE_STRIDE         1
+
 /** The percentage of the original image that can be lost **/
 #define CROP_PORTION 0.05f
 
@@ -74,4 +123,44 @@
 /** Max number of frames skip from any frame. Defined by the fast-forward algorithm. **/
 #define MAX_SKIP 100
 
+/** Maximum memory, in megabytes, used by the decoded frames kept in the FrameCache. **/
+#define FRAME_CACHE_BUDGET_MB 1024
+
+/** Number of frames decoded by the FrameCache each time a frame is not found in the cache. **/
+#define FRAME_CACHE_READ_AHEAD 8
+
+/** Maximum forward distance read sequentially, without seeking, by the FrameCache. **/
+#define FRAME_CACHE_MAX_SEQUENTIAL_SKIP 64
+
+/** Maximum memory, in megabytes, used by the decoded frames kept in the ReconstructionWindows of all the threads together. **/
+#define RECONSTRUCTION_WINDOW_BUDGET_MB 1024
+
+/** Maximum number of free temporary matrices kept by the ScratchArena of each thread. **/
+#define SCRATCH_ARENA_MAX_BUFFERS 16
+
+/** Rows and columns of the tiles of the warped image computed at once by the warpPerspectiveBilinear, so the source pixels read by a tile stay in the L2 cache. **/
+#define PERSPECTIVE_WARP_TILE_ROWS 32
+#define PERSPECTIVE_WARP_TILE_COLS 256
+
+/** Measure the time of the warpPerspectiveBilinear and of the cv::warpPerspective with the first frame of the video, and print them. **/
+#define BENCHMARK_PERSPECTIVE_WARP      0 /*true*/    /*false*/
+
+/** Measure the BruteForce and the FLANN matchers with the first frames of the video, and print their speed and inliers. **/
+#define BENCHMARK_FEATURE_MATCHER       0 /*true*/    /*false*/
+
+/** Number of frames read by the benchmark of the matchers. The first one is matched to the others. **/
+#define MATCHER_BENCHMARK_FRAMES        16
+
+/** Save the features of the frames in a file next to the video to reuse them in the next runs. **/
+#define USE_FEATURE_STORE 1
+
+/** Number of decoded candidates, per worker thread, waiting to be scored by the selectNewFrame. **/
+#define SELECTION_FRAMES_PER_WORKER 2
+
+/** Number of frames waiting in the queue of the encoder thread of the output video. **/
+#define VIDEO_SINK_QUEUE_SIZE 8
+
+/** Number of segments, per worker thread, that can be in the stabilization pipeline or waiting in the master frames search at the same time. **/
+#define PIPELINE_SEGMENTS_PER_WORKER 2
+
 #endif // DEFINE_H
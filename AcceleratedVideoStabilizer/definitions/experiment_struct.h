@@ -42,10 +42,15 @@ struct EXPERIMENT {
     std::string     instability_costs_filename;     /** Complete path and filename of the csv file with the jitter costs of the transitions. */
     std::string     optical_flow_filename;          /** Complete path and filename of the csv file with the optical flow calculated by the FlowNet. */
     std::string     log_file_name;                  /** Complete path and filename to save the txt file log execution. */
+    std::string     feature_detector;               /** Method used to detect and describe the keypoints of the frames: "SURF" (default) or "ORB". */
+    std::string     descriptor_matcher;             /** Method used to match the descriptors of the frames: "BruteForce" (default) or "FLANN". */
     int             segment_size;                   /** Size of the segments where the master frames will be calculated. It needs to be a power of two (2, 4, 8, 16, ...). */
     bool            save_master_frames_in_disk;     /** After calculte the master frames, do you want to save it in a file? After you can load it directly withou calculate again */
     bool            save_video_in_disk;             /** Save stabilized video in Disk. */
     bool            running_parallel;               /** Running the master frames selection in parallel processors. */
+    int             num_threads;                    /** Number of worker threads used when running in parallel, 0 for one per core. */
+    std::string     master_schedule;                /** How the segments are given to the threads of the master frames search: "dynamic" (default) or "guided". */
+    std::string     video_codec;                    /** Four characters of the codec of the stabilized video: "mp4v" (default), "XVID", "MJPG", ... */
     bool            exist;                          /** True indicates the informations is updated. If you do not want run this configuration anymore just use value false */
 };
 
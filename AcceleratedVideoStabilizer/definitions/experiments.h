@@ -57,6 +57,11 @@ EXPERIMENT load_experiments_settings ( std::string settingsFilename ){
     bool            saveMasterFramesInDisk = false; /** <i>bool</i> <b>saveMasterFramesInDisk:</b> After calculte the master frames, do you want to save it in a file? After you can load it directly withou calculate again */
     bool            saveVideoInDisk = false;        /** <i>bool</i> <b>saveVideoInDisk:</b> Save stabilized video in Disk. */
     bool            runningParallel = true;         /** <i>bool</i> <b>runningParallel:</b> Running the master frames selection in parallel processors. */
+    int             numThreads = 0;                 /** <i>int</i> <b>numThreads:</b> Number of worker threads used when running in parallel, 0 for one per core. */
+    std::string     masterSchedule;                 /** <i>std::string</i> <b>masterSchedule:</b> How the segments are given to the threads of the master frames search: "dynamic" (default) or "guided". */
+    std::string     videoCodec;                     /** <i>std::string</i> <b>videoCodec:</b> Four characters of the codec of the stabilized video: "mp4v" (default), "XVID", "MJPG", ... */
+    std::string     featureDetector;                /** <i>std::string</i> <b>featureDetector:</b> Method used to detect and describe the keypoints of the frames: "SURF" (default) or "ORB". */
+    std::string     descriptorMatcher;              /** <i>std::string</i> <b>descriptorMatcher:</b> Method used to match the descriptors of the frames: "BruteForce" (default) or "FLANN". */
  
     cv::FileStorage fs(settingsFilename, cv::FileStorage::READ);
     
@@ -71,8 +76,13 @@ EXPERIMENT load_experiments_settings ( std::string settingsFilename ){
     selected_frames_filename = filter_string(fs["selected_frames_filename"]);
     read_masterframes_filename = filter_string(fs["read_masterframes_filename"]);
     semantic_costs_filename = filter_string(fs["semantic_costs_filename"]);
+    featureDetector = filter_string(fs["featureDetector"]);
+    descriptorMatcher = filter_string(fs["descriptorMatcher"]);
+    masterSchedule = filter_string(fs["masterSchedule"]);
+    videoCodec = filter_string(fs["videoCodec"]);
     
     segmentSize = fs["segmentSize"];
+    numThreads = std::max(0, (int)fs["numThreads"]);
     
     runningParallel = str2bool(fs["runningParallel"]);
     saveMasterFramesInDisk = str2bool(fs["saveMasterFramesInDisk"]);
@@ -101,7 +111,12 @@ EXPERIMENT load_experiments_settings ( std::string settingsFilename ){
     experiment_settings.original_video_filename = original_video_filename;
     experiment_settings.segment_size = segmentSize;
     experiment_settings.running_parallel = runningParallel;
+    experiment_settings.num_threads = numThreads;
+    experiment_settings.master_schedule = masterSchedule;
+    experiment_settings.video_codec = videoCodec;
     experiment_settings.optical_flow_filename = optical_flow_filename;
+    experiment_settings.feature_detector = featureDetector;
+    experiment_settings.descriptor_matcher = descriptorMatcher;
 
     return experiment_settings;
 }
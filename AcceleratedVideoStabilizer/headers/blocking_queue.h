@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file blocking_queue.h
+ *
+ * Bounded queue shared by the threads of the stabilization pipeline.
+ *
+ */
+
+#ifndef BLOCKING_QUEUE_H
+#define BLOCKING_QUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+/**
+ * @brief The BlockingQueue class is a FIFO queue with a maximum size. A producer waits while the queue is full and a
+ *          consumer waits while it is empty, until the queue is closed.
+ */
+template <typename T>
+class BlockingQueue
+{
+public:
+    explicit BlockingQueue ( const size_t capacity ) :
+        capacity(capacity),
+        closed(false)
+    {
+    }
+
+    /**
+     * @brief BlockingQueue::push Inserts the item in the end of the queue, waiting while the queue is full.
+     * @param item - item to be inserted.
+     * @return \c bool \b false if the queue was closed and the item was not inserted.
+     */
+    bool push ( const T &item )
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_full.wait(lock, [this]{ return items.size() < capacity || closed; });
+
+        if ( closed )
+            return false;
+
+        items.push_back(item);
+        not_empty.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief BlockingQueue::pop Removes the item in the front of the queue, waiting while the queue is empty.
+     * @param item - object to receive the item.
+     * @return \c bool \b false if the queue is closed and there are no more items.
+     */
+    bool pop ( T &item )
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        not_empty.wait(lock, [this]{ return !items.empty() || closed; });
+
+        if ( items.empty() )
+            return false;
+
+        item = items.front();
+        items.pop_front();
+        not_full.notify_one();
+        return true;
+    }
+
+    /**
+     * @brief BlockingQueue::size Returns the number of items waiting in the queue.
+     * @return \c size_t
+     */
+    size_t size ( void ) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return items.size();
+    }
+
+    /**
+     * @brief BlockingQueue::close Finishes the queue. The items already inserted can still be removed.
+     */
+    void close ( void )
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        not_empty.notify_all();
+        not_full.notify_all();
+    }
+
+private:
+    BlockingQueue ( const BlockingQueue& );
+    BlockingQueue& operator= ( const BlockingQueue& );
+
+    std::deque<T>               items;
+    size_t                      capacity;
+    bool                        closed;
+    mutable std::mutex          mutex;
+    std::condition_variable     not_empty;
+    std::condition_variable     not_full;
+};
+
+#endif // BLOCKING_QUEUE_H
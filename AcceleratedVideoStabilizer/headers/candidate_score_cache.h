@@ -0,0 +1,113 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @file candidate_score_cache.h
+ *
+ * Header of the CandidateScoreCache class.
+ *
+ */
+
+#ifndef CANDIDATE_SCORE_CACHE_H
+#define CANDIDATE_SCORE_CACHE_H
+
+#include <map>
+#include <mutex>
+
+/**
+ * @brief The CandidateScoreCache class keeps the scores of the candidate frames evaluated by the selectNewFrame: the RANSAC
+ *          inliers with the previous and posterior references and the area ratio after the intermediate homography.
+ *
+ * There is one instance for the whole process, so a new attempt to replace a frame, which evaluates the same window of
+ * candidates, reads the scores instead of computing the homographies again. A score is identified by the candidate, the
+ * window where it was evaluated, the pair of master frames and its position between them. The semantic cost is not kept,
+ * since it is read from a table. All methods are thread-safe.
+ */
+class CandidateScoreCache
+{
+public:
+    /**
+     * @brief The CandidateScoreCache::Key struct identifies the score of a candidate.
+     */
+    struct Key {
+        int     candidate;          /** Index of the candidate in the original video. */
+        int     previous;           /** First frame of the window of candidates in the original video. */
+        int     posterior;          /** Last frame of the window of candidates in the original video. */
+        int     master_pre;         /** Previous master frame in the accelerated video. */
+        int     master_pos;         /** Posterior master frame in the accelerated video. */
+        int     segment_size;       /** Size of the segments (N) in the temporal selection, 0 in the spatial selection. */
+        float   position;           /** Distance to the previous master frame: d in the temporal selection, s in the spatial selection. */
+        float   distance;           /** Distance between the master frames: D in the temporal selection, S in the spatial selection. */
+        bool    spatial;            /** The inliers are with the master frames (spatial selection) or with the ends of the window (temporal selection). */
+
+        bool operator< ( const Key &other ) const;
+    };
+
+    /**
+     * @brief The CandidateScoreCache::Score struct has the values of a candidate computed by the homographies.
+     */
+    struct Score {
+        int     inliers_previous;   /** RANSAC inliers with the previous reference. */
+        int     inliers_posterior;  /** RANSAC inliers with the posterior reference. */
+        double  area_ratio;         /** Area of the crop area not covered after the intermediate homography. */
+    };
+
+    /**
+     * @brief CandidateScoreCache::getInstance Returns the cache shared by the whole process.
+     * @return \c CandidateScoreCache&
+     */
+    static CandidateScoreCache& getInstance     ( void );
+
+    /**
+     * @brief CandidateScoreCache::lookup Looks for the score of a candidate.
+     * @param key - the candidate.
+     * @param score - object to receive the score.
+     * @return \c bool \b false if the score is not kept.
+     */
+    bool                        lookup          ( const Key &key , Score &score );
+
+    /**
+     * @brief CandidateScoreCache::insert Keeps the score of a candidate.
+     * @param key - the candidate.
+     * @param score - the score.
+     */
+    void                        insert          ( const Key &key , const Score &score );
+
+    /**
+     * @brief CandidateScoreCache::getNumLookups Returns the number of scores looked for.
+     * @return \c unsigned long
+     */
+    unsigned long               getNumLookups   ( void );
+
+    /**
+     * @brief CandidateScoreCache::getNumHits Returns the number of scores found.
+     * @return \c unsigned long
+     */
+    unsigned long               getNumHits      ( void );
+
+private:
+    CandidateScoreCache ( void );
+    CandidateScoreCache ( const CandidateScoreCache& );
+    CandidateScoreCache& operator= ( const CandidateScoreCache& );
+
+    std::mutex                  mutex;
+    std::map< Key , Score >     scores;
+    unsigned long               num_lookups;
+    unsigned long               num_hits;
+};
+
+#endif // CANDIDATE_SCORE_CACHE_H
@@ -33,10 +33,15 @@
 * \b -9 - Range limits is not well defined. \n
 * \b -10 - Can not open the CSV file with the semantic costs of the original video. \n
 * \b -11 - Transition from frame_src to frame_dst larger than number of transitions described in the file of the semantic costs                                                 *
+* \b -13 - Unknown descriptor matcher in the settings file. \n
+* \b -14 - Unknown feature detector in the settings file. \n
+* \b -15 - Unknown master frames schedule in the settings file. \n
+* \b -16 - Unknown video codec in the settings file. \n
 */
 enum ErrorMessage{WRONG_INPUT, CANT_OPEN_ACC_VIDEO,
                   CANT_CREATE_OUT_VIDEO, CANT_OPEN_ORI_VIDEO,
                  CANT_OPEN_CSV, CANT_CREATE_DIR, CANT_CREATE_LOG,
-                 RANGE_WRONGLY_DEFINED, CANT_OPEN_SEMANTIC_CSV, LARGE_TRANSITION};
+                 RANGE_WRONGLY_DEFINED, CANT_OPEN_SEMANTIC_CSV, LARGE_TRANSITION, UNKNOWN_MATCHER,
+                 UNKNOWN_DETECTOR, UNKNOWN_SCHEDULE, UNKNOWN_CODEC};
 
 #endif // ERROR_MESSAGES_H
@@ -0,0 +1,106 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file feature_extractor.h
+ *
+ * Header of the FeatureExtractor class.
+ *
+ */
+
+#ifndef FEATURE_EXTRACTOR_H
+#define FEATURE_EXTRACTOR_H
+
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+#include <opencv2/nonfree/nonfree.hpp>
+
+/**
+ * @brief The FeatureType enum
+ */
+enum FeatureType {
+                    SURF_FEATURES,/** SURF keypoints with 64 float descriptors, compared by the L2 distance **/
+                    ORB_FEATURES/** ORB keypoints with 256 bit descriptors, compared by the Hamming distance **/
+                 };
+
+/**
+ * @brief The FeatureExtractor class detects and describes the keypoints of the frames with the method chosen in the
+ *          experiment settings. The method is the same for the whole process, so the features of different frames can
+ *          always be matched.
+ */
+class FeatureExtractor
+{
+public:
+    /**
+     * @brief FeatureExtractor::setType Selects the feature method used by the whole process.
+     * @param type - the feature method.
+     */
+    static void             setType             ( const FeatureType type );
+
+    /**
+     * @brief FeatureExtractor::getType Returns the feature method used by the whole process.
+     * @return \c FeatureType
+     */
+    static FeatureType      getType             ( void );
+
+    /**
+     * @brief FeatureExtractor::parseType Converts the name used in the experiment settings to the feature method.
+     * @param name - "SURF" or "ORB". An empty name selects SURF.
+     * @param type - object to save the feature method.
+     * @return \c bool \b false if the name is unknown.
+     */
+    static bool             parseType           ( const std::string &name , FeatureType &type );
+
+    /**
+     * @brief FeatureExtractor::getName Returns the name of the feature method in lower case, used to name the feature files.
+     * @return \c std::string
+     */
+    static std::string      getName             ( void );
+
+    /**
+     * @brief FeatureExtractor::getDescriptorSize Returns the number of columns of a descriptor.
+     * @return \c int
+     */
+    static int              getDescriptorSize   ( void );
+
+    /**
+     * @brief FeatureExtractor::getDescriptorType Returns the OpenCV type of the descriptors (CV_32F or CV_8U).
+     * @return \c int
+     */
+    static int              getDescriptorType   ( void );
+
+    /**
+     * @brief FeatureExtractor::getDetectorThreshold Returns the parameter of the detector (the Hessian threshold of SURF
+     *          or the number of features of ORB). Features computed with other parameter must not be reused.
+     * @return \c double
+     */
+    static double           getDetectorThreshold ( void );
+
+    /**
+     * @brief FeatureExtractor::detectAndCompute Detects the keypoints of the image and computes their descriptors.
+     * @param image - image to be described.
+     * @param keypoints - object to save the keypoints.
+     * @param descriptors - object to save the descriptors, one per row.
+     */
+    static void             detectAndCompute    ( const cv::Mat &image , std::vector<cv::KeyPoint> &keypoints , cv::Mat &descriptors );
+};
+
+#endif // FEATURE_EXTRACTOR_H
@@ -0,0 +1,117 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file feature_matcher.h
+ *
+ * Header of the FeatureMatcher class.
+ *
+ */
+
+#ifndef FEATURE_MATCHER_H
+#define FEATURE_MATCHER_H
+
+#include <string>
+#include <vector>
+#include <memory>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+#include <opencv2/flann/flann.hpp>
+
+/**
+ * @brief The MatcherType enum
+ */
+enum MatcherType {
+                    BRUTE_FORCE_MATCHER,/** Exhaustive search, the good matches are selected by their distance to the best match **/
+                    FLANN_MATCHER/** Approximate search in a KD-tree (or a LSH table for binary descriptors), the good matches are selected by the Lowe ratio test **/
+                 };
+
+/**
+ * @brief The FeatureMatcher class finds the matches from the descriptors of a frame to the descriptors of another frame.
+ *
+ * A matcher is built for a set of descriptors (the train set, usually the ones of a master frame) and answers the
+ * queries of several frames. The matchers are kept in a small cache, with a copy of their descriptors, so the index of a
+ * master is built only once while its descriptors are being used. The matching method is the same for the whole process and is chosen in the
+ * experiment settings. The queries do not modify the matcher, so they can be done concurrently by several threads.
+ */
+class FeatureMatcher
+{
+public:
+    virtual ~FeatureMatcher ( void ) {}
+
+    /**
+     * @brief FeatureMatcher::getMatcher Returns the matcher of the train descriptors, building it if it is not in the cache.
+     * @param train_descriptors - descriptors to be searched by the queries.
+     * @return \c std::shared_ptr<const FeatureMatcher>
+     */
+    static std::shared_ptr<const FeatureMatcher>    getMatcher      ( const cv::Mat &train_descriptors );
+
+    /**
+     * @brief FeatureMatcher::setType Selects the matching method used by the whole process.
+     * @param type - the matching method.
+     */
+    static void                                     setType         ( const MatcherType type );
+
+    /**
+     * @brief FeatureMatcher::getType Returns the matching method used by the whole process.
+     * @return \c MatcherType
+     */
+    static MatcherType                              getType         ( void );
+
+    /**
+     * @brief FeatureMatcher::parseType Converts the name used in the experiment settings to the matching method.
+     * @param name - "BruteForce" or "FLANN". An empty name selects the brute force method.
+     * @param type - object to save the matching method.
+     * @return \c bool \b false if the name is unknown.
+     */
+    static bool                                     parseType       ( const std::string &name , MatcherType &type );
+
+    /**
+     * @brief FeatureMatcher::findGoodMatches Finds the matches from the query descriptors to the train descriptors that
+     *          are distinctive enough to be used in the homography estimation.
+     * @param query_descriptors - descriptors of the query frame.
+     * @param good_matches - object to save the good matches.
+     * @param mean_threshold - for the brute force method, uses the mean distance of the matches as threshold instead of
+     *          MATCHES_THRESHOLD_FACTOR times the minimum distance.
+     * @return \c bool \b false if the frames are identical, since all the best matches have distance 0.
+     */
+    virtual bool                                    findGoodMatches ( const cv::Mat &query_descriptors , std::vector<cv::DMatch> &good_matches ,
+                                                                      const bool mean_threshold = false ) const = 0;
+
+protected:
+    explicit FeatureMatcher ( const cv::Mat &train_descriptors );
+
+    cv::Mat                 train_descriptors;      /** Descriptors searched by the queries. */
+};
+
+/**
+ * @brief Function that measures the BruteForce and the FLANN matchers (a KD-tree, or a LSH table for binary descriptors)
+ *          matching the features of some frames to the features of the first one, as the frames of a segment to its
+ *          master. Reports the time to build each matcher, the matches per second, and the good matches and the RANSAC
+ *          inliers of both matchers for each frame.
+ *
+ * @param frames - frames of the video used in the measure. The first one is the train set.
+ *
+ * @return \c std::string - the report of the measure.
+ *
+ * @date 17/10/2026
+ */
+std::string benchmarkFeatureMatcher ( const std::vector<cv::Mat> &frames );
+
+#endif // FEATURE_MATCHER_H
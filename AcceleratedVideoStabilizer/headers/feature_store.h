@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file feature_store.h
+ *
+ * Header of the FeatureStore class.
+ *
+ */
+
+#ifndef FEATURE_STORE_H
+#define FEATURE_STORE_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+
+#include "definitions/define.h"
+
+#include "homography.h"
+#include "frame_cache.h"
+#include "feature_extractor.h"
+
+/**
+ * @brief The FeatureStore class keeps the keypoints and descriptors of every frame of a video in a binary file next to
+ *          the video ( <video_filename>.<feature_method>.features ), so each frame is described only once across runs.
+ *
+ * The file starts with a header holding the feature method, the detector parameters and a hash of the video content, followed by a table
+ * with one entry per frame and the feature blocks. A file written with other parameters or for other video content is
+ * discarded. The blocks that already exist when the file is opened are read from a memory map, and the new ones are
+ * appended to the end of the file. If the file can not be created, the features are computed in every request.
+ * All methods are thread-safe, and runs in other processes may share the file: it is read under a shared flock and
+ * written or created again under an exclusive one.
+ */
+class FeatureStore
+{
+public:
+    /**
+     * @brief FeatureStore::getStore Returns the store of the video, opening it in the first call.
+     * @param video_filename - complete path and filename of the video.
+     * @return \c FeatureStore&
+     */
+    static FeatureStore&    getStore        ( const std::string &video_filename );
+
+    ~FeatureStore ( void );
+
+    /**
+     * @brief FeatureStore::lookup Reads the features of the frame if they are already stored.
+     * @param index - index of the frame in the video.
+     * @param keypoints - object to receive the keypoints of the frame.
+     * @param descriptors - object to receive the descriptors of the frame.
+     * @return \c bool \b true if the features were found.
+     */
+    bool                    lookup          ( const int index , std::vector<cv::KeyPoint> &keypoints , cv::Mat &descriptors );
+
+    /**
+     * @brief FeatureStore::contains Checks if the features of the frame are already stored, without reading them.
+     * @param index - index of the frame in the video.
+     * @return \c bool
+     */
+    bool                    contains        ( const int index );
+
+    /**
+     * @brief FeatureStore::insert Appends the features of the frame to the file.
+     * @param index - index of the frame in the video.
+     * @param keypoints - keypoints of the frame.
+     * @param descriptors - descriptors of the frame.
+     */
+    void                    insert          ( const int index , const std::vector<cv::KeyPoint> &keypoints , const cv::Mat &descriptors );
+
+    /**
+     * @brief FeatureStore::getKeypointsAndDescriptors Returns the features of the frame, describing and storing them if needed.
+     * @param index - index of the frame in the video.
+     * @param frame - image of the frame. If it is empty, no features are returned.
+     * @param keypoints - object to receive the keypoints of the frame.
+     * @param descriptors - object to receive the descriptors of the frame.
+     */
+    void                    getKeypointsAndDescriptors ( const int index , const cv::Mat &frame ,
+                                                         std::vector<cv::KeyPoint> &keypoints , cv::Mat &descriptors );
+
+    /**
+     * @brief FeatureStore::isPersistent Checks if the features are being saved in the disk.
+     * @return \c bool
+     */
+    bool                    isPersistent    ( void ) const;
+
+private:
+    FeatureStore ( const std::string &video_filename );
+    FeatureStore ( const FeatureStore& );
+    FeatureStore& operator= ( const FeatureStore& );
+
+    struct FileHeader {
+        char        magic[8];
+        uint32_t    version;
+        uint32_t    descriptor_cols;
+        int32_t     feature_type;
+        int32_t     descriptor_type;
+        double      detector_threshold;
+        uint64_t    content_hash;
+        int32_t     num_frames;
+        int32_t     reserved;
+    };
+
+    struct IndexEntry {
+        uint64_t    offset;         /** Offset of the feature block in the file, 0 if the frame was not described yet. */
+        uint32_t    num_keypoints;
+        uint32_t    descriptor_cols;
+    };
+
+    struct StoredKeyPoint {
+        float       x, y, size, angle, response;
+        int32_t     octave, class_id;
+    };
+
+    bool                    open            ( void );
+    void                    close           ( void );
+    bool                    hasExpectedHeader ( void ) const;
+    bool                    readEntry       ( const int index , IndexEntry &entry ) const;
+    bool                    readBlock       ( const uint64_t offset , const size_t length , void *buffer ) const;
+    static uint64_t         contentHash     ( const std::string &video_filename );
+
+    std::string                 video_filename;
+    std::string                 store_filename;
+    std::mutex                  mutex;
+    int                         file_descriptor;
+    const char                  *mapped_data;
+    size_t                      mapped_size;
+    int                         num_frames;
+    FileHeader                  expected_header;
+};
+
+#endif // FEATURE_STORE_H
@@ -43,6 +43,8 @@
 
 #include "definitions/experiment_struct.h"
 
+#include "semantic_cost_table.h"
+
 /**
  * @brief Function to load the master frames from a file defined in the field read_masterframes_filename in the experiment_settings.
  *
@@ -93,6 +95,18 @@ void                readSelectedFramesCSV (std::string filename, std::vector<int
  */
 std::string         getExperimentId () ;
 
+/**
+ * @brief Function that loads the semantic costs of all transitions defined in the experiment_settings into memory.
+ *          It must be called before any thread starts calling getSemanticCost.
+ *
+ * @param experiment_settings - variable with the experiment setting.
+ *
+ * @return \c void
+ *
+ * @date 17/10/2026
+ */
+void                loadSemanticCostTable ( const EXPERIMENT &experiment_settings ) ;
+
 /**
  * @brief Function that returns the semantic cost of the transiction from the frame_src to
  *          the frame_dst. The file where the semantic cost will be find is defined in the experiment_settings
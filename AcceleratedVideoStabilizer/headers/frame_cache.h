@@ -0,0 +1,122 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file frame_cache.h
+ *
+ * Header of the FrameCache class.
+ *
+ */
+
+#ifndef FRAME_CACHE_H
+#define FRAME_CACHE_H
+
+#include <stdio.h>
+#include <iostream>
+#include <string>
+#include <atomic>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include "definitions/define.h"
+
+/**
+ * @brief The FrameCache class gives random access to the decoded frames of the videos used in the process.
+ *
+ * There is one instance for the whole process. Frames are kept in a LRU list limited by a byte budget and are
+ * identified by the video filename and the frame index. A miss decodes a few frames ahead with a single sequential
+ * read, so neighbouring requests do not seek again. The frames are handed out as cv::Mat headers sharing the cached
+ * data: they must be treated as read-only (clone them before writing). All methods are thread-safe.
+ */
+class FrameCache
+{
+public:
+    /**
+     * @brief FrameCache::getInstance Returns the cache shared by the whole process.
+     * @return \c FrameCache&
+     */
+    static FrameCache&  getInstance     ( void );
+
+    /**
+     * @brief FrameCache::isOpened Checks if the video can be decoded, opening it if needed.
+     * @param video_filename - complete path and filename of the video.
+     * @return \c bool
+     */
+    bool                isOpened        ( const std::string &video_filename );
+
+    /**
+     * @brief FrameCache::getFrameCount Returns the number of frames of the video.
+     * @param video_filename - complete path and filename of the video.
+     * @return \c int - number of frames, or -1 if the video can not be opened.
+     */
+    int                 getFrameCount   ( const std::string &video_filename );
+
+    /**
+     * @brief FrameCache::getFrame Returns the frame with the given index, decoding it if it is not cached.
+     * @param video_filename - complete path and filename of the video.
+     * @param index - index of the frame in the video.
+     * @param frame - object to receive the read-only header of the frame.
+     * @return \c bool \b false if the frame could not be decoded. In this case frame is empty.
+     */
+    bool                getFrame        ( const std::string &video_filename , const int index , cv::Mat &frame );
+
+    /**
+     * @brief FrameCache::setBudget Sets the maximum number of bytes kept in the cache, evicting frames if needed.
+     * @param budget_bytes - maximum number of bytes.
+     */
+    void                setBudget       ( const size_t budget_bytes );
+
+    /**
+     * @brief FrameCache::clear Drops all cached frames and closes the videos.
+     */
+    void                clear           ( void );
+
+private:
+    FrameCache ( void );
+    FrameCache ( const FrameCache& );
+    FrameCache& operator= ( const FrameCache& );
+
+    typedef std::pair< std::string , int >                  FrameKey;
+    typedef std::list< std::pair< FrameKey , cv::Mat > >    FrameList;
+
+    struct Decoder {
+        std::mutex          mutex;          /** Only one thread reads from the VideoCapture at a time. */
+        cv::VideoCapture    video;
+        std::atomic<int>    num_frames;     /** Shortened, under the mutex, when a read fails before the end. Read without the mutex. */
+        int                 next_index;     /** Index of the frame that the next read will return. */
+    };
+
+    std::shared_ptr<Decoder>    getDecoder      ( const std::string &video_filename );
+    bool                        lookup          ( const FrameKey &key , cv::Mat &frame );
+    void                        insert          ( const FrameKey &key , const cv::Mat &frame );
+    void                        evict           ( void );
+
+    std::mutex                                          mutex;
+    std::map< std::string , std::shared_ptr<Decoder> >  decoders;
+    FrameList                                           frames;         /** Most recently used frames first. */
+    std::map< FrameKey , FrameList::iterator >          frame_index;
+    size_t                                              budget;
+    size_t                                              bytes_in_use;
+};
+
+#endif // FRAME_CACHE_H
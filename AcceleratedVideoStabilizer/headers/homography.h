@@ -109,6 +109,8 @@ bool findHomographyMatrix( const std::vector<cv::KeyPoint> &keypoints_image_src,
  * @param descriptors_image_src - descriptors of the source image.
  * @param descriptors_image_dst - descriptors of the target image.
  * @param homography_matrix - object to save the homography matrix calculated.
+ * @param mean_threshold - selects the good matches with the mean distance as threshold, as the findHomographyMatrix
+ *          with the RANSAC mask. If \b false, uses MATCHES_THRESHOLD_FACTOR times the minimum distance.
  *
  * @return
  *      \c bool \b true  - if there is enough points in both images and good matches between them to find a homography matrix. \n
@@ -119,7 +121,41 @@ bool findHomographyMatrix( const std::vector<cv::KeyPoint> &keypoints_image_src,
  */
 bool findHomographyMatrix(const std::vector<cv::KeyPoint> &keypoints_image_src, const std::vector<cv::KeyPoint> &keypoints_image_dst,
                           const cv::Mat &descriptors_image_src, const cv::Mat &descriptors_image_dst,
-                          cv::Mat &homography_matrix);
+                          cv::Mat &homography_matrix, const bool mean_threshold = false);
+
+/**
+ * @brief Function that counts the RANSAC inliers of the homography from the imageSrc to the imageDst, as the sum of the
+ *          mask of the findHomographyMatrix, without refining the homography or building the mask.
+ *
+ * @param image_src - image to where the homography will be calculated.
+ * @param image_dst - image of the destination of the homography.
+ * @param stop_inliers - the search stops as soon as a consensus has this number of inliers. 0 never stops early.
+ *
+ * @return \c int - the number of inliers, 0 if there is not enough points in both images or good matches between them.
+ *
+ * @date 17/10/2026
+ */
+int     countHomographyInliers      ( const cv::Mat &image_src , const cv::Mat &image_dst , const int stop_inliers = 0 ) ;
+
+/**
+ * @brief Function that counts the RANSAC inliers of the homography given the keypoints and descriptors, as the sum of the
+ *          mask of the findHomographyMatrix, without refining the homography or building the mask.
+ *
+ * @param keypoints_image_src - keypoints of the source image.
+ * @param keypoints_image_dst - keypoints of the target image.
+ * @param descriptors_image_src - descriptors of the source image.
+ * @param descriptors_image_dst - descriptors of the target image.
+ * @param stop_inliers - the search stops as soon as a consensus has this number of inliers. 0 never stops early.
+ * @param mean_threshold - selects the good matches with the mean distance as threshold, as the findHomographyMatrix of
+ *          the keypoints. If \b false, uses the minimum distance threshold of the findHomographyMatrix of the images.
+ *
+ * @return \c int - the number of inliers, 0 if there is not enough points in both images or good matches between them.
+ *
+ * @date 17/10/2026
+ */
+int     countHomographyInliers      ( const std::vector<cv::KeyPoint> &keypoints_image_src , const std::vector<cv::KeyPoint> &keypoints_image_dst ,
+                                      const cv::Mat &descriptors_image_src , const cv::Mat &descriptors_image_dst , const int stop_inliers = 0 ,
+                                      const bool mean_threshold = true ) ;
 
 /**
  * @brief Function that apply homography matrix in a given image.
@@ -137,6 +173,24 @@ bool findHomographyMatrix(const std::vector<cv::KeyPoint> &keypoints_image_src,
  */
 bool    applyHomographyMatrix       ( const cv::Mat &image_src , const cv::Mat &homography_matrix , cv::Mat &image_result ) ;
 
+/**
+ * @brief Function that apply homography matrix in a given image computing only the pixels of the crop area, which is
+ *          the same as cropping the result of the applyHomographyMatrix without building the whole warped image.
+ *
+ * @param image_src - image where the homography matrix will be applied.
+ * @param homography_matrix - homography matrix.
+ * @param crop_area - area of the warped image that is computed. It must be inside the image_src.
+ * @param image_result - object to save the crop area of the image after the application of the homography matrix. Its
+ *          buffer is reused when it already has the size of the crop area and the type of the image_src.
+ *
+ * @return
+ *      \c bool \b true  - if the corner consistency is maintained after application of the homography matrix. \n
+ *      \c bool \b false - if the consistency is not maintained after application of the homography matrix. In this case the imageResult is a copy of the crop area of the imageSrc.
+ *
+ * @date 17/10/2026
+ */
+bool    applyHomographyMatrix       ( const cv::Mat &image_src , const cv::Mat &homography_matrix , const cv::Rect &crop_area , cv::Mat &image_result ) ;
+
 /**
  * @brief Function that checks if after made the homography transformation the corner consistency is maintained.
  *
@@ -176,7 +230,8 @@ bool    checkHomographyConsistency  ( const std::vector<cv::Point2f> new_img_cor
 
 /**
  * @brief Function that calculates the loss(%) of the homography transformation in a ROI. It returns the
- *          ratio between the non-image area and the frame_limits area.
+ *          ratio between the non-image area and the frame_limits area. The area is computed by clipping the
+ *          warped image corners by the ROI, without warping any image.
  *
  * @param image_src - The source image.
  * @param homography_matrix - The homography matrix.
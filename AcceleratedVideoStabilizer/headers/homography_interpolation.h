@@ -0,0 +1,74 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file homography_interpolation.h
+ *
+ * Header of the HomographyPower class.
+ *
+ */
+
+#ifndef HOMOGRAPHY_INTERPOLATION_H
+#define HOMOGRAPHY_INTERPOLATION_H
+
+#include <complex>
+
+#include <armadillo>
+
+#include <opencv2/core/core.hpp>
+
+/**
+ * @brief The HomographyPower class raises a homography matrix to fractional powers, as needed to take the frames to an
+ *          intermediate plane between the masters.
+ *
+ * The matrix is factorized once by a complex Schur decomposition H = U T U*. Each power H^(p/q) is then given in
+ * closed form by the function of the 3x3 triangular T, whose entries are divided differences of x^(p/q) on the
+ * eigenvalues, so no matrix root has to be iterated. The principal branch is used, as in the matrix square root.
+ */
+class HomographyPower
+{
+public:
+    /**
+     * @brief HomographyPower::HomographyPower Factorizes the homography matrix.
+     * @param homography_matrix - 3x3 homography matrix.
+     */
+    explicit HomographyPower ( const cv::Mat &homography_matrix );
+
+    /**
+     * @brief HomographyPower::isValid Checks if the matrix could be factorized. Singular matrices have no valid powers.
+     * @return \c bool
+     */
+    bool                isValid         ( void ) const;
+
+    /**
+     * @brief HomographyPower::pow Computes the homography matrix raised to numerator/denominator.
+     * @param numerator - numerator of the exponent.
+     * @param denominator - denominator of the exponent.
+     * @param matrix_result - object to save the 3x3 result, in double precision.
+     * @return \c bool \b false if the matrix could not be factorized.
+     */
+    bool                pow             ( const int numerator , const int denominator , cv::Mat &matrix_result ) const;
+
+private:
+    bool                    valid;
+    arma::cx_mat            schur_vectors;          /** Unitary U of the Schur decomposition. */
+    std::complex<double>    triangular[3][3];       /** Upper triangular T of the Schur decomposition. */
+    std::complex<double>    log_eigenvalues[3];     /** Principal logarithms of the diagonal of T. */
+};
+
+#endif // HOMOGRAPHY_INTERPOLATION_H
@@ -0,0 +1,120 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file homography_ransac.h
+ *
+ * Header of the HomographyRansac class.
+ *
+ */
+
+#ifndef HOMOGRAPHY_RANSAC_H
+#define HOMOGRAPHY_RANSAC_H
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+
+#include "definitions/define.h"
+
+/**
+ * @brief The HomographyRansac class estimates the homography between the keypoints of two frames given their matches,
+ *          as the cv::findHomography with CV_RANSAC, keeping its point buffers from one call to the next.
+ *
+ * The matches are sorted by their descriptor distance, and the hypotheses are drawn from a growing set of the best
+ * matches (PROSAC), so a good consensus is usually found in the first iterations. Each hypothesis is scored by the
+ * reprojection error of all the points, computed with AVX or SSE2 when the processor supports them, and the scoring of
+ * a hypothesis stops as soon as it can not beat the best one. The number of iterations is updated by the inlier ratio
+ * of the best consensus, up to RANSAC_MAX_ITERATIONS. The homography is then refined with all the inliers.
+ *
+ * Each thread has its own estimator.
+ */
+class HomographyRansac
+{
+public:
+    /**
+     * @brief HomographyRansac::getEstimator Returns the estimator of the calling thread.
+     * @return \c HomographyRansac&
+     */
+    static HomographyRansac&        getEstimator        ( void );
+
+    /**
+     * @brief HomographyRansac::getMatchBuffer Returns a vector to receive the matches given to the estimator, kept
+     *          with the other buffers of the thread.
+     * @return \c std::vector<cv::DMatch>&
+     */
+    std::vector<cv::DMatch>&        getMatchBuffer      ( void );
+
+    /**
+     * @brief HomographyRansac::findHomography Finds the homography from the source keypoints to the destination ones.
+     * @param keypoints_src - keypoints of the source frame, the query of the matches.
+     * @param keypoints_dst - keypoints of the destination frame, the train of the matches.
+     * @param matches - matches between the keypoints.
+     * @param homography_matrix - object to save the homography matrix, empty if no consensus was found.
+     * @param ransac_mask - object to save the RANSAC mask, in the order of the matches. 1 means inliers and 0 means outliers.
+     * @return \c int - the number of inliers of the homography.
+     */
+    int                             findHomography      ( const std::vector<cv::KeyPoint> &keypoints_src , const std::vector<cv::KeyPoint> &keypoints_dst ,
+                                                          const std::vector<cv::DMatch> &matches , cv::Mat &homography_matrix , cv::Mat &ransac_mask );
+
+    /**
+     * @brief HomographyRansac::findHomography Finds the homography as above, keeping the RANSAC mask in the estimator.
+     * @param keypoints_src - keypoints of the source frame, the query of the matches.
+     * @param keypoints_dst - keypoints of the destination frame, the train of the matches.
+     * @param matches - matches between the keypoints.
+     * @param homography_matrix - object to save the homography matrix, empty if no consensus was found.
+     * @return \c int - the number of inliers of the homography.
+     */
+    int                             findHomography      ( const std::vector<cv::KeyPoint> &keypoints_src , const std::vector<cv::KeyPoint> &keypoints_dst ,
+                                                          const std::vector<cv::DMatch> &matches , cv::Mat &homography_matrix );
+
+    /**
+     * @brief HomographyRansac::countInliers Finds the best consensus as the findHomography, without refining the
+     *          homography or building the mask, when only the number of inliers is used.
+     * @param keypoints_src - keypoints of the source frame, the query of the matches.
+     * @param keypoints_dst - keypoints of the destination frame, the train of the matches.
+     * @param matches - matches between the keypoints.
+     * @param stop_inliers - the search stops as soon as a consensus has this number of inliers. 0 never stops early.
+     * @return \c int - the number of inliers of the best consensus.
+     */
+    int                             countInliers        ( const std::vector<cv::KeyPoint> &keypoints_src , const std::vector<cv::KeyPoint> &keypoints_dst ,
+                                                          const std::vector<cv::DMatch> &matches , const int stop_inliers = 0 );
+
+private:
+    HomographyRansac ( void ) {}
+    HomographyRansac ( const HomographyRansac& );
+    HomographyRansac& operator= ( const HomographyRansac& );
+
+    void                            setPoints           ( const std::vector<cv::KeyPoint> &keypoints_src , const std::vector<cv::KeyPoint> &keypoints_dst ,
+                                                          const std::vector<cv::DMatch> &matches );
+    int                             findConsensus       ( const int stop_inliers );
+
+    std::vector<cv::DMatch>         match_buffer;       /** Matches given by the callers of the getMatchBuffer. */
+    std::vector<int>                order;              /** Indices of the matches, by increasing distance. */
+    std::vector<float>              src_x;              /** Coordinates of the points, in the order of the distances. */
+    std::vector<float>              src_y;
+    std::vector<float>              dst_x;
+    std::vector<float>              dst_y;
+    std::vector<cv::Point2f>        inliers_src;        /** Inliers of the best consensus, refined by the cv::findHomography. */
+    std::vector<cv::Point2f>        inliers_dst;
+    cv::Mat                         mask_buffer;        /** RANSAC mask of the calls that do not need it. */
+    double                          best_model[9];      /** Homography of the best consensus, by rows. */
+};
+
+#endif // HOMOGRAPHY_RANSAC_H
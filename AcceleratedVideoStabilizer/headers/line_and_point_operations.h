@@ -91,4 +91,17 @@ bool lineSegmentIntersection    ( const cv::Point2f &a1 , const cv::Point2f &b1
  */
 void computeAnglesAndMags       ( const std::vector<cv::Point2f>& points_src , const std::vector<cv::Point2f>& points_dst , std::vector<float>& angles , std::vector<float>& mags );
 
+/**
+ * @brief Function that computes the area of the part of a polygon that lies inside a rectangle. The polygon is clipped by
+ *          the four sides of the rectangle (Sutherland-Hodgman) and the area of the result is given by the shoelace formula.
+ *
+ * @param polygon - vertices of the polygon, in clockwise or counterclockwise order.
+ * @param rect - rectangle used to clip the polygon.
+ *
+ * @return \c double - area of the polygon inside the rectangle.
+ *
+ * @date 17/10/2026
+ */
+double polygonAreaInsideRect    ( const std::vector<cv::Point2d>& polygon , const cv::Rect& rect );
+
 #endif // LINE_SEGMENT_INTERSECTION_H
@@ -29,6 +29,8 @@
 #include <stdio.h>
 #include <iostream>
 #include <fstream>
+#include <memory>
+#include <thread>
 
 #include <omp.h>
 #include <armadillo>
@@ -44,6 +46,40 @@
 
 #include "homography.h"
 #include "file_operations.h"
+#include "feature_store.h"
+#include "blocking_queue.h"
+
+/**
+ * @brief The MasterSchedule enum
+ */
+enum MasterSchedule {
+                    DYNAMIC_SCHEDULE,/** Each worker of the master frames search takes one segment at a time **/
+                    GUIDED_SCHEDULE/** The workers take groups of segments that shrink as the video ends **/
+                    };
+
+/**
+ * @brief Function that converts the name used in the experiment settings to the schedule of the master frames search.
+ *
+ * @param name - "dynamic" or "guided". An empty name selects the dynamic schedule.
+ * @param schedule - object to save the schedule.
+ *
+ * @return \c bool \b false if the name is unknown.
+ *
+ * @date 17/10/2026
+ */
+bool                parseMasterSchedule ( const std::string &name , MasterSchedule &schedule );
+
+/**
+ * @brief Function that returns the number of worker threads of the parallel steps: the numThreads setting, or the
+ *          number of cores if it is not set, or one thread if the experiment does not run in parallel.
+ *
+ * @param experiment_settings - object with the experiment settings.
+ *
+ * @return \c int
+ *
+ * @date 17/10/2026
+ */
+int                 getNumberOfThreads  ( const EXPERIMENT &experiment_settings );
 
 /**
  * @brief Function that return the master frames in a sequence according with experiment settings, by load from a file or calculating them.
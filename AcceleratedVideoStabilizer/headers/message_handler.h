@@ -21,6 +21,8 @@
 #include <stdio.h>
 #include <iostream>
 #include <fstream>
+#include <string>
+#include <vector>
 #include "headers/error_messages.h"
 
 enum Stream{LOG_FILE, SCREEN, BOTH};
@@ -63,4 +65,28 @@ private:
     void printError(ErrorMessage error_message);
 };
 
+/**
+ * @brief The MessageBuffer class keeps the status messages of a frame processed out of order, so they can be
+ *          reported later, in the order of the frames.
+ */
+class MessageBuffer
+{
+public:
+    /**
+     * @brief MessageBuffer::reportStatus Keeps the given status to be reported to the log file, screen, or both.
+     * @param status
+     * @param stream
+     */
+    void reportStatus(std::string status, Stream stream);
+
+    /**
+     * @brief MessageBuffer::flush Reports the kept status messages in the order they were given and clears the buffer.
+     * @param msg_handler
+     */
+    void flush(MessageHandler &msg_handler);
+
+private:
+    std::vector< std::pair<std::string, Stream> > messages;
+};
+
 #endif // MESSAGEHANDLER_H
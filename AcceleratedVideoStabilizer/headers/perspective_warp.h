@@ -0,0 +1,92 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @file perspective_warp.h
+ *
+ * Header of the bilinear perspective warp of 8-bit images.
+ *
+ */
+
+#ifndef PERSPECTIVE_WARP_H
+#define PERSPECTIVE_WARP_H
+
+#include <string>
+
+#include <opencv2/core/core.hpp>
+
+#include "definitions/define.h"
+
+/**
+ * @brief Function that warps an image as the cv::warpPerspective with bilinear interpolation and black border, with a
+ *          kernel specialised for the CV_8UC3 frames and CV_8UC1 masks. Other types are given to the cv::warpPerspective.
+ *
+ * The output is computed in tiles of PERSPECTIVE_WARP_TILE_ROWS x PERSPECTIVE_WARP_TILE_COLS pixels, so the source
+ * pixels read by a tile stay in the cache. The source coordinates of the pixels are computed with AVX2 or SSE4.1,
+ * chosen when the program starts by the processor, or by the scalar code in other processors. The pixels are
+ * interpolated with the same fixed point weights of the OpenCV.
+ *
+ * @param image_src - image to warp.
+ * @param homography_matrix - homography matrix from the image_src to the image_result.
+ * @param result_size - size of the image_result.
+ * @param image_result - object to save the warped image. It can not be the image_src.
+ *
+ * @date 17/10/2026
+ */
+void warpPerspectiveBilinear( const cv::Mat &image_src, const cv::Mat &homography_matrix, const cv::Size &result_size, cv::Mat &image_result );
+
+/**
+ * @brief Function that warps an image as the warpPerspectiveBilinear and computes, in the same pass, the warp of a white
+ *          mask of the image_src, which is the area of the image_result covered by the image_src.
+ *
+ * @param image_src - image to warp.
+ * @param homography_matrix - homography matrix from the image_src to the image_result.
+ * @param result_size - size of the image_result.
+ * @param image_result - object to save the warped image. It can not be the image_src.
+ * @param mask_result - object to save the warped mask, with type CV_8UC1.
+ *
+ * @date 17/10/2026
+ */
+void warpPerspectiveBilinear( const cv::Mat &image_src, const cv::Mat &homography_matrix, const cv::Size &result_size,
+                              cv::Mat &image_result, cv::Mat &mask_result );
+
+/**
+ * @brief Function that computes the warp of a white mask of an image, without reading the image.
+ *
+ * @param image_size - size of the image.
+ * @param homography_matrix - homography matrix from the image to the mask_result.
+ * @param result_size - size of the mask_result.
+ * @param mask_result - object to save the warped mask, with type CV_8UC1.
+ *
+ * @date 17/10/2026
+ */
+void warpPerspectiveMask( const cv::Size &image_size, const cv::Mat &homography_matrix, const cv::Size &result_size, cv::Mat &mask_result );
+
+/**
+ * @brief Function that measures the time of the cv::warpPerspective and of each path of the warpPerspectiveBilinear
+ *          (scalar, SSE4.1 and AVX2, when supported) warping a frame and its mask with some homographies, and the largest
+ *          difference between their results.
+ *
+ * @param image - frame used in the measure, with type CV_8UC3.
+ *
+ * @return \c std::string - the report of the measure, one line per path.
+ *
+ * @date 17/10/2026
+ */
+std::string benchmarkPerspectiveWarp( const cv::Mat &image );
+
+#endif // PERSPECTIVE_WARP_H
@@ -0,0 +1,125 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file reconstruction_window.h
+ *
+ * Header of the ReconstructionWindow class.
+ *
+ */
+
+#ifndef RECONSTRUCTION_WINDOW_H
+#define RECONSTRUCTION_WINDOW_H
+
+#include <string>
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+#include <opencv2/features2d/features2d.hpp>
+
+#include "definitions/define.h"
+
+/**
+ * @brief The ReconstructionWindow class keeps the frames of the original video around the frame being reconstructed,
+ *          and their features, in a ring buffer of 2*NUM_MAX_IMAGES_TO_RECONSTRUCT+1 slots.
+ *
+ * The window slides with the reconstructed frame. The frames that leave the window are released, and the frames are
+ * decoded only when the reconstruction needs them, with a sequential read from the last decoded frame when it is close
+ * enough. Consecutive reconstructions share most of their neighbours, so each one decodes only the newly exposed frames.
+ * Each thread has its own window, since the frames reconstructed by different threads are far apart. The frames of all
+ * the windows share the byte budget RECONSTRUCTION_WINDOW_BUDGET_MB: a window over it releases its frames farthest from
+ * the center, so the process keeps at most the budget plus the frame in use by each thread.
+ */
+class ReconstructionWindow
+{
+public:
+    /**
+     * @brief ReconstructionWindow::getWindow Returns the window of the video used by the calling thread, opening it in the first call.
+     * @param video_filename - complete path and filename of the video.
+     * @return \c ReconstructionWindow&
+     */
+    static ReconstructionWindow&    getWindow       ( const std::string &video_filename );
+
+    ~ReconstructionWindow ( void );
+
+    /**
+     * @brief ReconstructionWindow::isOpened Checks if the video can be decoded.
+     * @return \c bool
+     */
+    bool                            isOpened        ( void ) const;
+
+    /**
+     * @brief ReconstructionWindow::getFrameCount Returns the number of frames of the video.
+     * @return \c int - number of frames, or -1 if the video can not be opened.
+     */
+    int                             getFrameCount   ( void ) const;
+
+    /**
+     * @brief ReconstructionWindow::moveTo Centers the window in the frame, releasing the frames that are left out.
+     * @param center - index of the frame being reconstructed.
+     */
+    void                            moveTo          ( const int center );
+
+    /**
+     * @brief ReconstructionWindow::getFrame Returns a frame of the window, decoding it if needed.
+     * @param index - index of the frame in the video. It must be inside the window.
+     * @param frame - object to receive the read-only header of the frame.
+     * @return \c bool \b false if the frame is out of the window or could not be decoded. In this case frame is empty.
+     */
+    bool                            getFrame        ( const int index , cv::Mat &frame );
+
+    /**
+     * @brief ReconstructionWindow::getFeatures Returns the features of a frame of the window, computing them with the
+     *          FeatureStore of the video in the first request.
+     * @param index - index of the frame in the video. It must be inside the window.
+     * @param keypoints - object to receive the keypoints of the frame.
+     * @param descriptors - object to receive the read-only header of the descriptors of the frame.
+     * @return \c bool \b false if the frame is out of the window or could not be decoded.
+     */
+    bool                            getFeatures     ( const int index , std::vector<cv::KeyPoint> &keypoints , cv::Mat &descriptors );
+
+private:
+    explicit ReconstructionWindow ( const std::string &video_filename );
+    ReconstructionWindow ( const ReconstructionWindow& );
+    ReconstructionWindow& operator= ( const ReconstructionWindow& );
+
+    struct Slot {
+        int                         index;          /** Index of the frame in the slot, -1 if the slot is empty. */
+        cv::Mat                     frame;
+        bool                        described;      /** The features of the frame were already computed. */
+        std::vector<cv::KeyPoint>   keypoints;
+        cv::Mat                     descriptors;
+    };
+
+    bool                            contains        ( const int index ) const;
+    Slot&                           getSlot         ( const int index );
+    void                            storeFrame      ( Slot &slot , const int index , const cv::Mat &frame );
+    void                            releaseSlot     ( Slot &slot );
+    void                            enforceBudget   ( const int keep_index );
+    void                            decode          ( const int index );
+
+    std::string                     video_filename;
+    cv::VideoCapture                video;
+    int                             num_frames;
+    int                             next_index;     /** Index of the frame that the next read will return, -1 if unknown. */
+    int                             center;
+    std::vector<Slot>               slots;
+};
+
+#endif // RECONSTRUCTION_WINDOW_H
@@ -0,0 +1,97 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file scratch_arena.h
+ *
+ * Header of the ScratchArena class.
+ *
+ */
+
+#ifndef SCRATCH_ARENA_H
+#define SCRATCH_ARENA_H
+
+#include <vector>
+
+#include <opencv2/core/core.hpp>
+
+#include "definitions/define.h"
+
+/**
+ * @brief The ScratchArena class keeps the frame-sized temporary matrices (masks, grayscale copies, intersections) of
+ *          the coverage, warp and reconstruction functions, so they are reused from one frame to the next instead of
+ *          being allocated and freed in each call.
+ *
+ * Each thread has its own arena, with up to SCRATCH_ARENA_MAX_BUFFERS free buffers. A buffer is borrowed with a
+ * ScratchArena::Buffer, which gives it back when it goes out of scope. A borrowed buffer must only be written by
+ * functions that keep its size and type, otherwise OpenCV allocates a new one. The arena counts every buffer
+ * allocated, by itself or by OpenCV in a borrowed buffer, so the steady state of the process can be checked.
+ */
+class ScratchArena
+{
+public:
+    /**
+     * @brief The ScratchArena::Buffer class borrows a buffer of the arena of the calling thread while it is in scope.
+     */
+    class Buffer
+    {
+    public:
+        Buffer ( const int rows , const int cols , const int type );
+        Buffer ( const cv::Size size , const int type );
+        ~Buffer ( void );
+
+        cv::Mat     mat;            /** Buffer borrowed, with the requested size and type and undefined values. */
+
+    private:
+        Buffer ( const Buffer& );
+        Buffer& operator= ( const Buffer& );
+
+        uchar       *data;          /** Data handed out, to detect the buffers reallocated while borrowed. */
+    };
+
+    /**
+     * @brief ScratchArena::getArena Returns the arena of the calling thread.
+     * @return \c ScratchArena&
+     */
+    static ScratchArena&    getArena            ( void );
+
+    /**
+     * @brief ScratchArena::getNumRequests Returns the number of buffers borrowed by all the threads.
+     * @return \c unsigned long
+     */
+    static unsigned long    getNumRequests      ( void );
+
+    /**
+     * @brief ScratchArena::getNumAllocations Returns the number of buffers allocated for all the threads, because no
+     *          free buffer had the requested size and type or because a borrowed buffer was reallocated.
+     * @return \c unsigned long
+     */
+    static unsigned long    getNumAllocations   ( void );
+
+private:
+    ScratchArena ( void );
+    ScratchArena ( const ScratchArena& );
+    ScratchArena& operator= ( const ScratchArena& );
+
+    void                    acquire             ( const int rows , const int cols , const int type , cv::Mat &buffer );
+    void                    release             ( cv::Mat &buffer , const bool reallocated );
+
+    std::vector<cv::Mat>    free_buffers;       /** Least recently returned buffers first. */
+};
+
+#endif // SCRATCH_ARENA_H
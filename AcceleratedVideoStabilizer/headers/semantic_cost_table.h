@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file semantic_cost_table.h
+ *
+ * Header of the SemanticCostTable class.
+ *
+ */
+
+#ifndef SEMANTIC_COST_TABLE_H
+#define SEMANTIC_COST_TABLE_H
+
+#include <stdio.h>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @brief The SemanticCostTable class keeps the semantic costs of the frame transitions in memory.
+ *
+ * The CSV file is read once into a dense (line x transition) array whose width is the largest number of transitions
+ * described in a line, so every lookup is O(1). After load() the table is never modified, so the lookups can be done
+ * concurrently by several threads without any lock.
+ */
+class SemanticCostTable
+{
+public:
+    SemanticCostTable ( void );
+
+    /**
+     * @brief SemanticCostTable::load Reads the whole CSV file with the semantic costs of the frame transitions.
+     * @param filename - complete path and filename of the csv file with the semantic costs.
+     * @return \c bool \b true if the file was read, \b false if it could not be opened.
+     */
+    bool                load            ( const std::string &filename );
+
+    /**
+     * @brief SemanticCostTable::isLoaded Checks if the table was already filled by a call to load().
+     * @return \c bool
+     */
+    bool                isLoaded        ( void ) const;
+
+    /**
+     * @brief SemanticCostTable::getFilename Returns the name of the file loaded into the table.
+     * @return \c std::string
+     */
+    const std::string&  getFilename     ( void ) const;
+
+    /**
+     * @brief SemanticCostTable::getCost Returns the semantic cost of the transition from the frame_src to the frame_dst.
+     * @param frame_src - first frame of the transition.
+     * @param frame_dst - last frame of the transition.
+     * @param cost - object to save the complementary value ( 1 - x ) of the semantic cost.
+     * @return \c bool \b false if the transition is not described in the file.
+     */
+    bool                getCost         ( const int frame_src , const int frame_dst , double &cost ) const;
+
+private:
+    std::string         filename;
+    double              shift;          /** First value of the file, the number of the first frame described in it. */
+    int                 num_lines;
+    int                 band_width;     /** Largest number of transitions described in a single line. */
+    std::vector<double> costs;          /** Costs stored line by line, each one with band_width positions, with the precision of the atof. */
+    std::vector<int>    line_lengths;   /** Number of transitions described in each line. */
+};
+
+#endif // SEMANTIC_COST_TABLE_H
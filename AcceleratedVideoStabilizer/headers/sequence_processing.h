@@ -95,6 +95,36 @@ bool findIntermediateHomographyMatrix (const int d, const int D, const int N , c
                                         const cv::Mat &descriptors_master_pos,
                                         cv::Mat& homography_matrix_result );
 
+/**
+ * @brief Function that calculates the homography matrix that leave the frame_i to the intermediate plan between
+ *          the frames related to the previous and posterior master, with respect to the distance between them.
+ *
+ * @param d - distance between the current frame and the previous master frame.
+ * @param D - distance between previous master frame and the posterior master frame.
+ * @param N - size of the segments.
+ * @param keypoints_frame_i - keypoints of the current frame.
+ * @param descriptors_frame_i - descriptors of the current frame.
+ * @param keypoints_master_pre - keypoints of the previous master.
+ * @param keypoints_master_pos - keypoints of the posterior master.
+ * @param descriptors_master_pre - descriptors of the previous master.
+ * @param descriptors_master_pos - descriptors of the posterior master.
+ * @param homography_matrix_result - object to save the result homography matrix.
+ *
+ * @return
+ *      \c bool \b true - if there is enough points in both images and good matches between them to find a homography matrix. \n
+ *      \c bool \c false - if there is not enough points in both images or good matches between them to find a homography matrix.
+ *
+ * @date 17/10/2026
+ */
+bool findIntermediateHomographyMatrix (const int d, const int D, const int N ,
+                                        const std::vector<cv::KeyPoint> &keypoints_frame_i,
+                                        const cv::Mat &descriptors_frame_i,
+                                        const std::vector<cv::KeyPoint> &keypoints_master_pre,
+                                        const std::vector<cv::KeyPoint> &keypoints_master_pos,
+                                        const cv::Mat &descriptors_master_pre,
+                                        const cv::Mat &descriptors_master_pos,
+                                        cv::Mat& homography_matrix_result );
+
 /**
  * @brief Function that calculates the homography matrix that leave the frame_i to the intermediate plan between
  *          the frames related to the previous and posterior master, with respect to the distance between them.
@@ -122,6 +152,35 @@ bool findIntermediateHomographyMatrix (const float s, const float S, const cv::M
                                         const cv::Mat &descriptors_master_pos,
                                         cv::Mat& homography_matrix_result);
 
+/**
+ * @brief Function that calculates the homography matrix that leave the frame_i to the intermediate plan between
+ *          the frames related to the previous and posterior master, with respect to the distance between them.
+ *
+ * @param s - frame shift value between the previous master frame and the current frame.
+ * @param S - frame shift between previous master frame and the posterior master frame.
+ * @param keypoints_frame_i - keypoints of the current frame.
+ * @param descriptors_frame_i - descriptors of the current frame.
+ * @param keypoints_master_pre - keypoints of the previous master.
+ * @param keypoints_master_pos - keypoints of the posterior master.
+ * @param descriptors_master_pre - descriptors of the previous master.
+ * @param descriptors_master_pos - descriptors of the posterior master.
+ * @param homography_matrix_result - object to save the result homography matrix.
+ *
+ * @return
+ *      \c bool \b true - if there is enough points in both images and good matches between them to find a homography matrix. \n
+ *      \c bool \c false - if there is not enough points in both images or good matches between them to find a homography matrix.
+ *
+ * @date 17/10/2026
+ */
+bool findIntermediateHomographyMatrix (const float s, const float S,
+                                        const std::vector<cv::KeyPoint> &keypoints_frame_i,
+                                        const cv::Mat &descriptors_frame_i,
+                                        const std::vector<cv::KeyPoint> &keypoints_master_pre,
+                                        const std::vector<cv::KeyPoint> &keypoints_master_pos,
+                                        const cv::Mat &descriptors_master_pre,
+                                        const cv::Mat &descriptors_master_pos,
+                                        cv::Mat& homography_matrix_result);
+
 /**
  * @brief Function that selects a new frame in the original video using the values of semantic information of the transition from the frame_src to the frame_dst calculted by
  *          MATLAB and saved in a CSV file, the area ratio of the iamge after apply the homography transformation and the RANSCAC inliers from the previous and posterior frames
@@ -133,11 +192,13 @@ bool findIntermediateHomographyMatrix (const float s, const float S, const cv::M
  * @param index - index of the frame that will be replaced.
  * @param index_previous - index of the last frame in the reduced video.
  * @param index_posterior - index of the next frame in the reduced video.
+ * @param master_pre - index of the previous master frame in the accelerated video.
+ * @param master_pos - index of the posterior master frame in the accelerated video.
  * @param image_master_previous - image with the master previous
  * @param image_master_posterior - image with the master posterior
  * @param crop_area - crop area of the video.
  * @param experiment_settings - experiment settings struct.
- * @param new_frame - image that will receive the new selected frame.
+ * @param new_frame - object to receive the read-only header of the new selected frame, shared with the FrameCache.
  *
  * @return \c int - returns the index of the new selected frame.
  *
@@ -145,6 +206,7 @@ bool findIntermediateHomographyMatrix (const float s, const float S, const cv::M
  * @date 30/04/2016
  */
 int                 selectNewFrame                        (const int d , const int D , const int N , const int index , const int index_previous , const int index_posterior ,
+                                                              const int master_pre , const int master_pos ,
                                                               const std::vector<cv::KeyPoint> &keypoints_master_pre , const std::vector<cv::KeyPoint> &keypoints_master_pos , const cv::Mat &descriptors_master_pre, const cv::Mat &descriptors_master_pos, const cv::Rect &crop_area ,
                                                               const EXPERIMENT &experiment_settings , cv::Mat& new_frame );
 
@@ -158,18 +220,20 @@ int                 selectNewFrame                        (const int d , const i
  * @param index - index of the frame that will be replaced.
  * @param index_previous - index of the last frame in the reduced video.
  * @param index_posterior - index of the next frame in the reduced video.
+ * @param master_pre - index of the previous master frame in the accelerated video.
+ * @param master_pos - index of the posterior master frame in the accelerated video.
  * @param image_master_previous - image with the master previous
  * @param image_master_posterior - image with the master posterior
  * @param crop_area - crop area of the video.
  * @param experiment_settings - experiment settings struct.
- * @param new_frame - image that will receive the new selected frame.
+ * @param new_frame - object to receive the read-only header of the new selected frame, shared with the FrameCache.
  *
  * @return \c int - returns the index of the new selected frame.
  *
  * @author Washington Luis de Souza Ramos
  * @date 08/09/2016
  */
-int selectNewFrame (const float s, const float S, const int index , const int index_previous , const int index_posterior ,
+int selectNewFrame (const float s, const float S, const int index , const int index_previous , const int index_posterior , const int master_pre , const int master_pos ,
                        const std::vector<cv::KeyPoint> &keypoints_master_pre , const std::vector<cv::KeyPoint> &keypoints_master_pos , const cv::Mat &descriptors_master_pre, const cv::Mat &descriptors_master_pos, const cv::Rect& crop_area ,
                        const EXPERIMENT& experiment_settings , cv::Mat& new_frame );
 
@@ -0,0 +1,126 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file video_sink.h
+ *
+ * Header of the VideoSink class.
+ *
+ */
+
+#ifndef VIDEO_SINK_H
+#define VIDEO_SINK_H
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <atomic>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/highgui/highgui.hpp>
+
+#include "definitions/define.h"
+
+#include "headers/blocking_queue.h"
+
+/**
+ * @brief The VideoSink class saves the frames of a video in a dedicated encoder thread, so the encoding does not add to
+ *          the time of each frame in the main loop.
+ *
+ * The frames are copied to buffers recycled from the frames already encoded and wait in a queue of VIDEO_SINK_QUEUE_SIZE
+ * frames. The copy lets the caller write again in its frame right away. When the queue is full the caller waits for the
+ * encoder, so the memory is bounded when the encoding is slower than the stabilization. The release flushes the queue.
+ * The methods must be called by a single producer thread.
+ */
+class VideoSink
+{
+public:
+    VideoSink ( void );
+    ~VideoSink ( void );
+
+    /**
+     * @brief VideoSink::open Creates the video file and starts the encoder thread.
+     * @param filename - complete path and filename of the video.
+     * @param fourcc - code of the codec, as given by CV_FOURCC.
+     * @param fps - frame rate of the video.
+     * @param frame_size - size of the frames.
+     * @return \c bool \b false if the file can not be created.
+     */
+    bool            open                ( const std::string &filename , const int fourcc , const double fps , const cv::Size frame_size );
+
+    /**
+     * @brief VideoSink::isOpened Checks if the video file was created.
+     * @return \c bool
+     */
+    bool            isOpened            ( void ) const;
+
+    /**
+     * @brief VideoSink::write Hands a frame to the encoder thread, waiting only while the queue is full.
+     * @param frame - frame to be saved, with the size given in the open. It is copied, so it can be changed after the call.
+     */
+    void            write               ( const cv::Mat &frame );
+
+    /**
+     * @brief VideoSink::release Waits until the frames in the queue are encoded and closes the video file.
+     */
+    void            release             ( void );
+
+    /**
+     * @brief VideoSink::getQueueDepth Returns the number of frames waiting to be encoded.
+     * @return \c size_t
+     */
+    size_t          getQueueDepth       ( void ) const;
+
+    /**
+     * @brief VideoSink::getMaxQueueDepth Returns the largest number of frames that waited to be encoded at the same time.
+     * @return \c size_t
+     */
+    size_t          getMaxQueueDepth    ( void ) const;
+
+    /**
+     * @brief VideoSink::getNumStalls Returns the number of frames that waited for the encoder because the queue was full.
+     * @return \c unsigned long
+     */
+    unsigned long   getNumStalls        ( void ) const;
+
+    /**
+     * @brief VideoSink::parseCodec Converts the name of a codec of the settings file to its code.
+     * @param name - four characters of the codec, as "mp4v" or "XVID". Empty for "mp4v".
+     * @param fourcc - object to receive the code of the codec.
+     * @return \c bool \b false if the name does not have four characters.
+     */
+    static bool     parseCodec          ( const std::string &name , int &fourcc );
+
+private:
+    VideoSink ( const VideoSink& );
+    VideoSink& operator= ( const VideoSink& );
+
+    void            encode              ( void );
+
+    cv::VideoWriter                             writer;
+    std::unique_ptr< BlockingQueue<cv::Mat> >   frames;
+    std::thread                                 encoder;
+    std::mutex                                  buffers_mutex;
+    std::vector<cv::Mat>                        free_buffers;       /** Buffers of the frames already encoded. */
+    std::atomic<size_t>                         max_queue_depth;
+    std::atomic<unsigned long>                  num_stalls;
+};
+
+#endif // VIDEO_SINK_H
@@ -0,0 +1,78 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @file candidate_score_cache.cpp
+ *
+ * Memoisation of the scores of the candidate frames of the frame selection.
+ *
+ */
+
+#include <tuple>
+
+#include "headers/candidate_score_cache.h"
+
+bool CandidateScoreCache::Key::operator< ( const Key &other ) const
+{
+    return std::tie(candidate, previous, posterior, master_pre, master_pos, segment_size, position, distance, spatial)
+            < std::tie(other.candidate, other.previous, other.posterior, other.master_pre, other.master_pos, other.segment_size,
+                       other.position, other.distance, other.spatial);
+}
+
+CandidateScoreCache::CandidateScoreCache ( void ) :
+    num_lookups(0),
+    num_hits(0)
+{
+}
+
+CandidateScoreCache& CandidateScoreCache::getInstance ( void )
+{
+    static CandidateScoreCache instance;
+    return instance;
+}
+
+bool CandidateScoreCache::lookup ( const Key &key , Score &score )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    num_lookups++;
+
+    std::map< Key , Score >::const_iterator it = scores.find(key);
+    if ( it == scores.end() )
+        return false;
+
+    score = it->second;
+    num_hits++;
+    return true;
+}
+
+void CandidateScoreCache::insert ( const Key &key , const Score &score )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    scores[key] = score;
+}
+
+unsigned long CandidateScoreCache::getNumLookups ( void )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return num_lookups;
+}
+
+unsigned long CandidateScoreCache::getNumHits ( void )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return num_hits;
+}
@@ -0,0 +1,86 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file feature_extractor.cpp
+ *
+ * Detection and description of the keypoints of the frames, with SURF or ORB.
+ *
+ */
+
+#include "definitions/define.h"
+
+#include "headers/feature_extractor.h"
+
+/** Feature method of the whole process. */
+static FeatureType feature_type = SURF_FEATURES;
+
+void FeatureExtractor::setType ( const FeatureType type ) {
+    feature_type = type;
+}
+
+FeatureType FeatureExtractor::getType ( void ) {
+    return feature_type;
+}
+
+bool FeatureExtractor::parseType ( const std::string &name , FeatureType &type ) {
+    if ( name.empty() || name == "SURF" )
+        type = SURF_FEATURES;
+    else if ( name == "ORB" )
+        type = ORB_FEATURES;
+    else
+        return false;
+
+    return true;
+}
+
+std::string FeatureExtractor::getName ( void ) {
+    return feature_type == ORB_FEATURES ? "orb" : "surf";
+}
+
+int FeatureExtractor::getDescriptorSize ( void ) {
+    if ( feature_type == ORB_FEATURES )
+        return cv::ORB().descriptorSize();
+    return cv::SurfDescriptorExtractor().descriptorSize();
+}
+
+int FeatureExtractor::getDescriptorType ( void ) {
+    return feature_type == ORB_FEATURES ? CV_8U : CV_32F;
+}
+
+double FeatureExtractor::getDetectorThreshold ( void ) {
+    return feature_type == ORB_FEATURES ? ORB_NUM_FEATURES : MIN_HESSIAN;
+}
+
+void FeatureExtractor::detectAndCompute ( const cv::Mat &image , std::vector<cv::KeyPoint> &keypoints , cv::Mat &descriptors ) {
+
+    if ( feature_type == ORB_FEATURES ) {
+        //-- Detect the keypoints using the FAST detector and describe them with the rotated BRIEF.
+        cv::ORB orb( ORB_NUM_FEATURES );
+        orb( image, cv::Mat(), keypoints, descriptors );
+        return;
+    }
+
+    //-- Step 1: Detect the keypoints using SURF Detector.
+    cv::SurfFeatureDetector detector( MIN_HESSIAN );
+    detector.detect( image, keypoints );
+
+    //-- Step 2: Calculate descriptors (feature vectors).
+    cv::SurfDescriptorExtractor extractor;
+    extractor.compute( image, keypoints, descriptors );
+}
@@ -0,0 +1,397 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file feature_matcher.cpp
+ *
+ * Matching of descriptors between frames, by brute force or by an approximate nearest neighbour index.
+ *
+ */
+
+#include <list>
+#include <mutex>
+#include <cmath>
+#include <cstring>
+#include <stdint.h>
+#include <limits>
+#include <sstream>
+#include <iomanip>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "definitions/define.h"
+
+#include "headers/feature_matcher.h"
+#include "headers/homography.h"
+#include "headers/homography_ransac.h"
+
+/** Number of times each matcher is built and queried by the benchmarkFeatureMatcher. */
+#define MATCHER_BENCHMARK_REPETITIONS   5
+
+/**
+ * @brief Function that computes the Hamming distance between two binary descriptors. The bits are counted 256 at a time
+ *          with AVX2 (nibble lookup table and sum of absolute differences) when the build enables it, and 64 at a time
+ *          with the popcount instruction otherwise.
+ *
+ * @param a - first descriptor.
+ * @param b - second descriptor.
+ * @param length - size of the descriptors in bytes.
+ *
+ * @return \c int - number of different bits.
+ *
+ * @date 17/10/2026
+ */
+static inline int hammingDistance ( const uchar *a , const uchar *b , const int length ) {
+    int distance = 0, i = 0;
+
+#if defined(__AVX2__)
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4),
+            low_mask = _mm256_set1_epi8(0x0F);
+    __m256i sum = _mm256_setzero_si256();
+
+    for ( ; i + 32 <= length ; i += 32 ) {
+        __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i))),
+                count = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, _mm256_and_si256(x, low_mask)),
+                                        _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), low_mask)));
+        sum = _mm256_add_epi64(sum, _mm256_sad_epu8(count, _mm256_setzero_si256()));
+    }
+
+    distance = int(_mm256_extract_epi64(sum, 0) + _mm256_extract_epi64(sum, 1) + _mm256_extract_epi64(sum, 2) + _mm256_extract_epi64(sum, 3));
+#endif
+
+    for ( ; i + 8 <= length ; i += 8 ) {
+        uint64_t x, y;
+        memcpy(&x, a + i, 8);
+        memcpy(&y, b + i, 8);
+        distance += __builtin_popcountll(x ^ y);
+    }
+
+    for ( ; i < length ; i++ )
+        distance += __builtin_popcount(a[i] ^ b[i]);
+
+    return distance;
+}
+
+/**
+ * @brief Function that finds the nearest train descriptor of each query descriptor by the Hamming distance.
+ *
+ * @param query_descriptors - binary descriptors of the query frame.
+ * @param train_descriptors - binary descriptors of the train frame.
+ * @param matches - object to save the nearest train descriptor of each query descriptor.
+ *
+ * @return \c void
+ *
+ * @date 17/10/2026
+ */
+static void hammingMatch ( const cv::Mat &query_descriptors , const cv::Mat &train_descriptors , std::vector<cv::DMatch> &matches ) {
+    matches.clear();
+
+    if ( train_descriptors.empty() )
+        return;
+
+    const int length = query_descriptors.cols * int(query_descriptors.elemSize());
+    matches.reserve(query_descriptors.rows);
+
+    for ( int i = 0 ; i < query_descriptors.rows ; i++ ) {
+        const uchar *query = query_descriptors.ptr(i);
+        int best_distance = std::numeric_limits<int>::max(),
+                best_index = 0;
+
+        for ( int j = 0 ; j < train_descriptors.rows ; j++ ) {
+            int distance = hammingDistance(query, train_descriptors.ptr(j), length);
+            if ( distance < best_distance ) {
+                best_distance = distance;
+                best_index = j;
+            }
+        }
+
+        matches.push_back(cv::DMatch(i, best_index, float(best_distance)));
+    }
+}
+
+/**
+ * @brief The BruteForceMatcher class compares each query descriptor to all the train descriptors, by the L2 distance for
+ *          float descriptors and by the Hamming distance for binary ones. A match is good when its distance is smaller
+ *          than MATCHES_THRESHOLD_FACTOR times the smallest distance (or than the mean distance).
+ */
+class BruteForceMatcher : public FeatureMatcher
+{
+public:
+    explicit BruteForceMatcher ( const cv::Mat &train_descriptors ) :
+        FeatureMatcher(train_descriptors)
+    {
+    }
+
+    bool findGoodMatches ( const cv::Mat &query_descriptors , std::vector<cv::DMatch> &good_matches , const bool mean_threshold ) const {
+        const bool binary = train_descriptors.depth() == CV_8U;
+
+        std::vector< cv::DMatch > matches;
+        if ( binary )
+            hammingMatch( query_descriptors, train_descriptors, matches );
+        else {
+            cv::BFMatcher matcher;
+            matcher.match( query_descriptors, train_descriptors, matches );
+        }
+
+        double max_dist = 0.,
+                min_dist = binary ? std::numeric_limits<double>::max() : 100.,
+                sum = 0.;
+
+        //-- Quick calculation of max and min distances between keypoints.
+        for( unsigned int i = 0; i < matches.size(); i++ )
+        {
+            double dist = matches[i].distance;
+            sum = sum + dist;
+            if( dist < min_dist ) min_dist = dist;
+            else if( dist > max_dist ) max_dist = dist;
+        }
+
+        good_matches.clear();
+
+        // Catch identical images.
+        if( max_dist == 0 )
+            return false;
+
+        float matches_threshold = mean_threshold ? sum/matches.size() : MATCHES_THRESHOLD_FACTOR*min_dist;
+
+        // Binary descriptors often have a match with distance 0, which would reject all the others.
+        if ( binary && !mean_threshold )
+            matches_threshold = std::max(matches_threshold, float(MIN_BINARY_MATCHES_THRESHOLD));
+
+        for( unsigned int i = 0; i < matches.size(); i++ )
+            if( matches[i].distance < matches_threshold )
+                good_matches.push_back(matches[i]);
+
+        return true;
+    }
+};
+
+/**
+ * @brief The FlannMatcher class searches the two nearest train descriptors of each query descriptor in an index built
+ *          once for the train set: a KD-tree for float descriptors and a LSH table for binary ones. A match is good when
+ *          it passes the Lowe ratio test, which discards the query descriptors whose two nearest neighbours are almost as close.
+ */
+class FlannMatcher : public FeatureMatcher
+{
+public:
+    explicit FlannMatcher ( const cv::Mat &train_descriptors ) :
+        FeatureMatcher(train_descriptors.clone())
+    {
+        if ( this->train_descriptors.rows < 2 )
+            return;
+
+        if ( binary() )
+            index.build(this->train_descriptors, cv::flann::LshIndexParams(FLANN_LSH_TABLES, FLANN_LSH_KEY_SIZE, FLANN_LSH_MULTI_PROBE_LEVEL),
+                        cvflann::FLANN_DIST_HAMMING);
+        else
+            index.build(this->train_descriptors, cv::flann::KDTreeIndexParams(FLANN_KDTREE_TREES));
+    }
+
+    bool findGoodMatches ( const cv::Mat &query_descriptors , std::vector<cv::DMatch> &good_matches , const bool ) const {
+        good_matches.clear();
+
+        if ( query_descriptors.empty() || train_descriptors.rows < 2 )
+            return true;
+
+        cv::Mat indices, dists;
+        index.knnSearch(query_descriptors, indices, dists, 2, cv::flann::SearchParams(FLANN_SEARCH_CHECKS));
+
+        bool identical = true;
+
+        // The KD-tree gives the squared L2 distances, and the LSH table gives the Hamming distances.
+        const float ratio = binary() ? LOWE_RATIO : LOWE_RATIO * LOWE_RATIO;
+
+        for ( int i = 0 ; i < indices.rows ; i++ ) {
+            float best = dists.type() == CV_32S ? float(dists.at<int>(i, 0)) : dists.at<float>(i, 0),
+                    second = dists.type() == CV_32S ? float(dists.at<int>(i, 1)) : dists.at<float>(i, 1);
+
+            if ( best > 0 )
+                identical = false;
+
+            if ( indices.at<int>(i, 0) >= 0 && indices.at<int>(i, 1) >= 0 && best < ratio * second )
+                good_matches.push_back(cv::DMatch(i, indices.at<int>(i, 0), binary() ? best : std::sqrt(best)));
+        }
+
+        // Catch identical images.
+        if ( identical ) {
+            good_matches.clear();
+            return false;
+        }
+
+        return true;
+    }
+
+private:
+    bool binary ( void ) const {
+        return train_descriptors.depth() == CV_8U;
+    }
+
+    mutable cv::flann::Index index;/** The searches do not change the tree, the method is only not declared as const. */
+};
+
+/**
+ * @brief Function that checks if two descriptor matrices have the same values.
+ *
+ * @param descriptors_a - first matrix.
+ * @param descriptors_b - second matrix.
+ *
+ * @return \c bool
+ *
+ * @date 17/10/2026
+ */
+static bool sameDescriptors ( const cv::Mat &descriptors_a , const cv::Mat &descriptors_b ) {
+    if ( descriptors_a.rows != descriptors_b.rows || descriptors_a.cols != descriptors_b.cols || descriptors_a.type() != descriptors_b.type() )
+        return false;
+
+    for ( int i = 0 ; i < descriptors_a.rows ; i++ )
+        if ( memcmp(descriptors_a.ptr(i), descriptors_b.ptr(i), descriptors_a.cols * descriptors_a.elemSize()) != 0 )
+            return false;
+
+    return true;
+}
+
+/** Matching method of the whole process. */
+static MatcherType matcher_type = BRUTE_FORCE_MATCHER;
+
+FeatureMatcher::FeatureMatcher ( const cv::Mat &train_descriptors ) :
+    train_descriptors(train_descriptors)
+{
+}
+
+std::shared_ptr<const FeatureMatcher> FeatureMatcher::getMatcher ( const cv::Mat &train_descriptors ) {
+
+    // Nothing is built for the brute force search.
+    if ( matcher_type == BRUTE_FORCE_MATCHER )
+        return std::make_shared<BruteForceMatcher>(train_descriptors);
+
+    static std::mutex cache_mutex;
+    static std::list< std::shared_ptr<const FeatureMatcher> > cache;
+
+    {
+        std::lock_guard<std::mutex> lock(cache_mutex);
+
+        // The descriptors are compared by content, since the buffer of a descriptor matrix may be reused by another frame.
+        for ( std::list< std::shared_ptr<const FeatureMatcher> >::iterator it = cache.begin() ; it != cache.end() ; ++it )
+            if ( sameDescriptors((*it)->train_descriptors, train_descriptors) ) {
+                cache.splice(cache.begin(), cache, it);
+                return cache.front();
+            }
+    }
+
+    std::shared_ptr<const FeatureMatcher> matcher = std::make_shared<FlannMatcher>(train_descriptors);
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    cache.push_front(matcher);
+    if ( cache.size() > FEATURE_MATCHER_CACHE_SIZE )
+        cache.pop_back();
+
+    return matcher;
+}
+
+void FeatureMatcher::setType ( const MatcherType type ) {
+    matcher_type = type;
+}
+
+MatcherType FeatureMatcher::getType ( void ) {
+    return matcher_type;
+}
+
+bool FeatureMatcher::parseType ( const std::string &name , MatcherType &type ) {
+    if ( name.empty() || name == "BruteForce" )
+        type = BRUTE_FORCE_MATCHER;
+    else if ( name == "FLANN" )
+        type = FLANN_MATCHER;
+    else
+        return false;
+
+    return true;
+}
+
+std::string benchmarkFeatureMatcher ( const std::vector<cv::Mat> &frames ) {
+
+    std::vector< std::vector<cv::KeyPoint> > keypoints ( frames.size() );
+    std::vector<cv::Mat> descriptors ( frames.size() );
+    int num_queries = 0;
+
+    for ( unsigned int i = 0 ; i < frames.size() ; i++ ) {
+        getKeypointsAndDescriptors( frames[i] , keypoints[i] , descriptors[i] );
+        if ( i > 0 )
+            num_queries += descriptors[i].rows;
+    }
+
+    if ( frames.size() < 2 || descriptors[0].rows < 2 || num_queries == 0 )
+        return "Not enough frames or features to measure the matchers.\n";
+
+    const bool binary = descriptors[0].depth() == CV_8U;
+    const char *matcher_names[2] = { binary ? "BruteForce (Hamming)" : "BruteForce (L2)" , binary ? "FLANN (LSH)" : "FLANN (KD-tree)" };
+    const int num_pairs = int(frames.size()) - 1;
+
+    HomographyRansac &estimator = HomographyRansac::getEstimator();
+    std::vector<int> num_good_matches[2] , num_inliers[2];
+
+    std::stringstream report;
+    report << std::fixed << std::setprecision(2);
+
+    // The first frame is the train set, as a master frame, and the other frames are the queries.
+    for ( int type = BRUTE_FORCE_MATCHER ; type <= FLANN_MATCHER ; type++ ) {
+        std::unique_ptr<FeatureMatcher> matcher;
+
+        int64 ticks = cv::getTickCount();
+        for ( int r = 0 ; r < MATCHER_BENCHMARK_REPETITIONS ; r++ ) {
+            if ( type == BRUTE_FORCE_MATCHER )
+                matcher.reset( new BruteForceMatcher(descriptors[0]) );
+            else
+                matcher.reset( new FlannMatcher(descriptors[0]) );
+        }
+        const double build_time = ( cv::getTickCount() - ticks ) * 1000.0 / cv::getTickFrequency() / MATCHER_BENCHMARK_REPETITIONS;
+
+        std::vector< std::vector<cv::DMatch> > good_matches ( frames.size() );
+
+        ticks = cv::getTickCount();
+        for ( int r = 0 ; r < MATCHER_BENCHMARK_REPETITIONS ; r++ )
+            for ( unsigned int i = 1 ; i < frames.size() ; i++ )
+                if ( !descriptors[i].empty() )
+                    matcher->findGoodMatches( descriptors[i] , good_matches[i] );
+        const double match_time = ( cv::getTickCount() - ticks ) * 1000.0 / cv::getTickFrequency() / MATCHER_BENCHMARK_REPETITIONS;
+
+        // The inliers are counted as in the countHomographyInliers, so the matchers are compared by what the stabilization uses.
+        int total_good_matches = 0, total_inliers = 0;
+        for ( unsigned int i = 1 ; i < frames.size() ; i++ ) {
+            num_good_matches[type].push_back( int(good_matches[i].size()) );
+            num_inliers[type].push_back( good_matches[i].size() < MIN_NUMBER_OF_GOOD_MATCHES ? 0 :
+                                         estimator.countInliers( keypoints[i] , keypoints[0] , good_matches[i] ) );
+            total_good_matches += num_good_matches[type].back();
+            total_inliers += num_inliers[type].back();
+        }
+
+        report << matcher_names[type] << ": build " << build_time << " ms, " << num_queries / ( match_time / 1000.0 )
+               << " matches/s (" << match_time / num_pairs << " ms per frame), " << double(total_good_matches) / num_pairs
+               << " good matches and " << double(total_inliers) / num_pairs << " inliers per frame" << std::endl;
+    }
+
+    report << "Good matches and inliers of each frame to the first one, " << matcher_names[BRUTE_FORCE_MATCHER] << " | "
+           << matcher_names[FLANN_MATCHER] << ":" << std::endl;
+    for ( int i = 0 ; i < num_pairs ; i++ )
+        report << "    +" << i + 1 << ": " << num_good_matches[BRUTE_FORCE_MATCHER][i] << " | " << num_good_matches[FLANN_MATCHER][i]
+               << " good matches, " << num_inliers[BRUTE_FORCE_MATCHER][i] << " | " << num_inliers[FLANN_MATCHER][i] << " inliers" << std::endl;
+
+    return report.str();
+}
@@ -0,0 +1,373 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file feature_store.cpp
+ *
+ * Persistent store of the keypoints and descriptors of the video frames.
+ *
+ * Describes each frame only once and saves the result in a binary file next to the video, indexed by the frame number,
+ * so the master frames search, the stabilization loop and the frame selection share the same features, including
+ * between runs with different segment sizes or ranges.
+ *
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstring>
+
+#include "headers/feature_store.h"
+
+/** Identifies the feature files. Must change if the layout of the file changes. */
+static const char       FEATURE_STORE_MAGIC[8]          = { 'S', 'F', 'F', 'F', 'E', 'A', 'T', '\0' };
+static const uint32_t   FEATURE_STORE_VERSION           = 2;
+
+/** Number and size of the blocks of the video file used to compute its content hash. */
+static const int        CONTENT_HASH_NUM_SAMPLES        = 16;
+static const size_t     CONTENT_HASH_SAMPLE_SIZE        = 64 * 1024;
+
+FeatureStore& FeatureStore::getStore ( const std::string &video_filename )
+{
+    static std::mutex registry_mutex;
+    static std::map< std::string , std::unique_ptr<FeatureStore> > registry;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    std::unique_ptr<FeatureStore> &store = registry[video_filename];
+    if ( !store )
+        store.reset(new FeatureStore(video_filename));
+    return *store;
+}
+
+FeatureStore::FeatureStore ( const std::string &video_filename ) :
+    video_filename(video_filename),
+    store_filename(video_filename + "." + FeatureExtractor::getName() + ".features"),
+    file_descriptor(-1),
+    mapped_data(NULL),
+    mapped_size(0),
+    num_frames(0)
+{
+    if ( USE_FEATURE_STORE && !open() ) {
+        std::cout << " --(!) WARNING: Can not use the feature file \"" << store_filename << "\". The features will not be saved." << std::endl;
+        close();
+    }
+}
+
+FeatureStore::~FeatureStore ( void )
+{
+    close();
+}
+
+bool FeatureStore::isPersistent ( void ) const
+{
+    return file_descriptor >= 0;
+}
+
+/**
+ * @brief FeatureStore::contentHash Computes a FNV-1a hash of the size and of some evenly spaced blocks of the video file.
+ * @param video_filename - complete path and filename of the video.
+ * @return \c uint64_t - hash of the video content, 0 if the file can not be read.
+ */
+uint64_t FeatureStore::contentHash ( const std::string &video_filename )
+{
+    std::ifstream file ( video_filename.c_str() , std::ios::binary | std::ios::ate );
+    if ( !file.is_open() )
+        return 0;
+
+    uint64_t file_size = uint64_t(file.tellg()),
+            hash = 14695981039346656037ULL;
+
+    for ( unsigned int i = 0 ; i < sizeof(file_size) ; i++ )
+        hash = ( hash ^ ( ( file_size >> (8*i) ) & 0xFF ) ) * 1099511628211ULL;
+
+    std::vector<char> sample ( CONTENT_HASH_SAMPLE_SIZE );
+    for ( int i_sample = 0 ; i_sample < CONTENT_HASH_NUM_SAMPLES ; i_sample++ ) {
+        file.clear();
+        file.seekg( std::streamoff( file_size / CONTENT_HASH_NUM_SAMPLES * i_sample ) );
+        file.read( &sample[0] , sample.size() );
+
+        for ( std::streamsize i = 0 ; i < file.gcount() ; i++ )
+            hash = ( hash ^ uint64_t((unsigned char)sample[i]) ) * 1099511628211ULL;
+    }
+
+    return hash;
+}
+
+/**
+ * @brief The FileLock class holds a flock on the feature file while it is in scope. Shared locks are taken to read the file
+ *          and exclusive locks to write it, so the runs of other processes over the same video never see a partial block
+ *          or a file being created again.
+ */
+class FileLock
+{
+public:
+    FileLock ( const int file_descriptor , const int operation ) :
+        file_descriptor(file_descriptor)
+    {
+        while ( flock( file_descriptor , operation ) != 0 && errno == EINTR );
+    }
+
+    ~FileLock ( void )
+    {
+        flock( file_descriptor , LOCK_UN );
+    }
+
+private:
+    int file_descriptor;
+};
+
+/**
+ * @brief FeatureStore::open Opens the feature file of the video, creating it again if it is missing or stale.
+ * @return \c bool \b false if the file can not be used.
+ */
+bool FeatureStore::open ( void )
+{
+    num_frames = FrameCache::getInstance().getFrameCount(video_filename);
+    if ( num_frames < 0 )
+        return false;
+
+    memset( &expected_header , 0 , sizeof(expected_header) );
+    memcpy( expected_header.magic , FEATURE_STORE_MAGIC , sizeof(expected_header.magic) );
+    expected_header.version = FEATURE_STORE_VERSION;
+    expected_header.descriptor_cols = uint32_t(FeatureExtractor::getDescriptorSize());
+    expected_header.feature_type = int32_t(FeatureExtractor::getType());
+    expected_header.descriptor_type = int32_t(FeatureExtractor::getDescriptorType());
+    expected_header.detector_threshold = FeatureExtractor::getDetectorThreshold();
+    expected_header.content_hash = contentHash(video_filename);
+    expected_header.num_frames = num_frames;
+
+    file_descriptor = ::open( store_filename.c_str() , O_RDWR | O_CREAT , 0644 );
+    if ( file_descriptor < 0 )
+        return false;
+
+    // Exclusive, because the file may be created again, and no other run may be reading or appending to it meanwhile.
+    FileLock file_lock ( file_descriptor , LOCK_EX );
+
+    struct stat file_status;
+    if ( fstat( file_descriptor , &file_status ) != 0 )
+        return false;
+
+    const size_t table_size = size_t(num_frames) * sizeof(IndexEntry);
+    const uint64_t file_size = uint64_t(file_status.st_size);
+
+    if ( file_size >= sizeof(FileHeader) + table_size && hasExpectedHeader() ) {
+        void *map = mmap( NULL , file_size , PROT_READ , MAP_SHARED , file_descriptor , 0 );
+        if ( map != MAP_FAILED ) {
+            mapped_data = static_cast<const char*>(map);
+            mapped_size = file_size;
+        }
+        return true;
+    }
+
+    // The file is new, from another version, or was written with other parameters or for another video.
+    std::vector<IndexEntry> index_table ( num_frames , IndexEntry() );
+    if ( ftruncate( file_descriptor , 0 ) != 0 ||
+         pwrite( file_descriptor , &expected_header , sizeof(expected_header) , 0 ) != ssize_t(sizeof(expected_header)) ||
+         ( table_size > 0 && pwrite( file_descriptor , index_table.data() , table_size , sizeof(expected_header) ) != ssize_t(table_size) ) )
+        return false;
+
+    return true;
+}
+
+void FeatureStore::close ( void )
+{
+    if ( mapped_data != NULL )
+        munmap( const_cast<char*>(mapped_data) , mapped_size );
+    if ( file_descriptor >= 0 )
+        ::close( file_descriptor );
+
+    mapped_data = NULL;
+    mapped_size = 0;
+    file_descriptor = -1;
+}
+
+/**
+ * @brief FeatureStore::hasExpectedHeader Checks if the file still holds the features of this run. Another run with other
+ *          parameters may have created the file again since it was opened. Must be called holding the file lock.
+ * @return \c bool
+ */
+bool FeatureStore::hasExpectedHeader ( void ) const
+{
+    FileHeader header;
+    return pread( file_descriptor , &header , sizeof(header) , 0 ) == ssize_t(sizeof(header)) &&
+            memcmp( &header , &expected_header , sizeof(header) ) == 0;
+}
+
+/**
+ * @brief FeatureStore::readEntry Reads the entry of the frame from the index table of the file, which is shared with the
+ *          other runs over the same video. Entries pointing out of the file come from an interrupted run and are
+ *          returned empty. Must be called holding the file lock.
+ * @param index - index of the frame in the video.
+ * @param entry - object to receive the entry.
+ * @return \c bool \b false if the file does not hold the features of this run anymore or can not be read.
+ */
+bool FeatureStore::readEntry ( const int index , IndexEntry &entry ) const
+{
+    struct stat file_status;
+    if ( !hasExpectedHeader() ||
+         pread( file_descriptor , &entry , sizeof(entry) , off_t(sizeof(FileHeader) + size_t(index) * sizeof(IndexEntry)) ) != ssize_t(sizeof(entry)) ||
+         fstat( file_descriptor , &file_status ) != 0 )
+        return false;
+
+    const uint64_t block_size = uint64_t(entry.num_keypoints) *
+            ( sizeof(StoredKeyPoint) + entry.descriptor_cols * size_t(CV_ELEM_SIZE(expected_header.descriptor_type)) );
+    if ( entry.offset != 0 && entry.offset + block_size > uint64_t(file_status.st_size) )
+        entry = IndexEntry();
+
+    return true;
+}
+
+/**
+ * @brief FeatureStore::readBlock Copies a block of the file, from the memory map when it covers the block.
+ * @param offset - offset of the block in the file.
+ * @param length - size of the block in bytes.
+ * @param buffer - object to receive the block.
+ * @return \c bool \b false if the block could not be read.
+ */
+bool FeatureStore::readBlock ( const uint64_t offset , const size_t length , void *buffer ) const
+{
+    if ( offset + length <= mapped_size ) {
+        memcpy( buffer , mapped_data + offset , length );
+        return true;
+    }
+
+    return pread( file_descriptor , buffer , length , off_t(offset) ) == ssize_t(length);
+}
+
+bool FeatureStore::contains ( const int index )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    if ( file_descriptor < 0 || index < 0 || index >= num_frames )
+        return false;
+
+    FileLock file_lock ( file_descriptor , LOCK_SH );
+
+    IndexEntry entry;
+    return readEntry( index , entry ) && entry.offset != 0;
+}
+
+bool FeatureStore::lookup ( const int index , std::vector<cv::KeyPoint> &keypoints , cv::Mat &descriptors )
+{
+    std::vector<StoredKeyPoint> stored_keypoints;
+    cv::Mat stored_descriptors;
+
+    {
+        // The flock belongs to the file descriptor, which is shared by all threads, so the threads are serialized here.
+        std::lock_guard<std::mutex> lock(mutex);
+        if ( file_descriptor < 0 || index < 0 || index >= num_frames )
+            return false;
+
+        FileLock file_lock ( file_descriptor , LOCK_SH );
+
+        IndexEntry entry;
+        if ( !readEntry( index , entry ) || entry.offset == 0 )
+            return false;
+
+        stored_keypoints.resize( entry.num_keypoints );
+        if ( entry.num_keypoints > 0 ) {
+            stored_descriptors.create( entry.num_keypoints , entry.descriptor_cols , FeatureExtractor::getDescriptorType() );
+
+            const size_t keypoints_size = stored_keypoints.size() * sizeof(StoredKeyPoint);
+            if ( !readBlock( entry.offset , keypoints_size , &stored_keypoints[0] ) ||
+                 !readBlock( entry.offset + keypoints_size , stored_descriptors.total() * stored_descriptors.elemSize() , stored_descriptors.data ) )
+                return false;
+        }
+    }
+
+    keypoints.resize( stored_keypoints.size() );
+    for ( unsigned int i = 0 ; i < stored_keypoints.size() ; i++ ) {
+        const StoredKeyPoint &stored = stored_keypoints[i];
+        keypoints[i] = cv::KeyPoint( stored.x , stored.y , stored.size , stored.angle , stored.response , stored.octave , stored.class_id );
+    }
+    descriptors = stored_descriptors;
+
+    return true;
+}
+
+void FeatureStore::insert ( const int index , const std::vector<cv::KeyPoint> &keypoints , const cv::Mat &descriptors )
+{
+    if ( !keypoints.empty() && ( descriptors.type() != FeatureExtractor::getDescriptorType() || descriptors.rows != int(keypoints.size()) || !descriptors.isContinuous() ) )
+        return;
+
+    std::vector<StoredKeyPoint> stored_keypoints ( keypoints.size() );
+    for ( unsigned int i = 0 ; i < keypoints.size() ; i++ ) {
+        StoredKeyPoint &stored = stored_keypoints[i];
+        stored.x = keypoints[i].pt.x;
+        stored.y = keypoints[i].pt.y;
+        stored.size = keypoints[i].size;
+        stored.angle = keypoints[i].angle;
+        stored.response = keypoints[i].response;
+        stored.octave = keypoints[i].octave;
+        stored.class_id = keypoints[i].class_id;
+    }
+
+    IndexEntry entry;
+    entry.num_keypoints = uint32_t(keypoints.size());
+    entry.descriptor_cols = keypoints.empty() ? 0 : uint32_t(descriptors.cols);
+
+    const size_t keypoints_size = stored_keypoints.size() * sizeof(StoredKeyPoint),
+            descriptors_size = keypoints.empty() ? 0 : descriptors.total() * descriptors.elemSize();
+
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if ( file_descriptor < 0 || index < 0 || index >= num_frames )
+        return;
+
+    FileLock file_lock ( file_descriptor , LOCK_EX );
+
+    // Another run may have described the frame already.
+    IndexEntry stored_entry;
+    if ( !readEntry( index , stored_entry ) || stored_entry.offset != 0 )
+        return;
+
+    // Other runs append to the same file, so the end of the file is only known while holding the lock.
+    struct stat file_status;
+    if ( fstat( file_descriptor , &file_status ) != 0 )
+        return;
+
+    // The block is written before the index entry, so an interrupted run never leaves an entry pointing to missing data.
+    entry.offset = uint64_t(file_status.st_size);
+    if ( ( keypoints_size > 0 && pwrite( file_descriptor , &stored_keypoints[0] , keypoints_size , off_t(entry.offset) ) != ssize_t(keypoints_size) ) ||
+         ( descriptors_size > 0 && pwrite( file_descriptor , descriptors.data , descriptors_size , off_t(entry.offset + keypoints_size) ) != ssize_t(descriptors_size) ) )
+        return;
+
+    // Empty blocks still need a valid offset different from zero, which is always true after the header.
+    pwrite( file_descriptor , &entry , sizeof(entry) , off_t(sizeof(FileHeader) + size_t(index) * sizeof(IndexEntry)) );
+}
+
+void FeatureStore::getKeypointsAndDescriptors ( const int index , const cv::Mat &frame ,
+                                                std::vector<cv::KeyPoint> &keypoints , cv::Mat &descriptors )
+{
+    // An empty image has no features, and they must not be stored as the features of the frame.
+    if ( frame.empty() ) {
+        keypoints.clear();
+        descriptors.release();
+        return;
+    }
+
+    if ( lookup( index , keypoints , descriptors ) )
+        return;
+
+    ::getKeypointsAndDescriptors( frame , keypoints , descriptors );
+    insert( index , keypoints , descriptors );
+}
@@ -175,22 +175,26 @@ std::string getExperimentId(){
 }
 
 /**
- * @brief Function that set the file pointer to the desired line, if it is smaller than the file number of lines.
+ * @brief Table with the semantic costs shared by all the calls of getSemanticCost.
+ */
+static SemanticCostTable semantic_cost_table;
+
+/**
+ * @brief Function that loads the semantic costs of all transitions defined in the experiment_settings into memory.
+ *          It must be called before any thread starts calling getSemanticCost.
  *
- * @param file - std::ifstream object where the file is read.
- * @param line - line where the header read will be set.
+ * @param experiment_settings - variable with the experiment setting.
  *
- * @return \c std::istream - Reference to the file in the selected line.
+ * @return \c void
  *
- * @author Michel Melo da Silva
- * @date 30/04/2016
+ * @date 17/10/2026
  */
-std::istream& goToLine(std::istream& file, const unsigned int line){
-    file.seekg(std::ios::beg);
-    for ( unsigned int i = 0 ; i < line ; ++i ){
-        file.ignore( std::numeric_limits<std::streamsize>::max() , '\n' );
+void loadSemanticCostTable ( const EXPERIMENT &experiment_settings ){
+
+    if ( !semantic_cost_table.load( experiment_settings.semantic_costs_filename ) ){
+        std::cerr << " --(!) ERROR: Can not open the CSV file \"" << experiment_settings.semantic_costs_filename << "\" with the semantic costs." << std::endl;
+        exit(-10);
     }
-    return file;
 }
 
 /**
@@ -208,40 +212,17 @@ std::istream& goToLine(std::istream& file, const unsigned int line){
  */
 double getSemanticCost ( const EXPERIMENT &experiment_settings , const int frame_src , const int frame_dst ){
 
-    std::ifstream file ( experiment_settings.semantic_costs_filename.c_str(), std::ios::in );
-
-    if ( !file.is_open() ){
-        std::cerr << " --(!) ERROR: Can not open the CSV file \"" << experiment_settings.semantic_costs_filename << "\" with the semantic costs." << std::endl;
-        exit(-10);
-    }
-
-    //Read the first two lines to find the frame ranges for the video
-    std::string line, cost;
-
-    getline(file,line);
-    std::istringstream drift_string( line );
-    getline( drift_string, cost, ',' );
-
-    double shift = std::atof(cost.c_str());
+    if ( !semantic_cost_table.isLoaded() )
+        loadSemanticCostTable( experiment_settings );
 
-    int line_number = (frame_src-shift+1)+1;
+    double cost;
 
-    goToLine(file, line_number);
-
-    getline(file,line);
-
-    file.close();
-
-    std::istringstream ss( line );
-
-    for ( int i = 0 ; i < (frame_dst - frame_src) ; i ++ ) {
-        if (!getline( ss, cost, ',' )) {
-            std::cerr << " --(!) ERROR: Transition from frame_src to frame_dst larger than number of transitions describle int the file the semantic costs." << std::endl;
-            exit(-11);
-        }
+    if ( !semantic_cost_table.getCost( frame_src , frame_dst , cost ) ) {
+        std::cerr << " --(!) ERROR: Transition from frame_src to frame_dst larger than number of transitions describle int the file the semantic costs." << std::endl;
+        exit(-11);
     }
 
-    return ( 1.0f - std::atof(cost.c_str()) ) ;
+    return cost;
 
 }
 
@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file frame_cache.cpp
+ *
+ * Process-wide cache of decoded video frames.
+ *
+ * Decodes the frames of the videos on demand and keeps the most recently used ones in memory, so the frame selection
+ * and the image reconstruction do not need to open, seek and decode the original video on every call.
+ *
+ */
+
+#include "headers/frame_cache.h"
+
+FrameCache::FrameCache ( void ) :
+    budget(size_t(FRAME_CACHE_BUDGET_MB) * 1024 * 1024),
+    bytes_in_use(0)
+{
+}
+
+FrameCache& FrameCache::getInstance ( void )
+{
+    static FrameCache frame_cache;
+    return frame_cache;
+}
+
+/**
+ * @brief FrameCache::getDecoder Returns the decoder of the video, opening it in the first call.
+ * @param video_filename - complete path and filename of the video.
+ * @return \c std::shared_ptr<Decoder> - decoder of the video. Its VideoCapture is not opened if the video could not be read.
+ */
+std::shared_ptr<FrameCache::Decoder> FrameCache::getDecoder ( const std::string &video_filename )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::shared_ptr<Decoder> &decoder = decoders[video_filename];
+    if ( !decoder ) {
+        decoder = std::make_shared<Decoder>();
+        decoder->video.open(video_filename);
+        decoder->num_frames = decoder->video.isOpened() ? int(decoder->video.get(CV_CAP_PROP_FRAME_COUNT)) : -1;
+        decoder->next_index = 0;
+    }
+    return decoder;
+}
+
+bool FrameCache::isOpened ( const std::string &video_filename )
+{
+    return getDecoder(video_filename)->num_frames >= 0;
+}
+
+int FrameCache::getFrameCount ( const std::string &video_filename )
+{
+    return getDecoder(video_filename)->num_frames;
+}
+
+/**
+ * @brief FrameCache::lookup Searches the frame in the cache, moving it to the front of the LRU list.
+ * @param key - video filename and frame index.
+ * @param frame - object to receive the header of the cached frame.
+ * @return \c bool \b true if the frame is cached.
+ */
+bool FrameCache::lookup ( const FrameKey &key , cv::Mat &frame )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    std::map< FrameKey , FrameList::iterator >::iterator it = frame_index.find(key);
+    if ( it == frame_index.end() )
+        return false;
+
+    frames.splice(frames.begin(), frames, it->second);
+    frame = it->second->second;
+    return true;
+}
+
+/**
+ * @brief FrameCache::insert Stores a decoded frame in the front of the LRU list and evicts the frames over the budget.
+ * @param key - video filename and frame index.
+ * @param frame - decoded frame. The cache keeps a reference to its data.
+ */
+void FrameCache::insert ( const FrameKey &key , const cv::Mat &frame )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    if ( frame_index.count(key) )
+        return;
+
+    frames.push_front(std::make_pair(key, frame));
+    frame_index[key] = frames.begin();
+    bytes_in_use += frame.total() * frame.elemSize();
+
+    evict();
+}
+
+/**
+ * @brief FrameCache::evict Drops the least recently used frames until the cache fits in the budget. The mutex must be held.
+ */
+void FrameCache::evict ( void )
+{
+    while ( bytes_in_use > budget && !frames.empty() ) {
+        const cv::Mat &frame = frames.back().second;
+        bytes_in_use -= frame.total() * frame.elemSize();
+        frame_index.erase(frames.back().first);
+        frames.pop_back();
+    }
+}
+
+bool FrameCache::getFrame ( const std::string &video_filename , const int index , cv::Mat &frame )
+{
+    FrameKey key(video_filename, index);
+
+    if ( lookup(key, frame) )
+        return true;
+
+    std::shared_ptr<Decoder> decoder = getDecoder(video_filename);
+
+    if ( index < 0 || index >= decoder->num_frames ) {
+        frame.release();
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(decoder->mutex);
+
+    // Another thread may have decoded the frame while this one was waiting for the decoder.
+    if ( lookup(key, frame) )
+        return true;
+
+    // Short forward jumps are cheaper to decode than to seek, since a seek restarts from the previous key frame.
+    if ( index < decoder->next_index || index - decoder->next_index > FRAME_CACHE_MAX_SEQUENTIAL_SKIP ) {
+        decoder->video.set(CV_CAP_PROP_POS_FRAMES, index);
+        decoder->next_index = index;
+    }
+
+    int last_index = std::min(index + FRAME_CACHE_READ_AHEAD, decoder->num_frames.load());
+    cv::Mat decoded_frame;
+
+    frame.release();
+    while ( decoder->next_index < last_index ) {
+        // Each decoded frame needs its own buffer, since the cache keeps a reference to it.
+        decoded_frame = cv::Mat();
+        if ( !decoder->video.read(decoded_frame) || decoded_frame.empty() ) {
+            decoder->num_frames = decoder->next_index;
+            break;
+        }
+
+        insert(FrameKey(video_filename, decoder->next_index), decoded_frame);
+        if ( decoder->next_index == index )
+            frame = decoded_frame;
+        decoder->next_index++;
+    }
+
+    return !frame.empty();
+}
+
+void FrameCache::setBudget ( const size_t budget_bytes )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    budget = budget_bytes;
+    evict();
+}
+
+void FrameCache::clear ( void )
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    frames.clear();
+    frame_index.clear();
+    decoders.clear();
+    bytes_in_use = 0;
+}
@@ -22,13 +22,22 @@
  * Functions related with homography transformation.
  *
  * Functions find homography matrix between two images. Apply homography matrix. Check if the image corner consistency is held after application of the homography matrix.
- * Check the area ratio between the image after the homography matrix application and the frame boundaries.
+ * Check the area ratio between the image after the homography matrix application and the frame boundaries, clipping the
+ * warped image corners by the frame boundaries.
  *
  */
 
+#include <cfloat>
+
 #include "definitions/define.h"
 
 #include "headers/homography.h"
+#include "headers/line_and_point_operations.h"
+#include "headers/feature_matcher.h"
+#include "headers/feature_extractor.h"
+#include "headers/scratch_arena.h"
+#include "headers/perspective_warp.h"
+#include "headers/homography_ransac.h"
 
 /**
  * @brief Function that find the homography matrix that leaves the imageSrc to the plan of the imageDst. Returns the Ransak mask after finding the homography matrix.
@@ -47,78 +56,34 @@
  */
 bool findHomographyMatrix( const cv::Mat &image_src, const cv::Mat &image_dst, cv::Mat &homography_matrix, cv::Mat &ransac_mask )
 {
-    //-- Step 1: Detect the keypoints using SURF Detector.
-    int min_hessian = 400;
+    //-- Step 1 and 2: Detect the keypoints and calculate descriptors (feature vectors).
     std::vector< cv::KeyPoint > keypoints_image_src,
             keypoints_image_dst;
 
-    cv::SurfFeatureDetector detector( min_hessian );
-    detector.detect( image_src, keypoints_image_src );
-    detector.detect( image_dst, keypoints_image_dst );
-
-    //-- Step 2: Calculate descriptors (feature vectors).
-    cv::SurfDescriptorExtractor extractor;
-
     cv::Mat descriptors_image_src,
             descriptors_image_dst;
 
-    extractor.compute( image_src, keypoints_image_src, descriptors_image_src );
-    extractor.compute( image_dst, keypoints_image_dst, descriptors_image_dst );
+    getKeypointsAndDescriptors( image_src, keypoints_image_src, descriptors_image_src );
+    getKeypointsAndDescriptors( image_dst, keypoints_image_dst, descriptors_image_dst );
 
-    //-- Step 3: Matching descriptor vectors using BF matcher.
-    cv::BFMatcher matcher;
-    std::vector< cv::DMatch > matches;
-    matcher.match( descriptors_image_src, descriptors_image_dst, matches );
-
-    double max_dist = 0,
-           min_dist = 100;
-
-    //-- Quick calculation of max and min distances between keypoints.
-    for( int i = 0; i < descriptors_image_src.rows; i++ )
-    {
-        double dist = matches[i].distance;
-        if( dist < min_dist ) min_dist = dist;
-        else if( dist > max_dist ) max_dist = dist;
-    }
+    //-- Step 3 and 4: Matching descriptor vectors and selecting only the "good" matches.
+    HomographyRansac &estimator = HomographyRansac::getEstimator();
+    std::vector< cv::DMatch > &good_matches = estimator.getMatchBuffer();
 
     // Catch identical images.
-    if( max_dist == 0 ){
+    if( !FeatureMatcher::getMatcher(descriptors_image_dst)->findGoodMatches(descriptors_image_src, good_matches) ){
         ransac_mask = cv::Mat::zeros(1,1,CV_32F);
         return false;
     }
 
-    //    std::cout << "-- Number of matches: " << matches.size() << std::endl
-    //              << "-- Max dist : " <<  max_dist << std::endl
-    //              << "-- Min dist : " << min_dist << std::endl
-    //              << "-- Threshold match: " << thresholdMatch*min_dist << std::endl << std::endl;
-
-    //-- Step 4: Select only "good" matches (i.e. whose distance is less than 3*min_dist ).
-    std::vector< cv::DMatch > good_matches;
-    float matches_threshold = MATCHES_THRESHOLD_FACTOR*min_dist;
-
-    for( unsigned int i = 0; i < matches.size(); i++ )
-        if( matches[i].distance < matches_threshold)
-            good_matches.push_back(matches[i]);
-
     // Catch not enough number of matches ( good_matches.size() < 4 ).
     if( good_matches.size() < MIN_NUMBER_OF_GOOD_MATCHES ){
         ransac_mask = cv::Mat::zeros(1,1,CV_32F);
         return false;
     }
 
-    std::vector< cv::Point2f > selected_keypoints_image_src(good_matches.size()),
-            selected_keypoints_image_dst(good_matches.size());
-
-    for( unsigned int i = 0; i < good_matches.size(); i++ )
-    {
-        //-- Get the keypoints from the good matches.
-        selected_keypoints_image_src[i] = keypoints_image_src[ good_matches[i].queryIdx ].pt;
-        selected_keypoints_image_dst[i] = keypoints_image_dst[ good_matches[i].trainIdx ].pt;
-    }
-
-
     //-- Step 5: Find the Homography Matrix.
-    homography_matrix = cv::findHomography( selected_keypoints_image_src, selected_keypoints_image_dst, CV_RANSAC, 3, ransac_mask);
+    estimator.findHomography( keypoints_image_src, keypoints_image_dst, good_matches, homography_matrix, ransac_mask );
 
     //    std::cout << "-- Number of good matches: " << ransacMask.size().height << std::endl
     //              << "-- Number of RANSAC inliers: " << cv::sum( ransacMask )[0] << std::endl;
@@ -142,53 +107,27 @@ bool findHomographyMatrix( const cv::Mat &image_src, const cv::Mat &image_dst, c
  */
 bool findHomographyMatrix( const cv::Mat &image_src, const cv::Mat &image_dst, cv::Mat &homography_matrix )
 {
-    //-- Step 1: Detect the keypoints using SURF Detector.
-    int min_hessian = 400;
+    //-- Step 1 and 2: Detect the keypoints and calculate descriptors (feature vectors).
     std::vector< cv::KeyPoint > keypoints_image_src,
             keypoints_image_dst;
 
-    //    cv::SiftFeatureDetector detector;
-    cv::SurfFeatureDetector detector( min_hessian );
-    detector.detect( image_src, keypoints_image_src );
-    detector.detect( image_dst, keypoints_image_dst );
-
-    //-- Step 2: Calculate descriptors (feature vectors).
-    cv::SurfDescriptorExtractor extractor;
-    //    cv::SiftDescriptorExtractor extractor;
-
     cv::Mat descriptors_image_src,
             descriptors_image_dst;
 
-    extractor.compute( image_src, keypoints_image_src, descriptors_image_src );
-    extractor.compute( image_dst, keypoints_image_dst, descriptors_image_dst );
+    getKeypointsAndDescriptors( image_src, keypoints_image_src, descriptors_image_src );
+    getKeypointsAndDescriptors( image_dst, keypoints_image_dst, descriptors_image_dst );
 
-    //-- Step 3: Matching descriptor vectors using BF matcher.
-    cv::BFMatcher matcher;
-    std::vector< cv::DMatch > matches;
-    matcher.match( descriptors_image_src, descriptors_image_dst, matches );
-
-    double max_dist = 0,
-            min_dist = 100;
-
-    //-- Quick calculation of max and min distances between keypoints.
-    for( int i = 0; i < descriptors_image_src.rows; i++ )
-    {
-        double dist = matches[i].distance;
-        if( dist < min_dist ) min_dist = dist;
-        else if( dist > max_dist ) max_dist = dist;
-    }
-
-    // Catch identical or no keypoints images.
-    if( max_dist == 0 || keypoints_image_src.empty() || keypoints_image_dst.empty())
+    // Catch no keypoints images.
+    if( keypoints_image_src.empty() || keypoints_image_dst.empty() )
         return false;
 
-    //-- Step 4: Select only "good" matches (i.e. whose distance is less than 3*min_dist ).
-    std::vector< cv::DMatch > good_matches;
-    float matches_threshold = MATCHES_THRESHOLD_FACTOR*min_dist;
+    //-- Step 3 and 4: Matching descriptor vectors and selecting only the "good" matches.
+    HomographyRansac &estimator = HomographyRansac::getEstimator();
+    std::vector< cv::DMatch > &good_matches = estimator.getMatchBuffer();
 
-    for( int i = 0; i < descriptors_image_src.rows; i++ )
-        if( matches[i].distance < matches_threshold )
-            good_matches.push_back(matches[i]);
+    // Catch identical images.
+    if( !FeatureMatcher::getMatcher(descriptors_image_dst)->findGoodMatches(descriptors_image_src, good_matches) )
+        return false;
 
     // Catch not enoughy number of matches ( good_matches.size() < 4 ).
     if( good_matches.size() < MIN_NUMBER_OF_GOOD_MATCHES )
@@ -197,23 +136,11 @@ bool findHomographyMatrix( const cv::Mat &image_src, const cv::Mat &image_dst, c
     // ----------------------------------------------------------------------
     // DEBUG
     if ( DEBUG_HOMOGRAPHY )
-        std::cout << "-- Max dist : " <<  max_dist << std::endl
-                  << "-- Min dist : " << min_dist << std::endl
-                  << "-- Good matches : " <<  good_matches.size() << std::endl;
+        std::cout << "-- Good matches : " <<  good_matches.size() << std::endl;
     // ----------------------------------------------------------------------
 
-    std::vector< cv::Point2f > selected_keypoints_image_src(good_matches.size()),
-            selected_keypoints_image_dst(good_matches.size());
-
-    for( unsigned int i = 0; i < good_matches.size(); i++ )
-    {
-        //-- Get the keypoints from the good matches.
-        selected_keypoints_image_src[i] = keypoints_image_src[ good_matches[i].queryIdx ].pt;
-        selected_keypoints_image_dst[i] = keypoints_image_dst[ good_matches[i].trainIdx ].pt;
-    }
-
     //-- Step 5: Find the Homography Matrix.
-    homography_matrix = cv::findHomography( selected_keypoints_image_src , selected_keypoints_image_dst , CV_RANSAC );
+    estimator.findHomography( keypoints_image_src, keypoints_image_dst, good_matches, homography_matrix );
 
     return true;
 }
@@ -240,66 +167,25 @@ bool findHomographyMatrix( const std::vector<cv::KeyPoint> &keypoints_image_src,
                            cv::Mat &homography_matrix, cv::Mat &ransac_mask )
 {
     //Following steps after detecting keypoints and describing the image
-    //-- Step 3: Matching descriptor vectors using BF matcher.
-    cv::BFMatcher matcher;
-    std::vector< cv::DMatch > matches;
-    matcher.match( descriptors_image_src, descriptors_image_dst, matches );
-
-    double max_dist = 0.,
-           min_dist = 100.,
-           sum = 0.,
-            matches_threshold;
-
-    //-- Quick calculation of max and min distances between keypoints.
-    for( unsigned int i = 0; i < matches.size(); i++ )
-    {
-        double dist = matches[i].distance;
-        sum = sum + dist;
-        if( dist < min_dist ) min_dist = dist;
-        else if( dist > max_dist ) max_dist = dist;
-    }
-
-    matches_threshold = sum/matches.size();
+    //-- Step 3 and 4: Matching descriptor vectors and selecting only the "good" matches (the brute force matcher uses the mean distance as threshold).
+    HomographyRansac &estimator = HomographyRansac::getEstimator();
+    std::vector< cv::DMatch > &good_matches = estimator.getMatchBuffer();
 
     // Catch identical or no keypoints images.
-    if( max_dist == 0 || keypoints_image_src.empty() || keypoints_image_dst.empty()){
+    if( keypoints_image_src.empty() || keypoints_image_dst.empty()
+            || !FeatureMatcher::getMatcher(descriptors_image_dst)->findGoodMatches(descriptors_image_src, good_matches, true) ){
         ransac_mask = cv::Mat::zeros(1,1,CV_32F);
         return false;
     }
 
-    //float matches_threshold = MATCHES_THRESHOLD_FACTOR*average;
-
-    //    std::cout << "-- Number of matches: " << matches.size() << std::endl
-    //              << "-- Max dist : " <<  max_dist << std::endl
-    //              << "-- Min dist : " << min_dist << std::endl
-    //              << "-- Threshold match: " << thresholdMatch*min_dist << std::endl << std::endl;
-
-    //-- Step 4: Select only "good" matches (i.e. whose distance is less than 3*min_dist ).
-    std::vector< cv::DMatch > good_matches;
-
-
-    for( unsigned int i = 0; i < matches.size(); i++ )
-        if( matches[i].distance < matches_threshold)
-            good_matches.push_back(matches[i]);
-
     // Catch not enough number of matches ( good_matches.size() < 4 ).
     if( good_matches.size() < MIN_NUMBER_OF_GOOD_MATCHES ){
         ransac_mask = cv::Mat::zeros(1,1,CV_32F);
         return false;
     }
 
-    std::vector< cv::Point2f > selected_keypoints_image_src(good_matches.size()),
-            selected_keypoints_image_dst(good_matches.size());
-
-    for( unsigned int i = 0; i < good_matches.size(); i++ )
-    {
-        //-- Get the keypoints from the good matches.
-        selected_keypoints_image_src[i] = keypoints_image_src[ good_matches[i].queryIdx ].pt;
-        selected_keypoints_image_dst[i] = keypoints_image_dst[ good_matches[i].trainIdx ].pt;
-    }
-
     //-- Step 5: Find the Homography Matrix.
-    homography_matrix = cv::findHomography( selected_keypoints_image_src, selected_keypoints_image_dst, CV_RANSAC, 3, ransac_mask);
+    estimator.findHomography( keypoints_image_src, keypoints_image_dst, good_matches, homography_matrix, ransac_mask );
 
     //    std::cout << "-- Number of good matches: " << ransacMask.size().height << std::endl
     //              << "-- Number of RANSAC inliers: " << cv::sum( ransacMask )[0] << std::endl;
@@ -315,6 +201,8 @@ bool findHomographyMatrix( const std::vector<cv::KeyPoint> &keypoints_image_src,
  * @param descriptors_image_src - descriptors of the source image.
  * @param descriptors_image_dst - descriptors of the target image.
  * @param homography_matrix - object to save the homography matrix calculated.
+ * @param mean_threshold - selects the good matches with the mean distance as threshold, as the findHomographyMatrix
+ *          with the RANSAC mask. If \b false, uses MATCHES_THRESHOLD_FACTOR times the minimum distance.
  *
  * @return
  *      \c bool \b true  - if there is enough points in both images and good matches between them to find a homography matrix. \n
@@ -325,36 +213,17 @@ bool findHomographyMatrix( const std::vector<cv::KeyPoint> &keypoints_image_src,
  */
 bool findHomographyMatrix(const std::vector<cv::KeyPoint> &keypoints_image_src, const std::vector<cv::KeyPoint> &keypoints_image_dst,
                           const cv::Mat &descriptors_image_src, const cv::Mat &descriptors_image_dst,
-                          cv::Mat &homography_matrix)
+                          cv::Mat &homography_matrix, const bool mean_threshold)
 {
-    //-- Step 3: Matching descriptor vectors using BF matcher.
-    cv::BFMatcher matcher;
-    std::vector< cv::DMatch > matches;
-    matcher.match( descriptors_image_src, descriptors_image_dst, matches );
-
-    double max_dist = 0,
-            min_dist = 100;
-
-    //-- Quick calculation of max and min distances between keypoints.
-    for( int i = 0; i < descriptors_image_src.rows; i++ )
-    {
-        double dist = matches[i].distance;
-        if( dist < min_dist ) min_dist = dist;
-        else if( dist > max_dist ) max_dist = dist;
-    }
+    //-- Step 3 and 4: Matching descriptor vectors and selecting only the "good" matches.
+    HomographyRansac &estimator = HomographyRansac::getEstimator();
+    std::vector< cv::DMatch > &good_matches = estimator.getMatchBuffer();
 
-    // Catch identical images.
-    if( max_dist == 0 )
+    // Catch identical or no keypoints images.
+    if( keypoints_image_src.empty() || keypoints_image_dst.empty()
+            || !FeatureMatcher::getMatcher(descriptors_image_dst)->findGoodMatches(descriptors_image_src, good_matches, mean_threshold) )
         return false;
 
-    //-- Step 4: Select only "good" matches (i.e. whose distance is less than 3*min_dist ).
-    std::vector< cv::DMatch > good_matches;
-    float matches_threshold = MATCHES_THRESHOLD_FACTOR*min_dist;
-
-    for( int i = 0; i < descriptors_image_src.rows; i++ )
-        if( matches[i].distance < matches_threshold )
-            good_matches.push_back(matches[i]);
-
     // Catch not enoughy number of matches ( good_matches.size() < 4 ).
     if( good_matches.size() < MIN_NUMBER_OF_GOOD_MATCHES )
         return false;
@@ -367,20 +236,138 @@ bool findHomographyMatrix(const std::vector<cv::KeyPoint> &keypoints_image_src,
 //                  << "-- Good matches : " <<  good_matches.size() << std::endl;
     // ----------------------------------------------------------------------
 
-    std::vector< cv::Point2f > selected_keypoints_image_src(good_matches.size()),
-            selected_keypoints_image_dst(good_matches.size());
+    //-- Step 5: Find the Homography Matrix.
+    estimator.findHomography( keypoints_image_src, keypoints_image_dst, good_matches, homography_matrix );
 
-    for( unsigned int i = 0; i < good_matches.size(); i++ )
-    {
-        //-- Get the keypoints from the good matches.
-        selected_keypoints_image_src[i] = keypoints_image_src[ good_matches[i].queryIdx ].pt;
-        selected_keypoints_image_dst[i] = keypoints_image_dst[ good_matches[i].trainIdx ].pt;
+    return true;
+}
+
+/**
+ * @brief Function that counts the RANSAC inliers of the homography from the imageSrc to the imageDst, as the sum of the
+ *          mask of the findHomographyMatrix, without refining the homography or building the mask.
+ *
+ * @param image_src - image to where the homography will be calculated.
+ * @param image_dst - image of the destination of the homography.
+ * @param stop_inliers - the search stops as soon as a consensus has this number of inliers. 0 never stops early.
+ *
+ * @return \c int - the number of inliers, 0 if there is not enough points in both images or good matches between them.
+ *
+ * @date 17/10/2026
+ */
+int countHomographyInliers( const cv::Mat &image_src, const cv::Mat &image_dst, const int stop_inliers )
+{
+    //-- Step 1 and 2: Detect the keypoints and calculate descriptors (feature vectors).
+    std::vector< cv::KeyPoint > keypoints_image_src,
+            keypoints_image_dst;
+
+    cv::Mat descriptors_image_src,
+            descriptors_image_dst;
+
+    getKeypointsAndDescriptors( image_src, keypoints_image_src, descriptors_image_src );
+    getKeypointsAndDescriptors( image_dst, keypoints_image_dst, descriptors_image_dst );
+
+    //-- Step 3 and 4: Matching descriptor vectors and selecting only the "good" matches.
+    HomographyRansac &estimator = HomographyRansac::getEstimator();
+    std::vector< cv::DMatch > &good_matches = estimator.getMatchBuffer();
+
+    // Catch identical images and not enough number of matches.
+    if( !FeatureMatcher::getMatcher(descriptors_image_dst)->findGoodMatches(descriptors_image_src, good_matches)
+            || good_matches.size() < MIN_NUMBER_OF_GOOD_MATCHES )
+        return 0;
+
+    //-- Step 5: Find the best consensus.
+    return estimator.countInliers( keypoints_image_src, keypoints_image_dst, good_matches, stop_inliers );
+}
+
+/**
+ * @brief Function that counts the RANSAC inliers of the homography given the keypoints and descriptors, as the sum of the
+ *          mask of the findHomographyMatrix, without refining the homography or building the mask.
+ *
+ * @param keypoints_image_src - keypoints of the source image.
+ * @param keypoints_image_dst - keypoints of the target image.
+ * @param descriptors_image_src - descriptors of the source image.
+ * @param descriptors_image_dst - descriptors of the target image.
+ * @param stop_inliers - the search stops as soon as a consensus has this number of inliers. 0 never stops early.
+ * @param mean_threshold - selects the good matches with the mean distance as threshold, as the findHomographyMatrix of
+ *          the keypoints. If \b false, uses the minimum distance threshold of the findHomographyMatrix of the images.
+ *
+ * @return \c int - the number of inliers, 0 if there is not enough points in both images or good matches between them.
+ *
+ * @date 17/10/2026
+ */
+int countHomographyInliers( const std::vector<cv::KeyPoint> &keypoints_image_src, const std::vector<cv::KeyPoint> &keypoints_image_dst,
+                            const cv::Mat &descriptors_image_src, const cv::Mat &descriptors_image_dst, const int stop_inliers,
+                            const bool mean_threshold )
+{
+    //-- Step 3 and 4: Matching descriptor vectors and selecting only the "good" matches.
+    HomographyRansac &estimator = HomographyRansac::getEstimator();
+    std::vector< cv::DMatch > &good_matches = estimator.getMatchBuffer();
+
+    // Catch identical or no keypoints images and not enough number of matches.
+    if( keypoints_image_src.empty() || keypoints_image_dst.empty()
+            || !FeatureMatcher::getMatcher(descriptors_image_dst)->findGoodMatches(descriptors_image_src, good_matches, mean_threshold)
+            || good_matches.size() < MIN_NUMBER_OF_GOOD_MATCHES )
+        return 0;
+
+    //-- Step 5: Find the best consensus.
+    return estimator.countInliers( keypoints_image_src, keypoints_image_dst, good_matches, stop_inliers );
+}
+
+/**
+ * @brief Function that finds the size of the canvas where the image fits after the application of the homography
+ *          matrix, and checks if the projection is accepted: the corner consistency is maintained and the canvas is
+ *          at most 4 times the image in each direction.
+ *
+ * @param image_size - The size of the source image.
+ * @param homography_matrix - The homography matrix.
+ * @param warped_size - object to save the size of the canvas.
+ *
+ * @return
+ *      \c bool \b true  - if the projection is accepted. \n
+ *      \c bool \b false - if the projection is not accepted. In this case the image is kept as is.
+ *
+ * @date 17/10/2026
+ */
+static bool getWarpedSize ( const cv::Size& image_size, const cv::Mat& homography_matrix, cv::Size& warped_size ){
+
+    std::vector<cv::Point2f> img_corners(4);
+    img_corners[0] = cv::Point2f ( 0               , 0 );
+    img_corners[1] = cv::Point2f ( image_size.width , 0 );
+    img_corners[2] = cv::Point2f ( 0               , image_size.height );
+    img_corners[3] = cv::Point2f ( image_size.width , image_size.height );
+    std::vector<cv::Point2f> new_img_corners(4);
+
+    perspectiveTransform( img_corners, new_img_corners, homography_matrix);
+
+    warped_size = image_size;
+
+    for (int i = 0 ; i < 4 ; i++){
+        if ( int(ceil(new_img_corners.at(i).x)) > warped_size.width )
+            warped_size.width = int(ceil(new_img_corners.at(i).x));
+        if ( int(ceil(new_img_corners.at(i).y)) > warped_size.height )
+            warped_size.height = int(ceil(new_img_corners.at(i).y));
     }
 
-    //-- Step 5: Find the Homography Matrix.
-    homography_matrix = cv::findHomography( selected_keypoints_image_src, selected_keypoints_image_dst, CV_RANSAC);
+    return checkHomographyConsistency( new_img_corners )
+            && warped_size.width <= 4 * image_size.width
+            && warped_size.height <= 4 * image_size.height;
+}
 
-    return true;
+/**
+ * @brief Function that composes the homography matrix with the translation of a crop area, so the warped image starts
+ *          at the corner of the crop area.
+ *
+ * @param homography_matrix - The homography matrix.
+ * @param crop_area - The crop area.
+ *
+ * @return \c cv::Mat - homography matrix, in double precision, from the image to the crop area.
+ *
+ * @date 17/10/2026
+ */
+static cv::Mat getCropHomography ( const cv::Mat& homography_matrix, const cv::Rect& crop_area ){
+
+    cv::Mat crop_translation = (cv::Mat_<double>(3,3) << 1, 0, -crop_area.x, 0, 1, -crop_area.y, 0, 0, 1);
+    return crop_translation * cv::Mat_<double>(homography_matrix);
 }
 
 /**
@@ -399,47 +386,62 @@ bool findHomographyMatrix(const std::vector<cv::KeyPoint> &keypoints_image_src,
  */
 bool applyHomographyMatrix( const cv::Mat &image_src, const cv::Mat &homography_matrix, cv::Mat &image_result )
 {
-    //-- Get the corners from the imageSrc
-    std::vector<cv::Point2f> img_corners(4);
-    img_corners[0] = cv::Point2f ( 0             , 0);
-    img_corners[1] = cv::Point2f ( image_src.cols , 0 );
-    img_corners[2] = cv::Point2f ( 0             , image_src.rows );
-    img_corners[3] = cv::Point2f ( image_src.cols , image_src.rows );
-    std::vector<cv::Point2f> new_img_corners(4);
+    cv::Size warped_size;
 
-    perspectiveTransform( img_corners, new_img_corners, homography_matrix);
-
-    int height = image_src.rows,
-        width = image_src.cols;
-
-    for (int i = 0 ; i < 4 ; i++){
-        if ( int(ceil(new_img_corners.at(i).x)) > width )
-            width = int(ceil(new_img_corners.at(i).x));
-        if ( int(ceil(new_img_corners.at(i).y)) > height )
-            height = int(ceil(new_img_corners.at(i).y));
-    }
-
-    if ( ! checkHomographyConsistency( new_img_corners )
-         || width > 4 * image_src.cols
-         || height > 4 * image_src.rows ){
+    if ( ! getWarpedSize( image_src.size(), homography_matrix, warped_size ) ){
         // ----------------------------------------------------------------------
         // DEBUG
         if ( DEBUG_HOMOGRAPHY )
             std::cout << "Projecao errada**************************" << std::endl;
         // ----------------------------------------------------------------------
-        image_result = image_src.clone();
+        // As the warp, the copy reuses the buffer of the image_result when it has the same size and type.
+        image_src.copyTo(image_result);
         return false;
     }
 
     // ----------------------------------------------------------------------
     // DEBUG
     if ( DEBUG_HOMOGRAPHY )
-        std::cout<< "height: " << height << std::endl
-                 << "width: " << width << std::endl;
+        std::cout<< "height: " << warped_size.height << std::endl
+                 << "width: " << warped_size.width << std::endl;
     // ----------------------------------------------------------------------
 
     // Use the Homography Matrix to warp the images
-    cv::warpPerspective( image_src, image_result, homography_matrix , cv::Size(width, height) );
+    warpPerspectiveBilinear( image_src, homography_matrix , warped_size, image_result );
+    return true;
+}
+
+/**
+ * @brief Function that apply homography matrix in a given image computing only the pixels of the crop area. The crop
+ *          translation is composed with the homography matrix, so the warp writes the output directly.
+ *
+ * @param image_src - image where the homography matrix will be applied.
+ * @param homography_matrix - homography matrix.
+ * @param crop_area - area of the warped image that is computed. It must be inside the image_src.
+ * @param image_result - object to save the crop area of the image after the application of the homography matrix.
+ *
+ * @return
+ *      \c bool \b true  - if the corner consistency is maintained after application of the homography matrix. \n
+ *      \c bool \b false - if the consistency is not maintained after application of the homography matrix. In this case the imageResult is a copy of the crop area of the imageSrc.
+ *
+ * @date 17/10/2026
+ */
+bool applyHomographyMatrix( const cv::Mat &image_src, const cv::Mat &homography_matrix, const cv::Rect &crop_area, cv::Mat &image_result )
+{
+    cv::Size warped_size;
+
+    // The same projections as the applyHomographyMatrix of the whole image are rejected.
+    if ( ! getWarpedSize( image_src.size(), homography_matrix, warped_size ) ){
+        // ----------------------------------------------------------------------
+        // DEBUG
+        if ( DEBUG_HOMOGRAPHY )
+            std::cout << "Projecao errada**************************" << std::endl;
+        // ----------------------------------------------------------------------
+        image_src(crop_area).copyTo(image_result);
+        return false;
+    }
+
+    warpPerspectiveBilinear( image_src, getCropHomography( homography_matrix, crop_area ) , crop_area.size(), image_result );
     return true;
 }
 
@@ -507,9 +509,93 @@ bool checkHomographyConsistency ( const std::vector<cv::Point2f> new_img_corners
     return cr ;
 }
 
+/**
+ * @brief Function that calculates the loss(%) of the homography transformation in a ROI by warping a white mask. It is
+ *          only used when the warped image can not be described by the quadrilateral of its corners.
+ *
+ * @param image_src - The source image.
+ * @param homography_matrix - The homography matrix.
+ * @param frame_limits - The region of interest (ROI).
+ *
+ * @return \c double - The ratio between non-image area and the whole frame area.
+ *
+ * @author Washington Luis de Souza Ramos
+ * @date 14/04/2016
+ */
+static double getMaskAreaRatio ( const cv::Mat& image_src, const cv::Mat& homography_matrix, const cv::Rect& frame_limits ){
+
+    cv::Size warped_size;
+
+    // The image is not warped, so it covers its own area.
+    if ( ! getWarpedSize( image_src.size(), homography_matrix, warped_size ) )
+        return 0.0;
+
+    // The mask has a single channel, which is the gray of the white mask of the image type. Only the ROI of the warped
+    // mask is computed, by translating the homography, since the intersection with the frame mask is the ROI. The
+    // white mask is not read, only its size.
+    ScratchArena::Buffer intersection_mask ( frame_limits.size() , CV_8UC1 ),
+            intersection_mask_bw ( frame_limits.size() , CV_8UC1 );
+
+    warpPerspectiveMask( image_src.size(), getCropHomography( homography_matrix, frame_limits ), frame_limits.size(), intersection_mask.mat );
+
+    // Transform it to binary and invert it. White on black is needed.
+    cv::threshold(intersection_mask.mat, intersection_mask_bw.mat, 1, 255, CV_THRESH_BINARY_INV | CV_THRESH_OTSU);
+
+   return cv::countNonZero(intersection_mask_bw.mat)/double(frame_limits.height*frame_limits.width);
+}
+
+/**
+ * @brief Function that finds the quadrilateral covered by the image after the application of the homography matrix, with
+ *          the same rules of the applyHomographyMatrix: if the corner consistency is not maintained the image is kept as is.
+ *          The corners are taken at the borders of the pixels, so the area inside a ROI matches its number of pixels.
+ *
+ * @param image_size - The size of the source image.
+ * @param homography_matrix - The homography matrix.
+ * @param polygon - object to save the corners of the covered area, in the order top-left, top-right, bottom-right, bottom-left.
+ *
+ * @return
+ *      \c bool \b true  - if the covered area is the quadrilateral. \n
+ *      \c bool \b false - if some corner is projected to the infinity or behind the camera.
+ *
+ * @date 17/10/2026
+ */
+static bool getCoveredPolygon ( const cv::Size& image_size, const cv::Mat& homography_matrix, std::vector<cv::Point2d>& polygon ){
+
+    polygon.resize(4);
+    polygon[0] = cv::Point2d ( 0               , 0 );
+    polygon[1] = cv::Point2d ( image_size.width , 0 );
+    polygon[2] = cv::Point2d ( image_size.width , image_size.height );
+    polygon[3] = cv::Point2d ( 0               , image_size.height );
+
+    // The image is not warped, so it covers its own area.
+    cv::Size warped_size;
+    if ( ! getWarpedSize( image_size, homography_matrix, warped_size ) )
+        return true;
+
+    cv::Mat homography;
+    homography_matrix.convertTo(homography, CV_64F);
+    const double *h = homography.ptr<double>();
+
+    for (int i = 0 ; i < 4 ; i++){
+        // The pixel (x,y) spans from x-0.5 to x+0.5, so the borders of the pixels are mapped.
+        double x = polygon[i].x - 0.5,
+                y = polygon[i].y - 0.5,
+                w = h[6] * x + h[7] * y + h[8];
+
+        if ( w <= DBL_EPSILON )
+            return false;
+
+        polygon[i].x = (h[0] * x + h[1] * y + h[2]) / w + 0.5;
+        polygon[i].y = (h[3] * x + h[4] * y + h[5]) / w + 0.5;
+    }
+
+    return true;
+}
+
 /**
  * @brief Function that calculates the loss(%) of the homography transformation in a ROI. It returns the
- *          ratio between the non-image area and the frame_limits area.
+ *          ratio between the non-image area and the frame_limits area. The area is computed by clipping the
+ *          warped image corners by the ROI, without warping any image.
  *
  * @param image_src - The source image.
  * @param homography_matrix - The homography matrix.
@@ -522,23 +608,25 @@ bool checkHomographyConsistency ( const std::vector<cv::Point2f> new_img_corners
  */
 double getAreaRatio ( const cv::Mat& image_src, const cv::Mat& homography_matrix, const cv::Rect& frame_limits ){
 
-    cv::Mat homography_mask = cv::Mat(image_src.rows, image_src.cols, image_src.type(), cv::Scalar::all(255)),
-            frame_mask,
-            intersection_mask,
-            homography_mask_result;
+    std::vector<cv::Point2d> polygon;
 
-    applyHomographyMatrix(homography_mask, homography_matrix, homography_mask_result);
-    frame_mask = cv::Mat::zeros(homography_mask_result.rows, homography_mask_result.cols, image_src.type());
-    frame_mask(frame_limits) = cv::Scalar::all(255);
-    intersection_mask = frame_mask & homography_mask_result;
+    if ( !getCoveredPolygon(image_src.size(), homography_matrix, polygon) )
+        return getMaskAreaRatio(image_src, homography_matrix, frame_limits);
 
-    cv::cvtColor(intersection_mask, intersection_mask, CV_BGR2GRAY);
+    double frame_area = double(frame_limits.height*frame_limits.width),
+            area_ratio = std::max(0.0, 1 - polygonAreaInsideRect(polygon, frame_limits)/frame_area);
 
-    // Transform it to binary and invert it. White on black is needed.
-    cv::Mat intersection_mask_bw;
-    cv::threshold(intersection_mask(frame_limits), intersection_mask_bw, 1, 255, CV_THRESH_BINARY_INV | CV_THRESH_OTSU);
+    // ----------------------------------------------------------------------
+    // DEBUG
+    // Compares the decision with the one given by the warped mask.
+    if ( DEBUG_COVERAGE ) {
+        double mask_area_ratio = getMaskAreaRatio(image_src, homography_matrix, frame_limits);
+        if ( (area_ratio <= MAXIMUM_AREA_ALLOWED) != (mask_area_ratio <= MAXIMUM_AREA_ALLOWED) )
+            std::cout << "Coverage mismatch: polygon " << area_ratio << " | mask " << mask_area_ratio << std::endl;
+    }
+    // ----------------------------------------------------------------------
 
-   return cv::countNonZero(intersection_mask_bw)/double(frame_limits.height*frame_limits.width);
+    return area_ratio;
 }
 
 /**
@@ -555,36 +643,10 @@ double getAreaRatio ( const cv::Mat& image_src, const cv::Mat& homography_matrix
  */
 HomogCoverage getHomogCoverage ( const cv::Mat& image_src, const cv::Mat& homography_matrix, const cv::Rect& drop_area, const cv::Rect& crop_area){
 
-    cv::Mat homography_mask = cv::Mat(image_src.rows, image_src.cols, image_src.type(), cv::Scalar::all(255)),
-            frame_mask_da,//Mask for the drop area (da)
-            frame_mask_ca,//Mask for the crop area (ca)
-            intersection_mask_da,
-            intersection_mask_ca,
-            homography_mask_result;
-
-    applyHomographyMatrix(homography_mask, homography_matrix, homography_mask_result);
-
-    frame_mask_da = cv::Mat::zeros(homography_mask_result.rows, homography_mask_result.cols, image_src.type());
-    frame_mask_ca = cv::Mat::zeros(homography_mask_result.rows, homography_mask_result.cols, image_src.type());
-
-    frame_mask_da(drop_area) = cv::Scalar::all(255);
-    frame_mask_ca(crop_area) = cv::Scalar::all(255);
-
-    intersection_mask_da = frame_mask_da & homography_mask_result;
-    intersection_mask_ca = frame_mask_ca & homography_mask_result;
-
-    cv::cvtColor(intersection_mask_da, intersection_mask_da, CV_BGR2GRAY);
-    cv::cvtColor(intersection_mask_ca, intersection_mask_ca, CV_BGR2GRAY);
-
-    // Transform it to binary and invert it. White on black is needed.
-    cv::Mat intersection_mask_bw;
-
-    cv::threshold(intersection_mask_ca(crop_area), intersection_mask_bw, 1, 255, CV_THRESH_BINARY_INV | CV_THRESH_OTSU);
-    if(cv::countNonZero(intersection_mask_bw)/double(crop_area.height*crop_area.width) <= MAXIMUM_AREA_ALLOWED)
+    if( getAreaRatio(image_src, homography_matrix, crop_area) <= MAXIMUM_AREA_ALLOWED )
         return CROP_AREA;
 
-    cv::threshold(intersection_mask_da(drop_area), intersection_mask_bw, 1, 255, CV_THRESH_BINARY_INV | CV_THRESH_OTSU);
-    if(cv::countNonZero(intersection_mask_bw)/double(drop_area.height*drop_area.width) <= MAXIMUM_AREA_ALLOWED)
+    if( getAreaRatio(image_src, homography_matrix, drop_area) <= MAXIMUM_AREA_ALLOWED )
         return DROP_AREA;
 
     else
@@ -603,12 +665,6 @@ HomogCoverage getHomogCoverage ( const cv::Mat& image_src, const cv::Mat& homogr
  */
 void getKeypointsAndDescriptors( const cv::Mat &image, std::vector< cv::KeyPoint > &keypoints, cv::Mat &descriptors )
 {
-    //First steps for finding the homography matrix
-    //-- Step 1: Detect the keypoints using SURF Detector.
-    cv::SurfFeatureDetector detector( MIN_HESSIAN );
-    detector.detect( image, keypoints );
-
-    //-- Step 2: Calculate descriptors (feature vectors).
-    cv::SurfDescriptorExtractor extractor;
-    extractor.compute( image, keypoints, descriptors );
+    //First steps for finding the homography matrix, with the feature method of the experiment (SURF or ORB).
+    FeatureExtractor::detectAndCompute( image, keypoints, descriptors );
 }
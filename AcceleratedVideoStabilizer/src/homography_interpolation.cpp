@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file homography_interpolation.cpp
+ *
+ * Fractional powers of homography matrices, used to find the intermediate homography between the masters.
+ *
+ */
+
+#include <cmath>
+
+#include "headers/homography_interpolation.h"
+
+/** Relative distance below which the eigenvalues are treated as equal in the second order divided difference. */
+#define CONFLUENT_EIGENVALUES_TOLERANCE 1E-4
+
+/**
+ * @brief Function that computes exp(z) - 1 without losing precision when z is close to zero.
+ *
+ * @param z - complex exponent.
+ *
+ * @return \c std::complex<double> - exp(z) - 1.
+ *
+ * @date 17/10/2026
+ */
+static std::complex<double> expm1Complex ( const std::complex<double> &z ) {
+    double half_sin = std::sin(z.imag() / 2);
+    return std::complex<double>( std::expm1(z.real()) * std::cos(z.imag()) - 2 * half_sin * half_sin ,
+                                 std::exp(z.real()) * std::sin(z.imag()) );
+}
+
+/**
+ * @brief Function that computes the first order divided difference of f(x) = x^a on two eigenvalues, given by their
+ *          logarithms. It is written as x^(a-1) (exp(a u) - 1) / (exp(u) - 1), with u = log(y) - log(x), which keeps
+ *          the precision when the eigenvalues are close and tends to the derivative a x^(a-1) when they are equal.
+ *
+ * @param exponent - the exponent a.
+ * @param log_x - logarithm of the first eigenvalue.
+ * @param log_y - logarithm of the second eigenvalue.
+ *
+ * @return \c std::complex<double> - f[x,y].
+ *
+ * @date 17/10/2026
+ */
+static std::complex<double> powerDividedDifference ( const double exponent, const std::complex<double> &log_x, const std::complex<double> &log_y ) {
+    std::complex<double> u = log_y - log_x,
+            scale = std::exp((exponent - 1) * log_x);
+
+    if ( u == std::complex<double>(0, 0) )
+        return exponent * scale;
+
+    return scale * expm1Complex(exponent * u) / expm1Complex(u);
+}
+
+/**
+ * @brief Function that computes the second order divided difference of f(x) = x^a on the three eigenvalues. The two most
+ *          distant eigenvalues are used in the denominator and, when all of them are close, the half of the second
+ *          derivative at their mean is used instead.
+ *
+ * @param exponent - the exponent a.
+ * @param eigenvalues - the three eigenvalues.
+ * @param log_eigenvalues - their logarithms.
+ *
+ * @return \c std::complex<double> - f[x0,x1,x2].
+ *
+ * @date 17/10/2026
+ */
+static std::complex<double> powerSecondDividedDifference ( const double exponent, const std::complex<double> eigenvalues[3],
+                                                           const std::complex<double> log_eigenvalues[3] ) {
+    int first = 0, last = 1;
+    double scale = std::max(std::abs(eigenvalues[0]), std::max(std::abs(eigenvalues[1]), std::abs(eigenvalues[2])));
+
+    for ( int i = 0 ; i < 3 ; i++ )
+        for ( int j = i + 1 ; j < 3 ; j++ )
+            if ( std::abs(eigenvalues[j] - eigenvalues[i]) > std::abs(eigenvalues[last] - eigenvalues[first]) ) {
+                first = i;
+                last = j;
+            }
+
+    if ( std::abs(eigenvalues[last] - eigenvalues[first]) < CONFLUENT_EIGENVALUES_TOLERANCE * scale ) {
+        std::complex<double> mean = (eigenvalues[0] + eigenvalues[1] + eigenvalues[2]) / 3.0;
+        return exponent * (exponent - 1) / 2 * std::exp((exponent - 2) * std::log(mean));
+    }
+
+    int middle = 3 - first - last;
+    return ( powerDividedDifference(exponent, log_eigenvalues[middle], log_eigenvalues[last])
+             - powerDividedDifference(exponent, log_eigenvalues[first], log_eigenvalues[middle]) )
+            / (eigenvalues[last] - eigenvalues[first]);
+}
+
+HomographyPower::HomographyPower ( const cv::Mat &homography_matrix ) :
+    valid(false)
+{
+    if ( homography_matrix.rows != 3 || homography_matrix.cols != 3 )
+        return;
+
+    cv::Mat homography;
+    homography_matrix.convertTo(homography, CV_64F);
+
+    arma::cx_mat matrix(3, 3), triangular_matrix;
+    for ( int i = 0 ; i < 3 ; i++ )
+        for ( int j = 0 ; j < 3 ; j++ )
+            matrix(i, j) = std::complex<double>(homography.at<double>(i, j), 0);
+
+    if ( !arma::schur(schur_vectors, triangular_matrix, matrix) )
+        return;
+
+    for ( int i = 0 ; i < 3 ; i++ )
+        for ( int j = 0 ; j < 3 ; j++ )
+            triangular[i][j] = triangular_matrix(i, j);
+
+    // A singular matrix has no logarithm, so it can not be interpolated.
+    double scale = std::abs(triangular[0][0]) + std::abs(triangular[1][1]) + std::abs(triangular[2][2]);
+    for ( int i = 0 ; i < 3 ; i++ ) {
+        if ( !(std::abs(triangular[i][i]) > 1E-12 * scale) )
+            return;
+        log_eigenvalues[i] = std::log(triangular[i][i]);
+    }
+
+    valid = true;
+}
+
+bool HomographyPower::isValid ( void ) const {
+    return valid;
+}
+
+bool HomographyPower::pow ( const int numerator , const int denominator , cv::Mat &matrix_result ) const {
+
+    if ( !valid || denominator == 0 )
+        return false;
+
+    const double exponent = double(numerator) / double(denominator);
+
+    std::complex<double> eigenvalues[3] = { triangular[0][0], triangular[1][1], triangular[2][2] };
+
+    // f(T) of the upper triangular T: the diagonal holds f of the eigenvalues and the other entries are sums, over the
+    // paths i -> j above the diagonal, of the products of the entries of T times the divided differences of f.
+    arma::cx_mat triangular_power(3, 3);
+    triangular_power.zeros();
+    for ( int i = 0 ; i < 3 ; i++ )
+        triangular_power(i, i) = std::exp(exponent * log_eigenvalues[i]);
+
+    triangular_power(0, 1) = triangular[0][1] * powerDividedDifference(exponent, log_eigenvalues[0], log_eigenvalues[1]);
+    triangular_power(1, 2) = triangular[1][2] * powerDividedDifference(exponent, log_eigenvalues[1], log_eigenvalues[2]);
+    triangular_power(0, 2) = triangular[0][2] * powerDividedDifference(exponent, log_eigenvalues[0], log_eigenvalues[2])
+            + triangular[0][1] * triangular[1][2] * powerSecondDividedDifference(exponent, eigenvalues, log_eigenvalues);
+
+    arma::cx_mat power = schur_vectors * triangular_power * schur_vectors.t();
+
+    matrix_result.create(3, 3, CV_64F);
+    for ( int i = 0 ; i < 3 ; i++ )
+        for ( int j = 0 ; j < 3 ; j++ )
+            matrix_result.at<double>(i, j) = std::real(power(i, j));
+
+    return true;
+}
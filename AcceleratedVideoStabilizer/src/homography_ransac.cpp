@@ -0,0 +1,578 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file homography_ransac.cpp
+ *
+ * RANSAC estimation of the homography between matched keypoints, with PROSAC sampling and SIMD scoring of the hypotheses.
+ *
+ */
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#include <opencv2/calib3d/calib3d.hpp>
+
+#include "headers/homography_ransac.h"
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define HOMOGRAPHY_RANSAC_X86           1
+#include <immintrin.h>
+#else
+#define HOMOGRAPHY_RANSAC_X86           0
+#endif
+
+/** Number of points of the minimal sample of a homography. */
+#define RANSAC_SAMPLE_SIZE              4
+
+/** Number of points scored between the checks of whether the hypothesis can still beat the best consensus. */
+#define RANSAC_SCORE_BLOCK              64
+
+/** Instructions used to score the hypotheses. */
+enum RansacPath { RANSAC_PATH_SCALAR, RANSAC_PATH_SSE2, RANSAC_PATH_AVX };
+
+/**
+ * @brief Function that chooses the fastest path supported by the processor.
+ *
+ * @return \c RansacPath - the path.
+ *
+ * @date 17/10/2026
+ */
+static RansacPath getBestRansacPath ( void ){
+#if HOMOGRAPHY_RANSAC_X86
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports("avx") )
+        return RANSAC_PATH_AVX;
+    if ( __builtin_cpu_supports("sse2") )
+        return RANSAC_PATH_SSE2;
+#endif
+    return RANSAC_PATH_SCALAR;
+}
+
+static const RansacPath best_ransac_path = getBestRansacPath();
+
+/**
+ * @brief Function that checks if the reprojection error of a point is inside the threshold. The SIMD paths compute the
+ *          same operations in the same order, so they give the same result.
+ *
+ * @param model - homography matrix, by rows.
+ * @param x - column of the source point.
+ * @param y - row of the source point.
+ * @param u - column of the destination point.
+ * @param v - row of the destination point.
+ * @param threshold - squared reprojection threshold.
+ *
+ * @return \c bool - true if the point is an inlier of the model.
+ *
+ * @date 17/10/2026
+ */
+static inline bool isInlier ( const float *model, const float x, const float y, const float u, const float v, const float threshold ){
+    const float w = 1.f / ( model[6] * x + model[7] * y + model[8] ),
+            dx = ( model[0] * x + model[1] * y + model[2] ) * w - u,
+            dy = ( model[3] * x + model[4] * y + model[5] ) * w - v;
+
+    return dx * dx + dy * dy <= threshold;
+}
+
+/**
+ * @brief Function that counts the inliers of a model in a range of the points.
+ *
+ * @param model - homography matrix, by rows.
+ * @param src_x - columns of the source points.
+ * @param src_y - rows of the source points.
+ * @param dst_x - columns of the destination points.
+ * @param dst_y - rows of the destination points.
+ * @param begin - index of the first point.
+ * @param end - index after the last point.
+ * @param threshold - squared reprojection threshold.
+ *
+ * @return \c int - the number of inliers.
+ *
+ * @date 17/10/2026
+ */
+static int countInliersScalar ( const float *model, const float *src_x, const float *src_y, const float *dst_x, const float *dst_y,
+                                const int begin, const int end, const float threshold ){
+    int count = 0;
+    for ( int i = begin ; i < end ; i++ )
+        count += isInlier(model, src_x[i], src_y[i], dst_x[i], dst_y[i], threshold);
+    return count;
+}
+
+#if HOMOGRAPHY_RANSAC_X86
+/**
+ * @brief Function that counts the inliers of a model in a range of the points, four at a time with SSE2.
+ *
+ * @param model - homography matrix, by rows.
+ * @param src_x - columns of the source points.
+ * @param src_y - rows of the source points.
+ * @param dst_x - columns of the destination points.
+ * @param dst_y - rows of the destination points.
+ * @param begin - index of the first point.
+ * @param end - index after the last point.
+ * @param threshold - squared reprojection threshold.
+ *
+ * @return \c int - the number of inliers.
+ *
+ * @date 17/10/2026
+ */
+__attribute__((target("sse2")))
+static int countInliersSSE2 ( const float *model, const float *src_x, const float *src_y, const float *dst_x, const float *dst_y,
+                              const int begin, const int end, const float threshold ){
+    const __m128 h0 = _mm_set1_ps(model[0]), h1 = _mm_set1_ps(model[1]), h2 = _mm_set1_ps(model[2]),
+            h3 = _mm_set1_ps(model[3]), h4 = _mm_set1_ps(model[4]), h5 = _mm_set1_ps(model[5]),
+            h6 = _mm_set1_ps(model[6]), h7 = _mm_set1_ps(model[7]), h8 = _mm_set1_ps(model[8]),
+            one = _mm_set1_ps(1.f), limit = _mm_set1_ps(threshold);
+
+    int count = 0, i = begin;
+    for ( ; i + 4 <= end ; i += 4 ) {
+        const __m128 x = _mm_loadu_ps(src_x + i), y = _mm_loadu_ps(src_y + i),
+                w = _mm_div_ps(one, _mm_add_ps(_mm_add_ps(_mm_mul_ps(h6, x), _mm_mul_ps(h7, y)), h8)),
+                dx = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(h0, x), _mm_mul_ps(h1, y)), h2), w), _mm_loadu_ps(dst_x + i)),
+                dy = _mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(h3, x), _mm_mul_ps(h4, y)), h5), w), _mm_loadu_ps(dst_y + i)),
+                error = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+        count += __builtin_popcount(_mm_movemask_ps(_mm_cmple_ps(error, limit)));
+    }
+
+    return count + countInliersScalar(model, src_x, src_y, dst_x, dst_y, i, end, threshold);
+}
+
+/**
+ * @brief Function that counts the inliers of a model in a range of the points, eight at a time with AVX.
+ *
+ * @param model - homography matrix, by rows.
+ * @param src_x - columns of the source points.
+ * @param src_y - rows of the source points.
+ * @param dst_x - columns of the destination points.
+ * @param dst_y - rows of the destination points.
+ * @param begin - index of the first point.
+ * @param end - index after the last point.
+ * @param threshold - squared reprojection threshold.
+ *
+ * @return \c int - the number of inliers.
+ *
+ * @date 17/10/2026
+ */
+__attribute__((target("avx")))
+static int countInliersAVX ( const float *model, const float *src_x, const float *src_y, const float *dst_x, const float *dst_y,
+                             const int begin, const int end, const float threshold ){
+    const __m256 h0 = _mm256_set1_ps(model[0]), h1 = _mm256_set1_ps(model[1]), h2 = _mm256_set1_ps(model[2]),
+            h3 = _mm256_set1_ps(model[3]), h4 = _mm256_set1_ps(model[4]), h5 = _mm256_set1_ps(model[5]),
+            h6 = _mm256_set1_ps(model[6]), h7 = _mm256_set1_ps(model[7]), h8 = _mm256_set1_ps(model[8]),
+            one = _mm256_set1_ps(1.f), limit = _mm256_set1_ps(threshold);
+
+    int count = 0, i = begin;
+    for ( ; i + 8 <= end ; i += 8 ) {
+        const __m256 x = _mm256_loadu_ps(src_x + i), y = _mm256_loadu_ps(src_y + i),
+                w = _mm256_div_ps(one, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(h6, x), _mm256_mul_ps(h7, y)), h8)),
+                dx = _mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(h0, x), _mm256_mul_ps(h1, y)), h2), w), _mm256_loadu_ps(dst_x + i)),
+                dy = _mm256_sub_ps(_mm256_mul_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(h3, x), _mm256_mul_ps(h4, y)), h5), w), _mm256_loadu_ps(dst_y + i)),
+                error = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+        count += __builtin_popcount(_mm256_movemask_ps(_mm256_cmp_ps(error, limit, _CMP_LE_OQ)));
+    }
+
+    return count + countInliersScalar(model, src_x, src_y, dst_x, dst_y, i, end, threshold);
+}
+#endif
+
+/**
+ * @brief Function that counts the inliers of a model in a range of the points with the fastest path.
+ *
+ * @date 17/10/2026
+ */
+static inline int countInliersRange ( const float *model, const float *src_x, const float *src_y, const float *dst_x, const float *dst_y,
+                                      const int begin, const int end, const float threshold ){
+#if HOMOGRAPHY_RANSAC_X86
+    if ( best_ransac_path == RANSAC_PATH_AVX )
+        return countInliersAVX(model, src_x, src_y, dst_x, dst_y, begin, end, threshold);
+    if ( best_ransac_path == RANSAC_PATH_SSE2 )
+        return countInliersSSE2(model, src_x, src_y, dst_x, dst_y, begin, end, threshold);
+#endif
+    return countInliersScalar(model, src_x, src_y, dst_x, dst_y, begin, end, threshold);
+}
+
+/**
+ * @brief Function that scores a hypothesis, stopping as soon as it can not have more inliers than the best consensus.
+ *
+ * @param model - homography matrix, by rows.
+ * @param src_x - columns of the source points.
+ * @param src_y - rows of the source points.
+ * @param dst_x - columns of the destination points.
+ * @param dst_y - rows of the destination points.
+ * @param num_points - number of points.
+ * @param threshold - squared reprojection threshold.
+ * @param best_count - number of inliers of the best consensus.
+ *
+ * @return \c int - the number of inliers, or a number not greater than the best_count if the scoring stopped.
+ *
+ * @date 17/10/2026
+ */
+static int scoreHypothesis ( const float *model, const float *src_x, const float *src_y, const float *dst_x, const float *dst_y,
+                             const int num_points, const float threshold, const int best_count ){
+    int count = 0;
+    for ( int begin = 0 ; begin < num_points ; begin += RANSAC_SCORE_BLOCK ) {
+        const int end = std::min(begin + RANSAC_SCORE_BLOCK, num_points);
+        count += countInliersRange(model, src_x, src_y, dst_x, dst_y, begin, end, threshold);
+        if ( count + num_points - end <= best_count )
+            break;
+    }
+    return count;
+}
+
+/**
+ * @brief Function that checks if three points are collinear, as the cv::findHomography.
+ *
+ * @date 17/10/2026
+ */
+static inline bool areCollinear ( const double x0, const double y0, const double x1, const double y1, const double x2, const double y2 ){
+    const double dx1 = x1 - x0, dy1 = y1 - y0,
+            dx2 = x2 - x0, dy2 = y2 - y0;
+    return std::fabs(dx2*dy1 - dy2*dx1) <= FLT_EPSILON * ( std::fabs(dx1) + std::fabs(dy1) + std::fabs(dx2) + std::fabs(dy2) );
+}
+
+/**
+ * @brief Function that checks if a sample can give a homography: no three points are collinear, and the triangles of
+ *          the source and destination points have the same orientation.
+ *
+ * @param x - columns of the source and, after them, of the destination points of the sample.
+ * @param y - rows of the source and, after them, of the destination points of the sample.
+ *
+ * @return \c bool - true if the sample is degenerate.
+ *
+ * @date 17/10/2026
+ */
+static bool isSampleDegenerate ( const double *x, const double *y ){
+    static const int triangles[4][3] = { {0, 1, 2}, {1, 2, 3}, {0, 2, 3}, {0, 1, 3} };
+
+    int negative = 0;
+    for ( int t = 0 ; t < 4 ; t++ ) {
+        const int a = triangles[t][0], b = triangles[t][1], c = triangles[t][2];
+
+        if ( areCollinear(x[a], y[a], x[b], y[b], x[c], y[c]) ||
+             areCollinear(x[4+a], y[4+a], x[4+b], y[4+b], x[4+c], y[4+c]) )
+            return true;
+
+        const double area_src = ( x[b] - x[a] ) * ( y[c] - y[a] ) - ( y[b] - y[a] ) * ( x[c] - x[a] ),
+                area_dst = ( x[4+b] - x[4+a] ) * ( y[4+c] - y[4+a] ) - ( y[4+b] - y[4+a] ) * ( x[4+c] - x[4+a] );
+        negative += ( area_src * area_dst < 0 );
+    }
+
+    return negative != 0 && negative != 4;
+}
+
+/**
+ * @brief Function that computes the homography of a sample of four points, solving the normalized DLT with the last
+ *          element fixed to 1.
+ *
+ * @param x - columns of the source and, after them, of the destination points of the sample.
+ * @param y - rows of the source and, after them, of the destination points of the sample.
+ * @param model - object to save the homography matrix, by rows.
+ *
+ * @return \c bool - false if the system is singular.
+ *
+ * @date 17/10/2026
+ */
+static bool getSampleHomography ( const double *x, const double *y, double *model ){
+    // The points are moved to their centroid and scaled to a mean distance of sqrt(2).
+    double center_x[2] = { 0, 0 }, center_y[2] = { 0, 0 }, scale[2] = { 0, 0 };
+    for ( int s = 0 ; s < 2 ; s++ ) {
+        for ( int i = 0 ; i < RANSAC_SAMPLE_SIZE ; i++ ) {
+            center_x[s] += x[4*s+i] / RANSAC_SAMPLE_SIZE;
+            center_y[s] += y[4*s+i] / RANSAC_SAMPLE_SIZE;
+        }
+        for ( int i = 0 ; i < RANSAC_SAMPLE_SIZE ; i++ )
+            scale[s] += std::sqrt( ( x[4*s+i] - center_x[s] ) * ( x[4*s+i] - center_x[s] ) + ( y[4*s+i] - center_y[s] ) * ( y[4*s+i] - center_y[s] ) ) / RANSAC_SAMPLE_SIZE;
+        if ( scale[s] < DBL_EPSILON )
+            return false;
+        scale[s] = std::sqrt(2.0) / scale[s];
+    }
+
+    double A[8][9];
+    for ( int i = 0 ; i < RANSAC_SAMPLE_SIZE ; i++ ) {
+        const double X = ( x[i] - center_x[0] ) * scale[0], Y = ( y[i] - center_y[0] ) * scale[0],
+                U = ( x[4+i] - center_x[1] ) * scale[1], V = ( y[4+i] - center_y[1] ) * scale[1];
+
+        const double row_u[9] = { X, Y, 1, 0, 0, 0, -U*X, -U*Y, U },
+                row_v[9] = { 0, 0, 0, X, Y, 1, -V*X, -V*Y, V };
+        std::copy(row_u, row_u + 9, A[2*i]);
+        std::copy(row_v, row_v + 9, A[2*i+1]);
+    }
+
+    // Gaussian elimination with partial pivoting of the 8x8 system, whose right side is the last column.
+    for ( int c = 0 ; c < 8 ; c++ ) {
+        int pivot = c;
+        for ( int r = c+1 ; r < 8 ; r++ )
+            if ( std::fabs(A[r][c]) > std::fabs(A[pivot][c]) )
+                pivot = r;
+        if ( std::fabs(A[pivot][c]) < 1e-10 )
+            return false;
+        if ( pivot != c )
+            std::swap_ranges(A[c], A[c] + 9, A[pivot]);
+
+        for ( int r = c+1 ; r < 8 ; r++ ) {
+            const double factor = A[r][c] / A[c][c];
+            for ( int k = c ; k < 9 ; k++ )
+                A[r][k] -= factor * A[c][k];
+        }
+    }
+
+    double h[9];
+    h[8] = 1;
+    for ( int r = 7 ; r >= 0 ; r-- ) {
+        double sum = A[r][8];
+        for ( int k = r+1 ; k < 8 ; k++ )
+            sum -= A[r][k] * h[k];
+        h[r] = sum / A[r][r];
+    }
+
+    // H = T_dst^-1 * Hn * T_src, where T scales the points after moving them to the centroid.
+    const double s = scale[0], cx = center_x[0], cy = center_y[0],
+            inv = 1.0 / scale[1], ux = center_x[1], uy = center_y[1];
+    double normalized_src[9];
+    for ( int r = 0 ; r < 3 ; r++ ) {
+        normalized_src[3*r+0] = h[3*r+0] * s;
+        normalized_src[3*r+1] = h[3*r+1] * s;
+        normalized_src[3*r+2] = h[3*r+2] - h[3*r+0] * s * cx - h[3*r+1] * s * cy;
+    }
+    for ( int c = 0 ; c < 3 ; c++ ) {
+        model[c] = inv * normalized_src[c] + ux * normalized_src[6+c];
+        model[3+c] = inv * normalized_src[3+c] + uy * normalized_src[6+c];
+        model[6+c] = normalized_src[6+c];
+    }
+
+    if ( std::fabs(model[8]) < DBL_EPSILON )
+        return false;
+    for ( int k = 0 ; k < 9 ; k++ )
+        model[k] /= model[8];
+
+    return true;
+}
+
+/**
+ * @brief Function that updates the number of iterations given the inlier ratio of the best consensus, as the cv::findHomography.
+ *
+ * @param inlier_ratio - ratio of inliers of the best consensus.
+ * @param max_iterations - current number of iterations.
+ *
+ * @return \c int - the number of iterations.
+ *
+ * @date 17/10/2026
+ */
+static int getRansacIterations ( const double inlier_ratio, const int max_iterations ){
+    const double num = std::log( std::max(1.0 - RANSAC_CONFIDENCE, DBL_MIN) ),
+            denom_base = 1.0 - std::pow(inlier_ratio, RANSAC_SAMPLE_SIZE);
+
+    if ( denom_base < DBL_MIN )
+        return 0;
+
+    const double denom = std::log(denom_base);
+    if ( denom >= 0 || -num >= max_iterations * ( -denom ) )
+        return max_iterations;
+
+    return cvRound(num / denom);
+}
+
+/**
+ * @brief Function that draws the PROSAC sample of an iteration. While the iterations expected for the n best matches
+ *          are not done, the n-th match is always in the sample, with the others drawn from the n-1 best ones. After
+ *          them, which only happens when n can not grow anymore, the sample is drawn uniformly from the n best matches.
+ *
+ * @param rng - random number generator.
+ * @param t - number of the iteration, from 1.
+ * @param n - number of best matches the sample is drawn from.
+ * @param T_n_prime - iteration up to which the n-th match is in the sample.
+ * @param sample - object to save the positions of the matches of the sample, in the order of their distances.
+ *
+ * @date 17/10/2026
+ */
+static void drawProsacSample ( cv::RNG &rng, const int t, const int n, const int T_n_prime, int *sample ){
+    int num_random = RANSAC_SAMPLE_SIZE,
+            range = n;
+    if ( t <= T_n_prime ) {
+        sample[RANSAC_SAMPLE_SIZE-1] = n-1;
+        num_random = RANSAC_SAMPLE_SIZE-1;
+        range = n-1;
+    }
+
+    for ( int i = 0 ; i < num_random ; i++ ) {
+        bool repeated;
+        do {
+            sample[i] = rng.uniform(0, range);
+            repeated = false;
+            for ( int j = 0 ; j < i ; j++ )
+                repeated = repeated || sample[j] == sample[i];
+        } while ( repeated );
+    }
+}
+
+HomographyRansac& HomographyRansac::getEstimator ( void )
+{
+    static thread_local HomographyRansac estimator;
+    return estimator;
+}
+
+std::vector<cv::DMatch>& HomographyRansac::getMatchBuffer ( void )
+{
+    return match_buffer;
+}
+
+void HomographyRansac::setPoints ( const std::vector<cv::KeyPoint> &keypoints_src , const std::vector<cv::KeyPoint> &keypoints_dst ,
+                                   const std::vector<cv::DMatch> &matches )
+{
+    const int num_points = int(matches.size());
+
+    order.resize(num_points);
+    for ( int i = 0 ; i < num_points ; i++ )
+        order[i] = i;
+
+    // PROSAC draws the samples from the best matches first. Ties keep their order, so the result is deterministic.
+    std::stable_sort(order.begin(), order.end(), [&]( const int a , const int b ) {
+        return matches[a].distance < matches[b].distance;
+    } );
+
+    src_x.resize(num_points);
+    src_y.resize(num_points);
+    dst_x.resize(num_points);
+    dst_y.resize(num_points);
+
+    for ( int i = 0 ; i < num_points ; i++ ) {
+        const cv::DMatch &match = matches[order[i]];
+        src_x[i] = keypoints_src[match.queryIdx].pt.x;
+        src_y[i] = keypoints_src[match.queryIdx].pt.y;
+        dst_x[i] = keypoints_dst[match.trainIdx].pt.x;
+        dst_y[i] = keypoints_dst[match.trainIdx].pt.y;
+    }
+}
+
+int HomographyRansac::findConsensus ( const int stop_inliers )
+{
+    const int num_points = int(order.size());
+    if ( num_points < RANSAC_SAMPLE_SIZE )
+        return 0;
+
+    const float threshold = float(RANSAC_REPROJECTION_THRESHOLD * RANSAC_REPROJECTION_THRESHOLD);
+
+    // The same seed of the cv::RNG in each call, so the result does not depend on the previous calls of the thread.
+    cv::RNG rng;
+
+    int best_count = 0,
+            max_iterations = RANSAC_MAX_ITERATIONS;
+
+    // PROSAC: the samples are drawn from the n best matches, and n grows as the iterations expected to find a
+    // consensus among them are done. Each new n-th match is in all the samples up to T'n. Once n reaches the number
+    // of points and T'n is passed, the samples are uniform, as the usual RANSAC.
+    int n = RANSAC_SAMPLE_SIZE,
+            T_n_prime = 1;
+    double T_n = RANSAC_MAX_ITERATIONS;
+    for ( int i = 0 ; i < RANSAC_SAMPLE_SIZE ; i++ )
+        T_n *= double(n - i) / double(num_points - i);
+
+    for ( int t = 1 ; t <= max_iterations ; t++ ) {
+
+        if ( t > T_n_prime && n < num_points ) {
+            const double T_next = T_n * ( n + 1 ) / ( n + 1 - RANSAC_SAMPLE_SIZE );
+            T_n_prime += int(std::ceil(T_next - T_n));
+            T_n = T_next;
+            n++;
+        }
+
+        int sample[RANSAC_SAMPLE_SIZE];
+        drawProsacSample(rng, t, n, T_n_prime, sample);
+
+        double x[2*RANSAC_SAMPLE_SIZE], y[2*RANSAC_SAMPLE_SIZE], model[9];
+        for ( int i = 0 ; i < RANSAC_SAMPLE_SIZE ; i++ ) {
+            x[i] = src_x[sample[i]];
+            y[i] = src_y[sample[i]];
+            x[RANSAC_SAMPLE_SIZE+i] = dst_x[sample[i]];
+            y[RANSAC_SAMPLE_SIZE+i] = dst_y[sample[i]];
+        }
+
+        if ( isSampleDegenerate(x, y) || !getSampleHomography(x, y, model) )
+            continue;
+
+        float model_f[9];
+        std::copy(model, model + 9, model_f);
+
+        const int count = scoreHypothesis(model_f, src_x.data(), src_y.data(), dst_x.data(), dst_y.data(), num_points, threshold, best_count);
+
+        if ( count > best_count ) {
+            best_count = count;
+            std::copy(model, model + 9, best_model);
+            max_iterations = getRansacIterations(double(best_count) / num_points, max_iterations);
+
+            if ( stop_inliers > 0 && best_count >= stop_inliers )
+                break;
+        }
+    }
+
+    return best_count;
+}
+
+int HomographyRansac::findHomography ( const std::vector<cv::KeyPoint> &keypoints_src , const std::vector<cv::KeyPoint> &keypoints_dst ,
+                                       const std::vector<cv::DMatch> &matches , cv::Mat &homography_matrix , cv::Mat &ransac_mask )
+{
+    setPoints(keypoints_src, keypoints_dst, matches);
+
+    ransac_mask.create(int(matches.size()), 1, CV_8U);
+    ransac_mask.setTo(0);
+
+    const int num_inliers = findConsensus(0);
+
+    if ( num_inliers < RANSAC_SAMPLE_SIZE ) {
+        homography_matrix = cv::Mat();
+        return num_inliers;
+    }
+
+    float model_f[9];
+    std::copy(best_model, best_model + 9, model_f);
+
+    const float threshold = float(RANSAC_REPROJECTION_THRESHOLD * RANSAC_REPROJECTION_THRESHOLD);
+
+    inliers_src.clear();
+    inliers_dst.clear();
+    for ( int i = 0 ; i < int(order.size()) ; i++ )
+        if ( isInlier(model_f, src_x[i], src_y[i], dst_x[i], dst_y[i], threshold) ) {
+            ransac_mask.at<uchar>(order[i]) = 1;
+            inliers_src.push_back(cv::Point2f(src_x[i], src_y[i]));
+            inliers_dst.push_back(cv::Point2f(dst_x[i], dst_y[i]));
+        }
+
+    // As the last step of the cv::findHomography with CV_RANSAC, the homography is computed again with all the
+    // inliers and refined by Levenberg-Marquardt.
+    homography_matrix = cv::findHomography(inliers_src, inliers_dst, 0);
+
+    if ( homography_matrix.empty() )
+        cv::Mat(3, 3, CV_64F, best_model).copyTo(homography_matrix);
+
+    return num_inliers;
+}
+
+int HomographyRansac::findHomography ( const std::vector<cv::KeyPoint> &keypoints_src , const std::vector<cv::KeyPoint> &keypoints_dst ,
+                                       const std::vector<cv::DMatch> &matches , cv::Mat &homography_matrix )
+{
+    return findHomography(keypoints_src, keypoints_dst, matches, homography_matrix, mask_buffer);
+}
+
+int HomographyRansac::countInliers ( const std::vector<cv::KeyPoint> &keypoints_src , const std::vector<cv::KeyPoint> &keypoints_dst ,
+                                     const std::vector<cv::DMatch> &matches , const int stop_inliers )
+{
+    setPoints(keypoints_src, keypoints_dst, matches);
+    return findConsensus(stop_inliers);
+}
@@ -25,7 +25,13 @@
  *
  */
 
+#include <cstdlib>
+#include <map>
+
 #include "headers/image_reconstruction.h"
+#include "headers/reconstruction_window.h"
+#include "headers/scratch_arena.h"
+#include "headers/perspective_warp.h"
 
 /**
  * @brief Function that verify if the image fill all the frame limite given by the rect boundaries.
@@ -42,23 +48,19 @@
  */
 bool checkImageBoundaries ( const cv::Mat &image , const cv::Rect &frame_boundaries ){
 
-    cv::Mat img_ad_threshold = cv::Mat(image.rows, image.cols, CV_8UC1),
-            image_gray ,
-            intersection_mask ;
+    static const cv::Mat closing_element = cv::getStructuringElement( cv::MORPH_RECT , cv::Size(10, 10) );
 
-    cv::cvtColor( image , image_gray , CV_BGR2GRAY );
+    ScratchArena::Buffer image_gray ( image.size() , CV_8UC1 ),
+            img_ad_threshold ( image.size() , CV_8UC1 );
 
-    cv::GaussianBlur( image_gray , image_gray , cv::Size( 1, 1 ) , 0 , 0 );
-    cv::threshold( image_gray , img_ad_threshold , 1 , 255 , CV_THRESH_BINARY);
+    cv::cvtColor( image , image_gray.mat , CV_BGR2GRAY );
 
-    cv::morphologyEx( img_ad_threshold , img_ad_threshold , cv::MORPH_CLOSE ,
-                      cv::getStructuringElement( cv::MORPH_RECT , cv::Size(10, 10) ) );
+    cv::threshold( image_gray.mat , img_ad_threshold.mat , 1 , 255 , CV_THRESH_BINARY);
 
-    cv::Mat frame_mask = cv::Mat::zeros(img_ad_threshold.rows, img_ad_threshold.cols, img_ad_threshold.type());
-    frame_mask(frame_boundaries) = cv::Scalar::all(255);
-    intersection_mask = frame_mask & img_ad_threshold;
+    cv::morphologyEx( img_ad_threshold.mat , img_ad_threshold.mat , cv::MORPH_CLOSE , closing_element );
 
-    double percentage = 1.0d - double(cv::countNonZero(intersection_mask))/double(frame_boundaries.height*frame_boundaries.width);
+    // The pixels inside the frame boundaries are the intersection with the frame mask.
+    double percentage = 1.0d - double(cv::countNonZero(img_ad_threshold.mat(frame_boundaries)))/double(frame_boundaries.height*frame_boundaries.width);
 
     return ( percentage < MAXIMUM_AREA_ALLOWED );
 }
@@ -78,20 +80,20 @@ bool checkImageBoundaries ( const cv::Mat &image , const cv::Rect &frame_boundar
  */
 bool checkImageBoundariesMask ( const cv::Mat &image_mask , const cv::Rect &frame_boundaries ){
 
-    cv::Mat frame_mask = cv::Mat::zeros(image_mask.rows, image_mask.cols, image_mask.type());
-    frame_mask(frame_boundaries) = cv::Scalar(255);
-    cv::Mat intersection_mask = frame_mask & image_mask;
-    cv::cvtColor( intersection_mask , intersection_mask , CV_BGR2GRAY );
+    // The pixels inside the frame boundaries are the intersection with the frame mask.
+    ScratchArena::Buffer intersection_mask ( frame_boundaries.size() , CV_8UC1 );
+    cv::cvtColor( image_mask(frame_boundaries) , intersection_mask.mat , CV_BGR2GRAY );
 
-    double percentage = 1.0d - double(cv::countNonZero(intersection_mask))/double(frame_boundaries.height*frame_boundaries.width);
+    double percentage = 1.0d - double(cv::countNonZero(intersection_mask.mat))/double(frame_boundaries.height*frame_boundaries.width);
 
     return ( percentage < MAXIMUM_AREA_ALLOWED );
 }
 
 /**
- * @brief Function that warps the image_to_warp with the image image_fixed and save the result into de image_result and then the resut is cropped into the original image area.
+ * @brief Function that warps the image_to_warp with a known homography matrix to the plane of the image_fixed and save the result into de image_result and then the resut is cropped into the original image area.
  *
  * @param image_to_warp - image to warp.
+ * @param homography_matrix - homography matrix from the image_to_warp to the image_fixed. An empty matrix means it was not found.
  * @param image_fixed - image fixed that will be in the first plane.
  * @param image_fixed_mask - mask of the fixed mask.
  * @param image_result - object to save the result image.
@@ -106,123 +108,158 @@ bool checkImageBoundariesMask ( const cv::Mat &image_mask , const cv::Rect &fram
  * @author Michel Melo da Silva
  * @date 03/05/2016
  */
-bool warpMaskCrop( const cv::Mat &image_to_warp, const cv::Mat &image_fixed , const cv::Mat &image_fixed_mask ,
+bool warpMaskCrop( const cv::Mat &image_to_warp, const cv::Mat &homography_matrix , const cv::Mat &image_fixed , const cv::Mat &image_fixed_mask ,
                    cv::Mat &image_result , cv::Mat &image_result_mask )
 {
-    cv::Mat gray_image_src ,
-            gray_image_dst ;
-
-    // Convert to Grayscale
-
-    cv::cvtColor( image_fixed, gray_image_dst, CV_BGR2GRAY );
-    cv::cvtColor( image_to_warp, gray_image_src, CV_BGR2GRAY );
-    if( !gray_image_src.data || !gray_image_dst.data ) {
-        std::cout<< " --(!) ERROR: Could not convert images to Grayscale!" << std::endl;
+    if ( homography_matrix.empty() ) {
+        image_result = image_fixed.clone();
         return false;
-    } else {
-        cv::Mat homography_matrix;
-        if(!findHomographyMatrix(gray_image_src, gray_image_dst, homography_matrix)){
-            image_result = image_fixed.clone();
-            return false;
-        }
+    }
 
-        //-- Get the corners from the imageSrc
-        std::vector<cv::Point2f> img_corners(4);
-        img_corners[0] = cv::Point( 0                    , 0                    );
-        img_corners[1] = cv::Point( gray_image_src.cols  , 0                    );
-        img_corners[2] = cv::Point( 0                    , gray_image_src.rows  );
-        img_corners[3] = cv::Point( gray_image_src.cols  , gray_image_src.rows  );
-        std::vector<cv::Point2f> new_img_corners(4);
+    //-- Get the corners from the imageSrc
+    std::vector<cv::Point2f> img_corners(4);
+    img_corners[0] = cv::Point( 0                    , 0                    );
+    img_corners[1] = cv::Point( image_to_warp.cols   , 0                    );
+    img_corners[2] = cv::Point( 0                    , image_to_warp.rows   );
+    img_corners[3] = cv::Point( image_to_warp.cols   , image_to_warp.rows   );
+    std::vector<cv::Point2f> new_img_corners(4);
 
-        cv::perspectiveTransform( img_corners, new_img_corners, homography_matrix);
+    cv::perspectiveTransform( img_corners, new_img_corners, homography_matrix);
 
-        int height = gray_image_dst.rows,
-                width = gray_image_dst.cols;
+    int height = image_fixed.rows,
+            width = image_fixed.cols;
 
-        for (int i = 0 ; i < 4 ; i++){
-            if ( int(ceil(new_img_corners[i].x)) > width )
-                width = int(ceil(new_img_corners[i].x));
-            if ( int(ceil(new_img_corners[i].y)) > height )
-                height = int(ceil(new_img_corners[i].y));
-        }
-
-        if ( ( ! checkHomographyConsistency( new_img_corners ) ) ||
-             ( width > 4 * image_to_warp.cols ) ||
-             ( height > 4 * image_to_warp.rows )  ) {
-            // ----------------------------------------------------------------------
-            // DEBUG
-            if ( DEBUG_HOMOGRAPHY )
-                std::cout << "Projecao errada**************************" << std::endl;
-            // ----------------------------------------------------------------------
-            image_result = image_fixed.clone();
-            return false;
-        }
+    for (int i = 0 ; i < 4 ; i++){
+        if ( int(ceil(new_img_corners[i].x)) > width )
+            width = int(ceil(new_img_corners[i].x));
+        if ( int(ceil(new_img_corners[i].y)) > height )
+            height = int(ceil(new_img_corners[i].y));
+    }
 
+    if ( ( ! checkHomographyConsistency( new_img_corners ) ) ||
+         ( width > 4 * image_to_warp.cols ) ||
+         ( height > 4 * image_to_warp.rows )  ) {
         // ----------------------------------------------------------------------
         // DEBUG
         if ( DEBUG_HOMOGRAPHY )
-            std::cout<< "height: " << height << std::endl
-                     << "width: " << width << std::endl;
+            std::cout << "Projecao errada**************************" << std::endl;
         // ----------------------------------------------------------------------
+        image_result = image_fixed.clone();
+        return false;
+    }
 
-        cv::Mat image_to_warp_mask = cv::Mat(image_to_warp.rows, image_to_warp.cols, image_to_warp.type(), cv::Scalar::all(255)),
-                image_to_warp_mask_homography ;
+    // ----------------------------------------------------------------------
+    // DEBUG
+    if ( DEBUG_HOMOGRAPHY )
+        std::cout<< "height: " << height << std::endl
+                 << "width: " << width << std::endl;
+    // ----------------------------------------------------------------------
 
+    // Everything out of the area of the image_to_warp is cropped in the end, so the warp is limited to it and to the
+    // area of the image_fixed, and the temporary matrices keep the same size from one call to the next.
+    const cv::Size canvas_size ( std::max(image_fixed.cols, image_to_warp.cols) , std::max(image_fixed.rows, image_to_warp.rows) );
+    const cv::Rect fixed_area ( 0 , 0 , image_fixed_mask.cols , image_fixed_mask.rows ),
+            crop_area ( 0 , 0 , image_to_warp.cols , image_to_warp.rows );
 
-        // Use the Homography Matrix to warp the images
-        cv::warpPerspective( image_to_warp , image_result , homography_matrix , cv::Size(width, height) );
-        cv::warpPerspective( image_to_warp_mask , image_to_warp_mask_homography , homography_matrix , cv::Size(width, height) );
-        image_result_mask = cv::Mat(image_to_warp_mask_homography.rows, image_to_warp_mask_homography.cols, image_to_warp_mask_homography.type(), cv::Scalar::all(0));
-        image_fixed_mask.copyTo(image_result_mask(cv::Rect(0,0,image_fixed_mask.cols,image_fixed_mask.rows)));
+    ScratchArena::Buffer warped_mask ( canvas_size , CV_8UC1 ),
+            image_to_warp_mask_homography ( canvas_size , image_to_warp.type() ),
+            image_warped ( canvas_size , image_to_warp.type() ),
+            image_warped_mask ( canvas_size , image_to_warp.type() ),
+            AB ( image_fixed_mask.size() , image_fixed_mask.type() ),
+            B_A ( image_fixed_mask.size() , image_fixed_mask.type() ),
+            seam_mask ( image_to_warp.size() , CV_8UC1 );
 
-        //        imshow("image_fixed", image_fixed_mask);
-        //        imshow("image_to_warp", image_to_warp_mask_homography);
-        //        cv::waitKey(0);
-        //        cv::destroyAllWindows();
+    // Use the Homography Matrix to warp the image and its white mask in the same pass. The masks of this function have
+    // the channels of the frames.
+    warpPerspectiveBilinear( image_to_warp , homography_matrix , canvas_size , image_warped.mat , warped_mask.mat );
+    cv::cvtColor( warped_mask.mat , image_to_warp_mask_homography.mat , CV_GRAY2BGR );
+    image_warped_mask.mat = cv::Scalar::all(0);
+    image_fixed_mask.copyTo(image_warped_mask.mat(fixed_area));
 
-        cv::Mat A = image_fixed_mask.clone(),
-                B = image_to_warp_mask_homography.clone() ;
+    //        imshow("image_fixed", image_fixed_mask);
+    //        imshow("image_to_warp", image_to_warp_mask_homography);
+    //        cv::waitKey(0);
+    //        cv::destroyAllWindows();
 
-        B = B ( cv::Rect(0,0,image_fixed_mask.cols,image_fixed_mask.rows));
+    // The masks are only read, so they are not copied.
+    const cv::Mat &A = image_fixed_mask,
+            B = image_to_warp_mask_homography.mat ( fixed_area );
 
-        cv::Mat AB = A & B ,
-                B_A = B - A;
+    cv::bitwise_and( A , B , AB.mat );
+    cv::subtract( B , A , B_A.mat );
 
-        cv::morphologyEx( AB , AB , cv::MORPH_DILATE ,
-                          cv::getStructuringElement( cv::MORPH_RECT , cv::Size(3, 3) ) );
-        cv::morphologyEx( B_A , B_A , cv::MORPH_DILATE ,
-                          cv::getStructuringElement( cv::MORPH_RECT , cv::Size(3, 3) ) );
+    cv::morphologyEx( AB.mat , AB.mat , cv::MORPH_DILATE ,
+                      cv::getStructuringElement( cv::MORPH_RECT , cv::Size(3, 3) ) );
+    cv::morphologyEx( B_A.mat , B_A.mat , cv::MORPH_DILATE ,
+                      cv::getStructuringElement( cv::MORPH_RECT , cv::Size(3, 3) ) );
 
-        //        imshow("AB", AB);
-        //        imshow("B_A", B_A);
-        //        cv::waitKey(0);
-        //        cv::destroyAllWindows();
+    //        imshow("AB", AB);
+    //        imshow("B_A", B_A);
+    //        cv::waitKey(0);
+    //        cv::destroyAllWindows();
 
-        AB = AB & B_A ;
+    cv::bitwise_and( AB.mat , B_A.mat , AB.mat );
 
-        image_result_mask = image_result_mask | image_to_warp_mask_homography;
+    image_fixed.copyTo( image_warped.mat(fixed_area) , image_fixed_mask );
 
-        image_fixed.copyTo( image_result(cv::Rect(0,0,image_fixed_mask.cols,image_fixed_mask.rows)) , image_fixed_mask );
+    cv::bitwise_or( image_warped_mask.mat(crop_area) , image_to_warp_mask_homography.mat(crop_area) , image_result_mask );
 
-        image_result = image_result ( cv::Rect(0,0,image_to_warp.cols,image_to_warp.rows) );
-        image_result_mask = image_result_mask ( cv::Rect(0,0,image_to_warp.cols,image_to_warp.rows) );
-        AB = AB ( cv::Rect(0,0,image_to_warp.cols,image_to_warp.rows) );
+    //        imshow("AB", AB);
+    //        cv::waitKey(0);
+    //        cv::destroyAllWindows();
 
+    cv::cvtColor( AB.mat(crop_area) , seam_mask.mat , CV_BGR2GRAY );
 
-        //        imshow("AB", AB);
-        //        cv::waitKey(0);
-        //        cv::destroyAllWindows();
+    // Only the result leaves the scratch buffers.
+    cv::inpaint(image_warped.mat(crop_area), seam_mask.mat, image_result, 1, cv::INPAINT_TELEA);
 
-        cv::cvtColor( AB , AB , CV_BGR2GRAY );
+    //        imshow("Inpaint", image_result);
+    //        cv::waitKey(0);
+    //        cv::destroyAllWindows();
 
-        cv::inpaint(image_result, AB, image_result, 1, cv::INPAINT_TELEA);
+    return true;
+}
 
-        //        imshow("Inpaint", image_result);
-        //        cv::waitKey(0);
-        //        cv::destroyAllWindows();
+/**
+ * @brief Function that warps the image_to_warp with the image image_fixed and save the result into de image_result and then the resut is cropped into the original image area.
+ *
+ * @param image_to_warp - image to warp.
+ * @param image_fixed - image fixed that will be in the first plane.
+ * @param image_fixed_mask - mask of the fixed mask.
+ * @param image_result - object to save the result image.
+ * @param image_result_mask - objecto to save the mask of the result image.
+ *
+ * @return
+ *      \c bool \b true  - if the corner consistency is maintained after application of the homography matrix found to warp the image. It also returns
+ *              false if is not found a homography matrix between the images. \n
+ *      \c bool \b false - if the consistency is not maintained after application of the homography matrix found to warp the image. In this case the
+ *              imageResult is a simple copy of the imageFixed.
+ *
+ * @author Michel Melo da Silva
+ * @date 03/05/2016
+ */
+bool warpMaskCrop( const cv::Mat &image_to_warp, const cv::Mat &image_fixed , const cv::Mat &image_fixed_mask ,
+                   cv::Mat &image_result , cv::Mat &image_result_mask )
+{
+    cv::Mat gray_image_src ,
+            gray_image_dst ;
 
-        return true;
+    // Convert to Grayscale
+
+    cv::cvtColor( image_fixed, gray_image_dst, CV_BGR2GRAY );
+    cv::cvtColor( image_to_warp, gray_image_src, CV_BGR2GRAY );
+    if( !gray_image_src.data || !gray_image_dst.data ) {
+        std::cout<< " --(!) ERROR: Could not convert images to Grayscale!" << std::endl;
+        return false;
+    }
+
+    cv::Mat homography_matrix;
+    if(!findHomographyMatrix(gray_image_src, gray_image_dst, homography_matrix)){
+        image_result = image_fixed.clone();
+        return false;
     }
+
+    return warpMaskCrop( image_to_warp , homography_matrix , image_fixed , image_fixed_mask , image_result , image_result_mask );
 }
 
 
@@ -320,6 +357,84 @@ bool warpMask( const cv::Mat &image_to_warp, const cv::Mat &image_fixed , const
     }
 }
 
+/**
+ * @brief Function that warps the image_to_warp with a known homography matrix to the plane of the image_fixed and save the result into de image_result.
+ *
+ * @param image_to_warp - image to warp.
+ * @param homography_matrix - homography matrix from the image_to_warp to the image_fixed. An empty matrix means it was not found.
+ * @param image_fixed - image fixed that will be in the first plane.
+ * @param image_result - object to save the result image.
+ *
+ * @return
+ *      \c bool \b true  - if the corner consistency is maintained after application of the homography matrix found to warp the image. It also returns
+ *              false if is not found a homography matrix between the images. \n
+ *      \c bool \b false - if the consistency is not maintained after application of the homography matrix found to warp the image. In this case the
+ *              imageResult is a simple copy of the imageFixed.
+ *
+ * @author Michel Melo da Silva
+ * @date 14/11/2015
+ */
+bool warp( const cv::Mat &image_to_warp, const cv::Mat &homography_matrix , const cv::Mat &image_fixed , cv::Mat &image_result )
+{
+    if ( homography_matrix.empty() ) {
+        image_result = image_fixed.clone();
+        return false;
+    }
+
+    //-- Get the corners from the imageSrc
+    std::vector<cv::Point2f> img_corners(4);
+    img_corners[0] = cv::Point( 0                    , 0                     );
+    img_corners[1] = cv::Point( image_to_warp.cols   , 0                     );
+    img_corners[2] = cv::Point( 0                    , image_to_warp.rows    );
+    img_corners[3] = cv::Point( image_to_warp.cols   , image_to_warp.rows    );
+    std::vector<cv::Point2f> new_img_corners(4);
+
+    cv::perspectiveTransform( img_corners, new_img_corners, homography_matrix);
+
+    int height = image_fixed.rows,
+            width = image_fixed.cols;
+
+    for (int i = 0 ; i < 4 ; i++){
+        if ( int(ceil(new_img_corners[i].x)) > width )
+            width = int(ceil(new_img_corners[i].x));
+        if ( int(ceil(new_img_corners[i].y)) > height )
+            height = int(ceil(new_img_corners[i].y));
+    }
+
+    if ( ( ! checkHomographyConsistency( new_img_corners ) ) ||
+         ( width > 4 * image_fixed.cols ) ||
+         ( height > 4 * image_fixed.rows )  ) {
+        // ----------------------------------------------------------------------
+        // DEBUG
+        if ( DEBUG_HOMOGRAPHY )
+            std::cout << "Projecao errada**************************" << std::endl;
+        // ----------------------------------------------------------------------
+        image_result = image_fixed.clone();
+        return false;
+    }
+
+    // ----------------------------------------------------------------------
+    // DEBUG
+    if ( DEBUG_HOMOGRAPHY )
+        std::cout<< "height: " << height << std::endl
+                 << "width: " << width << std::endl;
+    // ----------------------------------------------------------------------
+
+    // Use the Homography Matrix to warp the images
+    warpPerspectiveBilinear( image_to_warp , homography_matrix , cv::Size(width, height) , image_result );
+
+    cv::Mat half = cv::Mat(image_result,cv::Rect(0,0,image_fixed.cols,image_fixed.rows));
+    ScratchArena::Buffer img_ad_threshold ( image_fixed.size() , CV_8UC1 ),
+            image_fixed_gray ( image_fixed.size() , CV_8UC1 );
+
+    cv::cvtColor( image_fixed, image_fixed_gray.mat, CV_BGR2GRAY );
+
+    cv::threshold(image_fixed_gray.mat, img_ad_threshold.mat, 1, 255, CV_THRESH_BINARY);
+
+    image_fixed.copyTo(half, img_ad_threshold.mat);
+    return true;
+}
+
 /**
  * @brief Function that warps the image_to_warp with the image image_fixed and save the result into de image_result.
  *
@@ -347,68 +462,112 @@ bool warp( const cv::Mat &image_to_warp, const cv::Mat &image_fixed , cv::Mat &i
     if( !gray_image_src.data || !gray_image_dst.data ) {
         std::cout<< " --(!) ERROR: Could not convert images to Grayscale!" << std::endl;
         return false;
-    } else {
-        cv::Mat homography_matrix;
-        if(!findHomographyMatrix(gray_image_src, gray_image_dst, homography_matrix)){
-            image_result = image_fixed.clone();
-            return false;
-        }
-
-        //-- Get the corners from the imageSrc
-        std::vector<cv::Point2f> img_corners(4);
-        img_corners[0] = cv::Point( 0                    , 0                     );
-        img_corners[1] = cv::Point( gray_image_src.cols  , 0                     );
-        img_corners[2] = cv::Point( 0                    , gray_image_src.rows    );
-        img_corners[3] = cv::Point( gray_image_src.cols  , gray_image_src.rows    );
-        std::vector<cv::Point2f> new_img_corners(4);
-
-        cv::perspectiveTransform( img_corners, new_img_corners, homography_matrix);
-
-        int height = gray_image_dst.rows,
-                width = gray_image_dst.cols;
-
-        for (int i = 0 ; i < 4 ; i++){
-            if ( int(ceil(new_img_corners[i].x)) > width )
-                width = int(ceil(new_img_corners[i].x));
-            if ( int(ceil(new_img_corners[i].y)) > height )
-                height = int(ceil(new_img_corners[i].y));
-        }
+    }
 
-        if ( ( ! checkHomographyConsistency( new_img_corners ) ) ||
-             ( width > 4 * gray_image_dst.cols ) ||
-             ( height > 4 * gray_image_dst.rows )  ) {
-            // ----------------------------------------------------------------------
-            // DEBUG
-            if ( DEBUG_HOMOGRAPHY )
-                std::cout << "Projecao errada**************************" << std::endl;
-            // ----------------------------------------------------------------------
-            image_result = image_fixed.clone();
-            return false;
-        }
+    cv::Mat homography_matrix;
+    if(!findHomographyMatrix(gray_image_src, gray_image_dst, homography_matrix)){
+        image_result = image_fixed.clone();
+        return false;
+    }
 
-        // ----------------------------------------------------------------------
-        // DEBUG
-        if ( DEBUG_HOMOGRAPHY )
-            std::cout<< "height: " << height << std::endl
-                     << "width: " << width << std::endl;
-        // ----------------------------------------------------------------------
+    return warp( image_to_warp , homography_matrix , image_fixed , image_result );
+}
 
-        // Use the Homography Matrix to warp the images
-        cv::warpPerspective( image_to_warp , image_result , homography_matrix , cv::Size(width, height) );
+/**
+ * @brief The NeighbourRegistration class finds the homographies from the neighbour frames to the image being
+ *          reconstructed, without describing the reconstruction again after each warp.
+ *
+ * The features of the image are computed once, when the registration is created, and the features of the neighbours
+ * come from the ReconstructionWindow, so each frame is described once for all the reconstructions that use it. A
+ * neighbour is matched to the image, and if that fails (it usually shares too little content), to its next frame
+ * towards the image, chaining the homography already known for that frame. The homographies found are kept until the
+ * end of the reconstruction.
+ */
+class NeighbourRegistration
+{
+public:
+    /**
+     * @brief NeighbourRegistration::NeighbourRegistration Describes the image being reconstructed.
+     * @param window - window with the neighbour frames.
+     * @param image - image of the frame being reconstructed, before any transformation.
+     * @param index - index of the image in the original video, -1 if it is not a frame of the video. In this case the neighbours are not chained.
+     * @param image_transform - homography from the image to the plane of the reconstruction.
+     */
+    NeighbourRegistration ( ReconstructionWindow &window , const cv::Mat &image , const int index , const cv::Mat &image_transform ) :
+        window(window),
+        index(index)
+    {
+        image_transform.convertTo( this->image_transform , CV_64F );
+
+        cv::Mat gray_image;
+        cv::cvtColor( image , gray_image , CV_BGR2GRAY );
+        getKeypointsAndDescriptors( gray_image , image_keypoints , image_descriptors );
+    }
 
-        cv::Mat half = cv::Mat(image_result,cv::Rect(0,0,image_fixed.cols,image_fixed.rows)) ,
-                img_ad_threshold = cv::Mat(image_fixed.rows, image_fixed.cols, CV_8UC1) ,
-                image_fixed_gray;
+    /**
+     * @brief NeighbourRegistration::getHomography Returns the homography from the neighbour frame to the plane of the reconstruction.
+     * @param neighbour - index of the neighbour frame in the original video.
+     * @param homography_matrix - object to save the homography matrix, empty if it was not found.
+     * @return \c bool \b false if the homography was not found.
+     */
+    bool getHomography ( const int neighbour , cv::Mat &homography_matrix ) {
+        const cv::Mat &neighbour_to_image = getHomographyToImage(neighbour);
+
+        if ( neighbour_to_image.empty() )
+            homography_matrix.release();
+        else
+            homography_matrix = image_transform * neighbour_to_image;
+
+        return !homography_matrix.empty();
+    }
 
-        cv::cvtColor( image_fixed, image_fixed_gray, CV_BGR2GRAY );
+private:
+    /**
+     * @brief NeighbourRegistration::getHomographyToImage Returns the homography from the neighbour frame to the image,
+     *          matching the neighbour directly to the image or chaining it through the next frame towards the image.
+     * @param neighbour - index of the neighbour frame in the original video.
+     * @return \c const cv::Mat& - homography matrix, empty if it was not found.
+     */
+    const cv::Mat& getHomographyToImage ( const int neighbour ) {
+        std::map<int, cv::Mat>::iterator it = to_image.find(neighbour);
+        if ( it != to_image.end() )
+            return it->second;
 
-        cv::GaussianBlur( image_fixed_gray, image_fixed_gray, cv::Size( 1, 1 ), 0, 0 );
-        cv::threshold(image_fixed_gray, img_ad_threshold, 1, 255, CV_THRESH_BINARY);
+        cv::Mat homography_matrix;
+        std::vector<cv::KeyPoint> neighbour_keypoints;
+        cv::Mat neighbour_descriptors;
+
+        if ( neighbour == index )
+            homography_matrix = cv::Mat::eye(3, 3, CV_64F);
+        else if ( window.getFeatures(neighbour, neighbour_keypoints, neighbour_descriptors) &&
+                  !neighbour_keypoints.empty() && !image_keypoints.empty() &&
+                  !findHomographyMatrix(neighbour_keypoints, image_keypoints, neighbour_descriptors, image_descriptors, homography_matrix) )
+            homography_matrix.release();
+
+        // Chains the homography of the next frame towards the image.
+        if ( homography_matrix.empty() && !neighbour_keypoints.empty() && index >= 0 && std::abs(neighbour - index) > 1 ) {
+            const int next = neighbour < index ? neighbour + 1 : neighbour - 1;
+            const cv::Mat next_to_image = getHomographyToImage(next);
+
+            std::vector<cv::KeyPoint> next_keypoints;
+            cv::Mat next_descriptors,
+                    to_next;
+
+            if ( !next_to_image.empty() && window.getFeatures(next, next_keypoints, next_descriptors) && !next_keypoints.empty() &&
+                 findHomographyMatrix(neighbour_keypoints, next_keypoints, neighbour_descriptors, next_descriptors, to_next) && !to_next.empty() )
+                homography_matrix = next_to_image * to_next;
+        }
 
-        image_fixed.copyTo(half, img_ad_threshold);
-        return true;
+        return to_image[neighbour] = homography_matrix;
     }
-}
+
+    ReconstructionWindow            &window;
+    int                             index;
+    cv::Mat                         image_transform;
+    std::vector<cv::KeyPoint>       image_keypoints;
+    cv::Mat                         image_descriptors;
+    std::map<int, cv::Mat>          to_image;           /** Homographies already searched, empty if not found. */
+};
 
 /**
  * @brief Function that reconstructs an image using panorama based on homography in a image sequence.
@@ -428,61 +587,100 @@ bool warp( const cv::Mat &image_to_warp, const cv::Mat &image_fixed , cv::Mat &i
  */
 bool imageReconstruction ( const cv::Mat &image , const int index , const EXPERIMENT &experiment_settings , const cv::Rect &frame_boundaries , cv::Mat &reconstructed_image ){
 
-    cv::VideoCapture video ( experiment_settings.original_video_filename );
+    ReconstructionWindow &window = ReconstructionWindow::getWindow(experiment_settings.original_video_filename);
 
-    if ( !video.isOpened() ) {
+    if ( !window.isOpened() ) {
         std::cout << " --(!) ERROR: Can not open the original video \"" << experiment_settings.original_video_filename << "\"." << std::endl;
         exit(-5);
     }
 
     //cv::namedWindow("Reconstruction");
 
-    cv::Mat result = image.clone();
+    // The warps go back and forth between the result and the partial image, so the image is copied only once.
+    cv::Mat result = image.clone(),
+            partial_image;
 
-    int num_frames = int(video.get(CV_CAP_PROP_FRAME_COUNT)) ,
-            min_index = std::max(index - NUM_MAX_IMAGES_TO_RECONSTRUCT, 0) ,
-            max_index = std::min(index + NUM_MAX_IMAGES_TO_RECONSTRUCT, num_frames) ;
+    int min_index = std::max(index - NUM_MAX_IMAGES_TO_RECONSTRUCT, 0) ;
 
-    std::vector<cv::Mat> frame_buffer(max_index-min_index+1);
+    // The neighbour frames are decoded only when needed, since the reconstruction usually stops early.
+    window.moveTo(min_index + NUM_MAX_IMAGES_TO_RECONSTRUCT);
+    cv::Mat neighbour_frame,
+            neighbour_homography;
 
-    video.set( CV_CAP_PROP_POS_FRAMES, min_index);
-
-    for ( unsigned int i = 0 ; i < frame_buffer.size() ; i++ )
-        video >> frame_buffer[i];
+    // The image is already in the plane of the reconstruction and may not be a frame of the video, so the neighbours
+    // are only matched to it directly.
+    NeighbourRegistration registration ( window , image , -1 , cv::Mat::eye(3, 3, CV_64F) );
 
     for ( int i = 1 ; i <= NUM_MAX_IMAGES_TO_RECONSTRUCT ; i++ ) {
 
-        reconstructed_image = result.clone();
+        window.getFrame( min_index + NUM_MAX_IMAGES_TO_RECONSTRUCT-i , neighbour_frame );
+        registration.getHomography( min_index + NUM_MAX_IMAGES_TO_RECONSTRUCT-i , neighbour_homography );
+        warp( neighbour_frame , neighbour_homography , result , partial_image );
+        window.getFrame( min_index + NUM_MAX_IMAGES_TO_RECONSTRUCT+i , neighbour_frame );
+        registration.getHomography( min_index + NUM_MAX_IMAGES_TO_RECONSTRUCT+i , neighbour_homography );
+        warp( neighbour_frame , neighbour_homography , partial_image , result );
+
+        // The result is handed over without copying, so the boundaries are checked before drawing on it.
+        reconstructed_image = result;
+        bool filled = checkImageBoundaries( reconstructed_image , frame_boundaries );
 
-        warp( frame_buffer[NUM_MAX_IMAGES_TO_RECONSTRUCT-i] , reconstructed_image , result );
-        reconstructed_image = result.clone();
-        warp( frame_buffer[NUM_MAX_IMAGES_TO_RECONSTRUCT+i] , reconstructed_image , result );
-        reconstructed_image = result.clone();
         if ( DEBUG_RECONSTRUCTION ){
             cv::rectangle( result , frame_boundaries , cv::Scalar(0,255,0) , 2 ) ;
         }
         EXECUTE_VIEW;
 
-        if ( checkImageBoundaries( reconstructed_image , frame_boundaries ) ) {
+        if ( filled ) {
             //EXECUTE_VIEW;
             // ---------------------------------------------------------------------------
             // DEBUG
             if ( DEBUG_RECONSTRUCTION )
                 std::cout << "Done with reconstruction using " << i << " frames." << std::endl;
             // ---------------------------------------------------------------------------
-            video.release();
             return true;
         }
     }
     //EXECUTE_VIEW;
-    video.release();
 
     return false;
 }
 
+/**
+ * @brief Function that computes the part of the frame boundaries not covered by the mask.
+ *
+ * @param coverage_mask - single channel mask, non-zero where the image has content.
+ * @param frame_boundaries - area where the image should fill, in the coordinates of the mask.
+ *
+ * @return \c double - ratio between the uncovered area and the area of the frame boundaries.
+ *
+ * @date 17/10/2026
+ */
+static double getUncoveredRatio ( const cv::Mat &coverage_mask , const cv::Rect &frame_boundaries ) {
+    cv::Rect area = frame_boundaries & cv::Rect(0, 0, coverage_mask.cols, coverage_mask.rows);
+    if ( area.area() <= 0 )
+        return 0;
+
+    return 1.0d - double(cv::countNonZero(coverage_mask(area)))/double(area.area());
+}
+
+/**
+ * @brief A neighbour frame chosen to fill the reconstruction.
+ */
+struct PlannedNeighbour {
+    int         index;
+    cv::Mat     homography_matrix;      /** Homography from the neighbour to the plane of the reconstruction. */
+    cv::Mat     footprint;              /** Area covered by the warped neighbour in the reduced plan of the frame boundaries. */
+};
+
 /**
  * @brief Function that reconstructs an image using panorama based on homography in a image sequence.
  *
+ * The reconstruction is planned before any neighbour is warped. The area that each neighbour covers is predicted from
+ * the corners of its homography, in a mask of the frame boundaries reduced by RECONSTRUCTION_PLAN_SCALE. The neighbours
+ * are tried from the closest to the farthest, and only the ones that cover a new part of the frame are chosen, until
+ * the frame is filled. The chosen neighbours made redundant by the ones chosen after them are dropped. Then the chosen
+ * neighbours are warped once, each one filling only the pixels still empty, and the seams are inpainted once in the end.
+ * If the warped images do not fill the frame as predicted, the remaining neighbours are warped one by one until it is filled.
+ *
  * @param image - image initial without homography transformation.
  * @param homography_matrix - homography matrix that will be applied to the original image where the reconstruct will start.
  * @param index - index of the initial image in the original video.
@@ -500,142 +698,189 @@ bool imageReconstruction ( const cv::Mat &image , const int index , const EXPERI
 bool reconstructImage ( const cv::Mat &image , const cv::Mat &homography_matrix , const int index , const EXPERIMENT &experiment_settings ,
                         const cv::Rect &drop_boundaries, const cv::Rect &frame_boundaries , cv::Mat &reconstructed_image ){
 
-    cv::VideoCapture video ( experiment_settings.original_video_filename );
+    ReconstructionWindow &window = ReconstructionWindow::getWindow(experiment_settings.original_video_filename);
 
-    if ( !video.isOpened() ) {
+    if ( !window.isOpened() ) {
         std::cout << " --(!) ERROR: Can not open the original video \"" << experiment_settings.original_video_filename << "\"." << std::endl;
         exit(-5);
     }
 
-    //cv::namedWindow("Reconstruction");
-
     cv::Mat image_homography;
     applyHomographyMatrix( image , homography_matrix , image_homography );
 
-    cv::Mat result = image_homography.clone() ,
-            image_fixed_mask = cv::Mat(image.rows, image.cols, image_homography.type(), cv::Scalar::all(255)),
-            reconstructed_image_mask ,
-            result_mask ;
+    cv::Mat image_fixed_mask = cv::Mat(image.rows, image.cols, CV_8UC1, cv::Scalar(255)),
+            coverage_mask ;
 
-    applyHomographyMatrix( image_fixed_mask , homography_matrix , result_mask );
+    applyHomographyMatrix( image_fixed_mask , homography_matrix , coverage_mask );
+    cv::threshold( coverage_mask , coverage_mask , 0 , 255 , CV_THRESH_BINARY );
 
-    int num_frames = int(video.get(CV_CAP_PROP_FRAME_COUNT)) ,
+    // The warped image may be larger than the frame, the reconstruction is a view of it cropped to the frame size,
+    // since nothing else holds the warped image.
+    const cv::Rect image_area ( 0 , 0 , image.cols , image.rows );
+    reconstructed_image = image_homography(image_area);
+    coverage_mask = coverage_mask(image_area);
+
+    if ( getUncoveredRatio( coverage_mask , frame_boundaries ) < MAXIMUM_AREA_ALLOWED )
+        return true;
+
+    int num_frames = window.getFrameCount() ,
             min_index = index - NUM_MAX_IMAGES_TO_RECONSTRUCT ,
             max_index = index + NUM_MAX_IMAGES_TO_RECONSTRUCT ;
 
     //Setting the reconstruction type
     ReconstructionType reconstruction_type = PRE_AND_POS;
     if (min_index < 0){
-        min_index = 0;
         reconstruction_type = ONLY_POS;
     } else if (max_index > num_frames){
-        max_index = num_frames;
         reconstruction_type = ONLY_PRE;
     }
 
-    std::vector<cv::Mat> frame_buffer(max_index-min_index+1);
-
-    video.set( CV_CAP_PROP_POS_FRAMES, min_index);
-
-    for ( unsigned int i = 0 ; i < frame_buffer.size() ; i++ )
-        video >> frame_buffer[i];
-
-    if (reconstruction_type == PRE_AND_POS){
-        for ( int i = 1 ; i <= NUM_MAX_IMAGES_TO_RECONSTRUCT ; i++ ) {
-            reconstructed_image = result.clone();
-            reconstructed_image_mask = result_mask.clone();
-
-            warpMaskCrop( frame_buffer[NUM_MAX_IMAGES_TO_RECONSTRUCT-i] , reconstructed_image , reconstructed_image_mask , result , result_mask );
-            reconstructed_image = result.clone();
-            reconstructed_image_mask = result_mask.clone();
-
-//            if ( DEBUG_RECONSTRUCTION ){
-//                cv::rectangle( result , frame_boundaries , cv::Scalar(0,255,0) , 2 ) ;
-//                cv::rectangle( result , drop_boundaries , cv::Scalar(0,0,255) , 2 ) ;
-//                //std::string str = SSTR("/home/washingtonramos/frame_224_" << (i*2) << ".png");
-//                //cv::imwrite(str, result);
-//            }
-//            EXECUTE_VIEW;
-
-            warpMaskCrop( frame_buffer[NUM_MAX_IMAGES_TO_RECONSTRUCT+i] , reconstructed_image , reconstructed_image_mask , result , result_mask );
-            reconstructed_image = result.clone();
-            reconstructed_image_mask = result_mask.clone();
-
-//            if ( DEBUG_RECONSTRUCTION ){
-//                cv::rectangle( result , frame_boundaries , cv::Scalar(0,255,0) , 2 ) ;
-//                cv::rectangle( result , drop_boundaries , cv::Scalar(0,0,255) , 2 ) ;
-//                //std::string str = SSTR("/home/washingtonramos/frame_224_" << (i*2+1) << ".png");
-//                //cv::imwrite(str, result);
-//            }
-//            EXECUTE_VIEW;
-
-            if ( checkImageBoundariesMask( reconstructed_image_mask , frame_boundaries ) ) {
-                //EXECUTE_VIEW;
-                // ---------------------------------------------------------------------------
-                // DEBUG
-                //if ( DEBUG_RECONSTRUCTION )
-                //   std::cout << "Done with reconstruction using " << i << " frames." << std::endl;
-                // ---------------------------------------------------------------------------
-                video.release();
-                return true;
+    // Neighbours from the closest to the farthest.
+    std::vector<int> candidates;
+    for ( int i = 1 ; i <= NUM_MAX_IMAGES_TO_RECONSTRUCT ; i++ ) {
+        if ( reconstruction_type != ONLY_POS )
+            candidates.push_back( index - i );
+        if ( reconstruction_type != ONLY_PRE )
+            candidates.push_back( index + i );
+    }
+
+    window.moveTo(index);
+    NeighbourRegistration registration ( window , image , index , homography_matrix );
+
+    // Reduced plan of the frame boundaries.
+    const cv::Rect plan_area = frame_boundaries & cv::Rect(0, 0, image.cols, image.rows);
+    const cv::Size plan_size ( std::max(1, plan_area.width / RECONSTRUCTION_PLAN_SCALE) , std::max(1, plan_area.height / RECONSTRUCTION_PLAN_SCALE) );
+    const cv::Rect whole_plan ( 0 , 0 , plan_size.width , plan_size.height );
+
+    cv::Mat planned_coverage;
+    cv::resize( coverage_mask(plan_area) , planned_coverage , plan_size , 0 , 0 , cv::INTER_NEAREST );
+
+    cv::Mat seam_mask = cv::Mat::zeros(image.rows, image.cols, CV_8UC1),
+            structuring_element = cv::getStructuringElement( cv::MORPH_RECT , cv::Size(3, 3) ),
+            neighbour_frame;
+
+    unsigned int next_candidate = 0;
+    int num_warps = 0;
+    bool fallback = false;
+
+    while ( next_candidate < candidates.size() ) {
+
+        // Step 1: choose the neighbours that fill the frame, without warping them. In the fallback, the neighbours are
+        // warped one by one, as the prediction was not enough.
+        std::vector<PlannedNeighbour> plan;
+        cv::Mat base_coverage = planned_coverage.clone();
+
+        while ( next_candidate < candidates.size() ) {
+            if ( fallback ? !plan.empty() : getUncoveredRatio( planned_coverage , whole_plan ) < MAXIMUM_AREA_ALLOWED )
+                break;
+
+            PlannedNeighbour neighbour;
+            neighbour.index = candidates[next_candidate++];
+
+            if ( !window.getFrame( neighbour.index , neighbour_frame ) || !registration.getHomography( neighbour.index , neighbour.homography_matrix ) )
+                continue;
+
+            //-- Get the corners from the neighbour and rejects the same projections as the warpMaskCrop.
+            std::vector<cv::Point2f> img_corners(4), new_img_corners(4);
+            img_corners[0] = cv::Point( 0                    , 0                    );
+            img_corners[1] = cv::Point( neighbour_frame.cols , 0                    );
+            img_corners[2] = cv::Point( 0                    , neighbour_frame.rows );
+            img_corners[3] = cv::Point( neighbour_frame.cols , neighbour_frame.rows );
+            cv::perspectiveTransform( img_corners, new_img_corners, neighbour.homography_matrix );
+
+            int height = image.rows,
+                    width = image.cols;
+            for ( int i = 0 ; i < 4 ; i++ ) {
+                width = std::max(width, int(ceil(new_img_corners[i].x)));
+                height = std::max(height, int(ceil(new_img_corners[i].y)));
             }
+
+            if ( !checkHomographyConsistency( new_img_corners ) || width > 4 * neighbour_frame.cols || height > 4 * neighbour_frame.rows )
+                continue;
+
+            // The corners are in the order of a Z, the polygon goes around them.
+            const int polygon_order[4] = { 0 , 1 , 3 , 2 };
+            cv::Point polygon[4];
+            for ( int i = 0 ; i < 4 ; i++ )
+                polygon[i] = cv::Point( cvRound( ( new_img_corners[polygon_order[i]].x - plan_area.x ) / RECONSTRUCTION_PLAN_SCALE ) ,
+                                        cvRound( ( new_img_corners[polygon_order[i]].y - plan_area.y ) / RECONSTRUCTION_PLAN_SCALE ) );
+
+            neighbour.footprint = cv::Mat::zeros(plan_size, CV_8UC1);
+            cv::fillConvexPoly( neighbour.footprint , polygon , 4 , cv::Scalar(255) );
+
+            // Neighbours that do not cover anything new are not warped.
+            ScratchArena::Buffer gain ( plan_size , CV_8UC1 );
+            cv::bitwise_not( planned_coverage , gain.mat );
+            cv::bitwise_and( neighbour.footprint , gain.mat , gain.mat );
+            if ( !fallback && cv::countNonZero(gain.mat) == 0 )
+                continue;
+
+            planned_coverage |= neighbour.footprint;
+            plan.push_back(neighbour);
         }
-    } else if(reconstruction_type == ONLY_PRE) {
-        for ( int i = 0 ; i < NUM_MAX_IMAGES_TO_RECONSTRUCT ; i++ ) {
-            reconstructed_image = result.clone();
-            reconstructed_image_mask = result_mask.clone();
-
-            warpMaskCrop( frame_buffer[i] , reconstructed_image , reconstructed_image_mask , result , result_mask );
-            reconstructed_image = result.clone();
-            reconstructed_image_mask = result_mask.clone();
-
-//            if ( DEBUG_RECONSTRUCTION ){
-//                cv::rectangle( result , frame_boundaries , cv::Scalar(0,255,0) , 2 ) ;
-//                cv::rectangle( result , drop_boundaries , cv::Scalar(255,0,0) , 2 ) ;
-//            }
-//            EXECUTE_VIEW;
-
-            if ( checkImageBoundariesMask( reconstructed_image_mask , frame_boundaries ) ) {
-                //EXECUTE_VIEW;
-                // ---------------------------------------------------------------------------
-                // DEBUG
-                if ( DEBUG_RECONSTRUCTION )
-                   std::cout << "Done with reconstruction using " << i << " frames." << std::endl;
-                // ---------------------------------------------------------------------------
-                video.release();
-                return true;
-            }
+
+        // Step 2: drop the neighbours whose area is covered by the others, from the closest, which were chosen first.
+        for ( unsigned int i_drop = 0 ; !fallback && i_drop < plan.size() && plan.size() > 1 ; ) {
+            ScratchArena::Buffer others ( plan_size , CV_8UC1 );
+            base_coverage.copyTo( others.mat );
+            for ( unsigned int i = 0 ; i < plan.size() ; i++ )
+                if ( i != i_drop )
+                    cv::bitwise_or( others.mat , plan[i].footprint , others.mat );
+
+            if ( getUncoveredRatio( others.mat , whole_plan ) < MAXIMUM_AREA_ALLOWED )
+                plan.erase( plan.begin() + i_drop );
+            else
+                i_drop++;
         }
-    } else {
-        for ( int i = frame_buffer.size() - NUM_MAX_IMAGES_TO_RECONSTRUCT ; i < frame_buffer.size() ; i++ ) {
-            reconstructed_image = result.clone();
-            reconstructed_image_mask = result_mask.clone();
-
-            warpMaskCrop( frame_buffer[i] , reconstructed_image , reconstructed_image_mask , result , result_mask );
-            reconstructed_image = result.clone();
-            reconstructed_image_mask = result_mask.clone();
-
-//            if ( DEBUG_RECONSTRUCTION ){
-//                cv::rectangle( result , frame_boundaries , cv::Scalar(0,255,0) , 2 ) ;
-//                cv::rectangle( result , drop_boundaries , cv::Scalar(255,0,0) , 2 ) ;
-//            }
-//            EXECUTE_VIEW;
-
-            if ( checkImageBoundariesMask( reconstructed_image_mask , frame_boundaries ) ) {
-                //EXECUTE_VIEW;
-                // ---------------------------------------------------------------------------
-                // DEBUG
-                if ( DEBUG_RECONSTRUCTION )
-                   std::cout << "Done with reconstruction using " << i << " frames." << std::endl;
-                // ---------------------------------------------------------------------------
-                video.release();
-                return true;
-            }
+
+        // Step 3: warp the chosen neighbours, each one filling only the pixels still empty.
+        for ( unsigned int i = 0 ; i < plan.size() ; i++ ) {
+            window.getFrame( plan[i].index , neighbour_frame );
+
+            ScratchArena::Buffer warped_frame ( image.size() , neighbour_frame.type() ),
+                    warped_mask ( image.size() , CV_8UC1 ),
+                    overlap ( image.size() , CV_8UC1 ),
+                    new_area ( image.size() , CV_8UC1 ),
+                    seam ( image.size() , CV_8UC1 );
+
+            warpPerspectiveBilinear( neighbour_frame , plan[i].homography_matrix , image.size() , warped_frame.mat , warped_mask.mat );
+
+            // The seam is the border between the content already in the image and the new one, as in the warpMaskCrop.
+            cv::bitwise_and( coverage_mask , warped_mask.mat , overlap.mat );
+            cv::bitwise_not( coverage_mask , new_area.mat );
+            cv::bitwise_and( warped_mask.mat , new_area.mat , new_area.mat );
+
+            warped_frame.mat.copyTo( reconstructed_image , new_area.mat );
+            cv::bitwise_or( coverage_mask , warped_mask.mat , coverage_mask );
+
+            cv::dilate( overlap.mat , overlap.mat , structuring_element );
+            cv::dilate( new_area.mat , new_area.mat , structuring_element );
+            cv::bitwise_and( overlap.mat , new_area.mat , seam.mat );
+            cv::bitwise_or( seam_mask , seam.mat , seam_mask );
+            num_warps++;
         }
+
+        if ( getUncoveredRatio( coverage_mask , frame_boundaries ) < MAXIMUM_AREA_ALLOWED )
+            break;
+
+        // The warped images did not fill what was predicted, so the remaining neighbours are warped one by one.
+        fallback = true;
+        cv::resize( coverage_mask(plan_area) , planned_coverage , plan_size , 0 , 0 , cv::INTER_NEAREST );
     }
 
-    //EXECUTE_VIEW;
-    video.release();
+    if ( cv::countNonZero(seam_mask) > 0 )
+        cv::inpaint( reconstructed_image , seam_mask , reconstructed_image , 1 , cv::INPAINT_TELEA );
 
-    return false;
+    bool filled = getUncoveredRatio( coverage_mask , frame_boundaries ) < MAXIMUM_AREA_ALLOWED;
+
+    // ---------------------------------------------------------------------------
+    // DEBUG
+    if ( DEBUG_RECONSTRUCTION ) {
+        std::cout << ( filled ? "Done" : "Failed" ) << " with reconstruction warping " << num_warps << " of " << next_candidate << " neighbours." << std::endl;
+        cv::rectangle( reconstructed_image , frame_boundaries , cv::Scalar(0,255,0) , 2 ) ;
+        cv::rectangle( reconstructed_image , drop_boundaries , cv::Scalar(0,0,255) , 2 ) ;
+    }
+    // ---------------------------------------------------------------------------
+
+    return filled;
 }
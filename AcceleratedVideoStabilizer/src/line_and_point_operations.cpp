@@ -195,3 +195,71 @@ void computeAnglesAndMags( const std::vector<cv::Point2f>& points_src , const st
     }
 }
 
+/**
+ * @brief Function that keeps the part of a polygon on one side of an axis-aligned line.
+ *
+ * @param polygon - vertices of the polygon.
+ * @param axis - 0 for a vertical line (x = bound) and 1 for a horizontal line (y = bound).
+ * @param bound - position of the line.
+ * @param keep_greater - keeps the side where the coordinate is greater than the bound if true, the other side otherwise.
+ * @param clipped - object to save the vertices of the clipped polygon.
+ *
+ * @return \c void
+ *
+ * @date 17/10/2026
+ */
+static void clipPolygonBySide( const std::vector<cv::Point2d>& polygon, const int axis, const double bound, const bool keep_greater,
+                               std::vector<cv::Point2d>& clipped ) {
+    clipped.clear();
+
+    for (unsigned int i = 0; i < polygon.size(); ++i) {
+        const cv::Point2d &current = polygon[i],
+                &next = polygon[(i + 1) % polygon.size()];
+
+        double current_distance = (axis == 0 ? current.x : current.y) - bound,
+                next_distance = (axis == 0 ? next.x : next.y) - bound;
+        if ( !keep_greater ) {
+            current_distance = -current_distance;
+            next_distance = -next_distance;
+        }
+
+        if ( current_distance >= 0 )
+            clipped.push_back(current);
+
+        // The edge crosses the line, so the crossing point is also a vertex.
+        if ( (current_distance >= 0) != (next_distance >= 0) ) {
+            double t = current_distance / (current_distance - next_distance);
+            clipped.push_back(cv::Point2d(current.x + t * (next.x - current.x), current.y + t * (next.y - current.y)));
+        }
+    }
+}
+
+/**
+ * @brief Function that computes the area of the part of a polygon that lies inside a rectangle. The polygon is clipped by
+ *          the four sides of the rectangle (Sutherland-Hodgman) and the area of the result is given by the shoelace formula.
+ *
+ * @param polygon - vertices of the polygon, in clockwise or counterclockwise order.
+ * @param rect - rectangle used to clip the polygon.
+ *
+ * @return \c double - area of the polygon inside the rectangle.
+ *
+ * @date 17/10/2026
+ */
+double polygonAreaInsideRect( const std::vector<cv::Point2d>& polygon , const cv::Rect& rect )
+{
+    std::vector<cv::Point2d> clipped = polygon, buffer;
+
+    clipPolygonBySide(clipped, 0, rect.x, true, buffer);                 clipped.swap(buffer);
+    clipPolygonBySide(clipped, 0, rect.x + rect.width, false, buffer);   clipped.swap(buffer);
+    clipPolygonBySide(clipped, 1, rect.y, true, buffer);                 clipped.swap(buffer);
+    clipPolygonBySide(clipped, 1, rect.y + rect.height, false, buffer);  clipped.swap(buffer);
+
+    double area = 0;
+    for (unsigned int i = 0; i < clipped.size(); ++i) {
+        const cv::Point2d &current = clipped[i],
+                &next = clipped[(i + 1) % clipped.size()];
+        area += current.x * next.y - next.x * current.y;
+    }
+
+    return std::abs(area) / 2;
+}
@@ -25,6 +25,13 @@
 
 #include <stdio.h>
 #include <iomanip>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 #include <time.h>
 
@@ -48,14 +55,24 @@
 #include "headers/line_and_point_operations.h"
 #include "headers/image_reconstruction.h"
 #include "headers/message_handler.h"
+#include "headers/feature_store.h"
+#include "headers/feature_extractor.h"
+#include "headers/feature_matcher.h"
+#include "headers/blocking_queue.h"
+#include "headers/scratch_arena.h"
+#include "headers/video_sink.h"
+#include "headers/perspective_warp.h"
+#include "headers/candidate_score_cache.h"
 
 int log_number_length,
-num_of_reconstructed_frames = 0 ,
-num_of_dropped_frames = 0 ,
-num_of_good_frames = 0 ,
-num_of_fails_in_homography = 0,
 saved_frames = 0;
 
+// Updated by the stabilization workers, so they are atomic.
+std::atomic<int> num_of_reconstructed_frames(0) ,
+num_of_dropped_frames(0) ,
+num_of_good_frames(0) ,
+num_of_fails_in_homography(0);
+
 EXPERIMENT experiment_settings;
 
 /**
@@ -77,35 +94,128 @@ std::string getItFormatted(int frame_number);
  * @author Washington Luis de Souza Ramos
  * @date 10/09/2016
  */
-void writeToOutput(cv::VideoWriter& save_video, cv::Mat& image, uint frame_number);
+void writeToOutput(VideoSink& save_video, cv::Mat& image, uint frame_number);
+
+/**
+ * @brief The FrameState enum - States of the stabilization of an output frame. The frame starts in FRAME_KEEP and ends
+ *          in FRAME_KEEP, FRAME_RECONSTRUCT or FRAME_GIVE_UP.
+ */
+enum FrameState {
+                    FRAME_KEEP,/** The frame is kept if its homography covers the crop area **/
+                    FRAME_RECONSTRUCT,/** The frame only covers the drop area, so it is reconstructed with its neighbours **/
+                    FRAME_RESELECT,/** A new frame is selected in the original video **/
+                    FRAME_GIVE_UP/** The attempts are over, and the last selected frame is used without homography **/
+                   };
+
+/**
+ * @brief The FrameOutcome struct - Record of how an output frame was stabilized.
+ */
+struct FrameOutcome {
+    int frame_number;
+    int selected_frame;/** Index, in the original video, of the frame used in the output **/
+    FrameState state;/** The final state of the frame **/
+    int attempts;/** Number of new frames selected in the original video **/
+    int failed_reconstructions;
+};
+
+/**
+ * @brief runFrameStateMachine - Stabilizes an output frame, moving through the FrameState states until a final one. The
+ *          selection of the frame is only written in the outcome, so frames whose neighbours are not being replaced can
+ *          run at the same time.
+ * @param input_frame
+ * @param homography_matrix
+ * @param drop_area
+ * @param crop_area
+ * @param frame_number
+ * @param selected_frame - Index of the input frame in the original video
+ * @param select_new_frame - Selects a frame to replace the given one, returning its index and its image
+ * @param find_homography - Finds the homography of a selected frame given its features
+ * @param settings - The settings used by the reconstruction
+ * @param msg_buffer - The buffer of the frame messages
+ * @param stable_frame - Crop area of the stabilized frame
+ * @return The outcome of the frame
+ *
+ * @date 17/10/2026
+ */
+FrameOutcome runFrameStateMachine(const cv::Mat& input_frame, const cv::Mat& homography_matrix,
+                    const cv::Rect& drop_area, const cv::Rect& crop_area, int frame_number, int selected_frame,
+                    const std::function<int(const int, cv::Mat&)>& select_new_frame,
+                    const std::function<bool(const std::vector<cv::KeyPoint>&, const cv::Mat&, cv::Mat&)>& find_homography,
+                    const EXPERIMENT& settings, MessageBuffer& msg_buffer, cv::Mat& stable_frame);
 
 /**
- * @brief getStableFrame - Returns a frame stabilized given the parameters.
+ * @brief getStableFrameTemporally - Returns a frame stabilized given the parameters.
  * @param input_frame
  * @param homography_matrix
  * @param drop_area
  * @param crop_area
  * @param frame_number
- * @param d
- * @param D
- * @param selected_frames
+ * @param d - Temporal distance to the previous master
+ * @param D - Temporal distance between the masters
+ * @param selected_frames - Only read, the caller stores the selected frame of the outcome
+ * @param master_pre - Index of the previous master frame
+ * @param master_pos - Index of the posterior master frame
  * @param image_master_pre
  * @param image_master_pos
- * @param trial - The number of the current attempt
- * @param stable_frame
+ * @param settings - The settings used by the reconstruction and by the selection
+ * @param msg_buffer - The buffer of the frame messages
+ * @param stable_frame - Crop area of the stabilized frame
+ * @return The outcome of the frame
  *
  * @author Washington Luis de Souza Ramos
  * @date 10/09/2016
  */
-void getStableFrameTemporally(cv::Mat& input_frame, cv::Mat& homography_matrix,
+FrameOutcome getStableFrameTemporally(cv::Mat& input_frame, cv::Mat& homography_matrix,
                     const cv::Rect& drop_area, const cv::Rect& crop_area,
-                    int frame_number, int d, int D, cv::vector<int> &selected_frames,
+                    int frame_number, int d, int D, const cv::vector<int> &selected_frames, int master_pre, int master_pos,
                     const std::vector<cv::KeyPoint> &keypoints_master_pre,
                     const std::vector<cv::KeyPoint> &keypoints_master_pos, const cv::Mat &descriptors_master_pre,
-                    const cv::Mat &descriptors_master_pos, int attempt, MessageHandler& msg_handler, cv::Mat& stable_frame);
+                    const cv::Mat &descriptors_master_pos, const EXPERIMENT& settings, MessageBuffer& msg_buffer, cv::Mat& stable_frame);
 
 /**
- * @brief getStableFrameTemporally - Returns a frame stabilized given the parameters.
+ * @brief The MasterFeatures struct - Features of a master frame, loaded once and shared by the two segments around it.
+ */
+struct MasterFeatures {
+    int frame_number;
+    std::once_flag loaded;
+    std::vector<cv::KeyPoint> keypoints;
+    cv::Mat descriptors;
+};
+
+/**
+ * @brief loadMasterFeatures - Loads the features of a master frame the first time they are requested, reading the frame
+ *          only if they are not stored. Safe to be called by several threads.
+ * @param feature_store - The feature store of the accelerated video
+ * @param master - The master frame
+ * @return The master with its features loaded
+ *
+ * @date 17/10/2026
+ */
+const MasterFeatures& loadMasterFeatures(FeatureStore& feature_store, MasterFeatures& master);
+
+/**
+ * @brief The PipelineFrame struct - Frame traveling through the stabilization pipeline.
+ */
+struct PipelineFrame {
+    int frame_number, d;
+    bool is_master, homography_found;
+    cv::Mat frame, homography_matrix, result;
+    FrameOutcome outcome;
+    MessageBuffer msg_buffer;
+    std::promise<void> done;/** Set when the frame leaves the workers **/
+};
+
+/**
+ * @brief The PipelineSegment struct - Frames between two masters, stabilized by a single worker.
+ */
+struct PipelineSegment {
+    int i_master, D;
+    int first_frame, last_frame;/** Range [first_frame, last_frame) of the segment inside the processed range **/
+    std::vector< std::shared_ptr<PipelineFrame> > frames;
+};
+
+/**
+ * @brief getStableFrameSpatially - Returns a frame stabilized given the parameters.
  * @param input_frame
  * @param homography_matrix
  * @param drop_area
@@ -113,22 +223,24 @@ void getStableFrameTemporally(cv::Mat& input_frame, cv::Mat& homography_matrix,
  * @param frame_number
  * @param s - Spatial distance to the previous master (using the instability costs)
  * @param S - Spatial distance between the masters (using the instability costs)
- * @param selected_frames
+ * @param selected_frames - Only read, the caller stores the selected frame of the outcome
+ * @param master_pre - Index of the previous master frame
+ * @param master_pos - Index of the posterior master frame
  * @param image_master_pre
  * @param image_master_pos
- * @param trial - The number of the current attempt
  * @param msg_handler - The message handler
- * @param stable_frame
+ * @param stable_frame - Crop area of the stabilized frame
+ * @return The outcome of the frame
  *
  * @author Washington Luis de Souza Ramos
  * @date 10/09/2016
  */
-void getStableFrameSpatially(cv::Mat& input_frame, cv::Mat& homography_matrix,
+FrameOutcome getStableFrameSpatially(cv::Mat& input_frame, cv::Mat& homography_matrix,
                     const cv::Rect &drop_area, const cv::Rect &crop_area,
-                    int frame_number, float s, float S, cv::vector<int> &selected_frames,
+                    int frame_number, float s, float S, const cv::vector<int> &selected_frames, int master_pre, int master_pos,
                     const std::vector<cv::KeyPoint> &keypoints_master_pre, const std::vector<cv::KeyPoint> &keypoints_master_pos,
                     const cv::Mat &descriptors_master_pre, const cv::Mat &descriptors_master_pos,
-                    int attempt, MessageHandler &msg_handler, cv::Mat& stable_frame);
+                    MessageHandler &msg_handler, cv::Mat& stable_frame);
 
 // Get current date/time, format is YYYY-MM-DD.HH:mm:ss
 const std::string currentDateTime() {
@@ -166,7 +278,11 @@ const std::string currentDateTime() {
  * \b -8 - Can not create log text file. \n
  * \b -9 - Range limits is not well defined. \n
  * \b -10 - Can not open the CSV file with the semantic costs of the original video. \n
- * \b -11 - transition from frame_src to frame_dst larger than number of transitions describle int the file the semantic costs
+ * \b -11 - transition from frame_src to frame_dst larger than number of transitions describle int the file the semantic costs \n
+ * \b -13 - Unknown descriptor matcher in the settings file. \n
+ * \b -14 - Unknown feature detector in the settings file. \n
+ * \b -15 - Unknown master frames schedule in the settings file. \n
+ * \b -16 - Unknown video codec in the settings file.
  *
  * @param argc - number of parameters in argv.
  * @param argv - < Settings_file > [ Range_min = 0 ] [ Range_max = num_frames ]
@@ -192,6 +308,32 @@ int main( int argc , char* argv[] )
 
     EXECUTE_EXPERIMENT_ID;
 
+    FeatureType feature_type;
+    if ( !FeatureExtractor::parseType(experiment_settings.feature_detector, feature_type) ) {
+        std::cerr << " --(!) ERROR: Unknown feature detector \"" << experiment_settings.feature_detector << "\"." << std::endl;
+        exit(-14);
+    }
+    FeatureExtractor::setType(feature_type);
+
+    MatcherType matcher_type;
+    if ( !FeatureMatcher::parseType(experiment_settings.descriptor_matcher, matcher_type) ) {
+        std::cerr << " --(!) ERROR: Unknown descriptor matcher \"" << experiment_settings.descriptor_matcher << "\"." << std::endl;
+        exit(-13);
+    }
+    FeatureMatcher::setType(matcher_type);
+
+    MasterSchedule master_schedule;
+    if ( !parseMasterSchedule(experiment_settings.master_schedule, master_schedule) ) {
+        std::cerr << " --(!) ERROR: Unknown master frames schedule \"" << experiment_settings.master_schedule << "\"." << std::endl;
+        exit(-15);
+    }
+
+    int video_codec;
+    if ( !VideoSink::parseCodec(experiment_settings.video_codec, video_codec) ) {
+        std::cerr << " --(!) ERROR: Unknown video codec \"" << experiment_settings.video_codec << "\"." << std::endl;
+        exit(-16);
+    }
+
     cv::VideoCapture video (experiment_settings.video_filename);
 
     if ( !video.isOpened() ) {
@@ -217,6 +359,10 @@ int main( int argc , char* argv[] )
     std::vector<int> master_frames = getMasterFrames( experiment_settings , num_frames ), selected_frames;
     readSelectedFramesCSV(experiment_settings.selected_frames_filename, selected_frames);
 
+    // The semantic costs are read only once and shared by every frame selection.
+    if ( !experiment_settings.semantic_costs_filename.empty() )
+        loadSemanticCostTable(experiment_settings);
+
     switch ( argc ) {
     case 2:
         range_min = 0;
@@ -261,12 +407,11 @@ int main( int argc , char* argv[] )
                               video_width  - (2 * video_width * DROP_PORTION),
                               video_height - (2 * video_height * DROP_PORTION));
 
-    cv::VideoWriter save_video;
+    VideoSink save_video;
 
     if ( experiment_settings.save_video_in_disk ) {
-        save_video = cv::VideoWriter( experiment_settings.save_video_filename , CV_FOURCC('m','p','4','v') ,
-                                      video.get(CV_CAP_PROP_FPS) , cv::Size(crop_area.width , crop_area.height) );
-        if ( !save_video.isOpened() ){
+        if ( !save_video.open( experiment_settings.save_video_filename , video_codec ,
+                               video.get(CV_CAP_PROP_FPS) , cv::Size(crop_area.width , crop_area.height) ) ){
             std::cerr << " --(!) ERROR: Can not create file \"" << experiment_settings.save_video_filename << "\" to save the video." << std::endl;
             exit(-4);
         }
@@ -274,16 +419,35 @@ int main( int argc , char* argv[] )
 
     MessageHandler msg_handler(experiment_settings.log_file_name);
 
+    // ----------------------------------------------------------------------
+    // BENCHMARK
+    // The video is set to the first frame of the range before the processing.
+    if ( BENCHMARK_PERSPECTIVE_WARP ) {
+        cv::Mat benchmark_frame;
+        video >> benchmark_frame;
+        msg_handler.reportStatus(SSTR(std::endl << " --> Perspective warp of one frame, per homography:" << std::endl
+                                      << benchmarkPerspectiveWarp(benchmark_frame)), BOTH);
+    }
+
+    if ( BENCHMARK_FEATURE_MATCHER ) {
+        std::vector<cv::Mat> benchmark_frames;
+        cv::Mat benchmark_frame;
+        while ( int(benchmark_frames.size()) < MATCHER_BENCHMARK_FRAMES && video.read(benchmark_frame) )
+            benchmark_frames.push_back(benchmark_frame.clone());
+        msg_handler.reportStatus(SSTR(std::endl << " --> Feature matchers, " << benchmark_frames.size() << " frames:" << std::endl
+                                      << benchmarkFeatureMatcher(benchmark_frames)), BOTH);
+    }
+    // ----------------------------------------------------------------------
+
+    FeatureStore &feature_store = FeatureStore::getStore(experiment_settings.video_filename);
+
     std::vector<cv::KeyPoint> keypoints_frame_pre, keypoints_frame_pos, keypoints_current_frame;
 
-    cv::Mat image_master_pre ,
-            image_master_pos ,
-            current_frame ,
+    cv::Mat current_frame ,
             descriptors_frame_pre,
             descriptors_frame_pos,
             descriptors_current_frame,
             result,
-            result_cropped,
             homography_matrix;
 
     // ----------------------------------------------------------------------
@@ -303,15 +467,17 @@ int main( int argc , char* argv[] )
     //Increments the i_master until it reaches the range_min
     while ( master_frames[i_master+1] < range_min ) i_master++;
 
-    video.set( CV_CAP_PROP_POS_FRAMES , master_frames[i_master] );
-    video.read( image_master_pre );
-    video.set( CV_CAP_PROP_POS_FRAMES , master_frames[i_master+1] );
-    video.read( image_master_pos );
     video.set( CV_CAP_PROP_POS_FRAMES , range_min );
 
     //Loading the descriptors of the master frames
-    getKeypointsAndDescriptors(image_master_pre, keypoints_frame_pre, descriptors_frame_pre);
-    getKeypointsAndDescriptors(image_master_pos, keypoints_frame_pos, descriptors_frame_pos);
+    std::vector<MasterFeatures> master_features(master_frames.size());
+    for ( unsigned int i = 0 ; i < master_frames.size() ; i++ )
+        master_features[i].frame_number = master_frames[i];
+
+    keypoints_frame_pre = loadMasterFeatures(feature_store, master_features[i_master]).keypoints;
+    descriptors_frame_pre = master_features[i_master].descriptors;
+    keypoints_frame_pos = loadMasterFeatures(feature_store, master_features[i_master+1]).keypoints;
+    descriptors_frame_pos = master_features[i_master+1].descriptors;
 
     // -----------------------------------------------------------------------------------------------------------------------------------
     // LOG FILE
@@ -343,17 +509,24 @@ int main( int argc , char* argv[] )
         d = D - i;
         //s = instability_costs[i][d];
 
-        getKeypointsAndDescriptors(current_frame, keypoints_current_frame, descriptors_current_frame);
+        feature_store.getKeypointsAndDescriptors(i, current_frame, keypoints_current_frame, descriptors_current_frame);
 
         if ( findHomographyMatrix( keypoints_current_frame, keypoints_frame_pre, descriptors_current_frame, descriptors_frame_pre, homography_matrix ) ) {
 
-            //getStableFrameSpatially(current_frame, homography_matrix, drop_area, crop_area, i, s, S, selected_frames,
-            //               keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos, 1, msg_handler, result);
-            getStableFrameTemporally(current_frame, homography_matrix, drop_area, crop_area, i, d, D, selected_frames,
-                           keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos, 1, msg_handler, result);
+            //selected_frames[i] = getStableFrameSpatially(current_frame, homography_matrix, drop_area, crop_area, i, s, S, selected_frames,
+            //               master_frames[i_master], master_frames[i_master+1],
+            //               keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos, msg_handler, result).selected_frame;
+            MessageBuffer msg_buffer;
+            selected_frames[i] = getStableFrameTemporally(current_frame, homography_matrix, drop_area, crop_area, i, d, D, selected_frames,
+                           master_frames[i_master], master_frames[i_master+1],
+                           keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos,
+                           experiment_settings, msg_buffer, result).selected_frame;
+            msg_buffer.flush(msg_handler);
 
         } else {
-            result = current_frame.clone();
+            // The crop of the decoded frame is handed over, and the next frame is decoded into a new buffer.
+            result = current_frame(crop_area);
+            current_frame.release();
             num_of_fails_in_homography++;
             msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(i) << " | [F] Failed on finding a homography matrix to the first master." << std::endl), BOTH);
         }
@@ -362,8 +535,7 @@ int main( int argc , char* argv[] )
         /// WRITING THE RESULT TO THE OUTPUT ///
         ////////////////////////////////////////
         if ( experiment_settings.save_video_in_disk ){
-            result_cropped = result(crop_area);
-            writeToOutput(save_video, result_cropped, i);
+            writeToOutput(save_video, result, i);
         }
         //EXECUTE_VIEW
     }
@@ -374,7 +546,8 @@ int main( int argc , char* argv[] )
     if ( range_min < master_frames[0] ) {
         // First master frame without homography.
         video >> current_frame;
-        result = current_frame.clone();
+        result = current_frame(crop_area);
+        current_frame.release();
         msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(master_frames[0]) << " | [M] Kept. [Master]" << std::endl), LOG_FILE);
         num_of_good_frames++;
 
@@ -382,8 +555,7 @@ int main( int argc , char* argv[] )
         /// WRITING THE RESULT TO THE OUTPUT ///
         ////////////////////////////////////////
         if ( experiment_settings.save_video_in_disk ){
-            result_cropped = result(crop_area);
-            writeToOutput(save_video, result_cropped, master_frames[0]);
+            writeToOutput(save_video, result, master_frames[0]);
         }
         //EXECUTE_VIEW
     }
@@ -400,95 +572,175 @@ int main( int argc , char* argv[] )
             number = i_min + round((double)(i_max-i_min)/(double)percentage) ,
             cnt = 1;
 
-    for (int i = i_min; i < i_max; i++){
+    // The frames between two masters only depend on the features of those masters, so each segment is stabilized by a
+    // single worker, which decodes it sequentially with its own video reader. The new selection of a frame reads the
+    // selection of its neighbours, which are either the previous frames of the same worker or masters, that are never
+    // replaced, so the workers also replace the frames. This thread reports the messages and writes the frames in the
+    // original order.
+    const int num_workers = getNumberOfThreads(experiment_settings);
 
-        if(i == number) {
-            std::cout << " -> " << cnt*(100/percentage) << "% ";
-            cnt++;
-            number = i_min + round(cnt*((i_max-i_min)/percentage));
-            std::flush(std::cout);
-        }
+    // The workers already run in parallel, so each one scores the candidates of its selections by itself.
+    EXPERIMENT worker_settings = experiment_settings;
+    worker_settings.running_parallel = false;
 
-        if ( i != master_frames[i_master+1] ) {
-            //////////////////////////////////
-            /// THIS IS NOT A MASTER FRAME ///
-            //////////////////////////////////
+    BlockingQueue< std::shared_ptr<PipelineSegment> > pending_segments ( PIPELINE_SEGMENTS_PER_WORKER * num_workers ),
+            ordered_segments ( PIPELINE_SEGMENTS_PER_WORKER * num_workers );
 
-            d = i - master_frames[i_master];
-            //s = instability_costs[i][d];
-            //S = s + instability_costs[i][D - d];
+    int i_master_last = i_master;
 
-            video >> current_frame;
+    std::thread scheduler ( [&]() {
+        for ( int k = i_master ; k+1 < (int)master_frames.size() && master_frames[k] < i_max ; k++ ) {
 
-            // Test if it is possible obtain an intermediate homography matrix.
-            if ( findIntermediateHomographyMatrix( d, D, N, current_frame,
-                                                   keypoints_frame_pre, keypoints_frame_pos,
-                                                   descriptors_frame_pre, descriptors_frame_pos, homography_matrix ) ) {
+            std::shared_ptr<PipelineSegment> segment = std::make_shared<PipelineSegment>();
+            segment->i_master = k;
+            segment->D = master_frames[k+1] - master_frames[k];
+            segment->first_frame = std::max(master_frames[k], i_min);
+            segment->last_frame = std::min(master_frames[k+1], i_max);
 
-                //getStableFrameSpatially(current_frame, homography_matrix, drop_area, crop_area, i, s, S, selected_frames,
-                //               keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos, 1, msg_handler, result);
-                getStableFrameTemporally(current_frame, homography_matrix, drop_area, crop_area, i, d, D, selected_frames,
-                               keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos, 1, msg_handler, result);
+            if ( segment->first_frame >= segment->last_frame )
+                continue;
 
-            } else {
-                result = current_frame.clone();
-                num_of_fails_in_homography++;
-                msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(i) << " | [F] Failed on finding an intermediate homography." << std::endl), BOTH);
+            for ( int i = segment->first_frame ; i < segment->last_frame ; i++ ) {
+                std::shared_ptr<PipelineFrame> pipeline_frame = std::make_shared<PipelineFrame>();
+                pipeline_frame->frame_number = i;
+                pipeline_frame->is_master = ( i == master_frames[k] );
+                pipeline_frame->d = i - master_frames[k];
+                segment->frames.push_back(pipeline_frame);
             }
 
+            i_master_last = k;
 
-        } else {
-            // If current frame is a master frame update the master frame posterior, previous and the D value.
-            // Only show the master without homography.
+            ordered_segments.push(segment);
+            pending_segments.push(segment);
+        }
 
-            //////////////////////////////
-            /// THIS IS A MASTER FRAME ///
-            //////////////////////////////
+        pending_segments.close();
+        ordered_segments.close();
+    } );
 
-            i_master++;
+    std::vector<std::thread> workers;
+    for ( int i_worker = 0 ; i_worker < num_workers ; i_worker++ ) {
+        workers.push_back( std::thread( [&]() {
+            cv::VideoCapture segment_video;
+            int next_frame = -1;
 
-            // TODO: verify memory leak in the clone() method.
-            image_master_pre = image_master_pos.clone();
-            video.set(CV_CAP_PROP_POS_FRAMES, master_frames[i_master+1]);
-            video.read(image_master_pos);
-            video.set(CV_CAP_PROP_POS_FRAMES, i);
-            video.read(current_frame);
+            std::shared_ptr<PipelineSegment> segment;
+            std::vector<cv::KeyPoint> keypoints_frame;
+            cv::Mat descriptors_frame;
 
-            //Loading the descriptors of the new master frames
-            keypoints_frame_pre.swap(keypoints_frame_pos);
-            descriptors_frame_pre = descriptors_frame_pos.clone();
-            getKeypointsAndDescriptors(image_master_pos, keypoints_frame_pos, descriptors_frame_pos);
+            while ( pending_segments.pop(segment) ) {
 
-            result = current_frame.clone();
-            msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(i) << " | [M] Kept. [Master]" << std::endl), BOTH);
-            num_of_good_frames++;
+                const MasterFeatures &master_pre = loadMasterFeatures(feature_store, master_features[segment->i_master]),
+                        &master_pos = loadMasterFeatures(feature_store, master_features[segment->i_master+1]);
 
-            D = master_frames[i_master+1] - master_frames[i_master];
+                if ( !segment_video.isOpened() ) {
+                    segment_video.open(experiment_settings.video_filename);
+                    if ( !segment_video.isOpened() ) {
+                        std::cerr << " --(!) ERROR: Can not open the video \"" << experiment_settings.video_filename << "\"." << std::endl;
+                        exit(-3);
+                    }
+                }
 
-            // ----------------------------------------------------------------------
-            // DEBUG
-            //if ( DEBUG_INTERMEDIATE_FRAME )
-            //    msg_handler.reportStatus(SSTR("i: " << i << " | D: " << D << " | masterFrames[" << i_master << "]: " << master_frames[i_master]
-            //                 <<  " | masterFrames[" << i_master+1 <<"]: " << master_frames[i_master+1] << std::endl), SCREEN);
-            // ----------------------------------------------------------------------
+                // The reader is only positioned when this worker did not decode the previous segment.
+                if ( next_frame != segment->first_frame )
+                    segment_video.set(CV_CAP_PROP_POS_FRAMES, segment->first_frame);
+                next_frame = segment->last_frame;
+
+                for ( unsigned int j = 0 ; j < segment->frames.size() ; j++ ) {
+                    PipelineFrame &pipeline_frame = *segment->frames[j];
+
+                    segment_video >> pipeline_frame.frame;
+
+                    if ( !pipeline_frame.is_master ) {
+                        feature_store.getKeypointsAndDescriptors(pipeline_frame.frame_number, pipeline_frame.frame, keypoints_frame, descriptors_frame);
+
+                        // Test if it is possible obtain an intermediate homography matrix.
+                        pipeline_frame.homography_found = findIntermediateHomographyMatrix( pipeline_frame.d, segment->D, N, keypoints_frame, descriptors_frame,
+                                                                                            master_pre.keypoints, master_pos.keypoints,
+                                                                                            master_pre.descriptors, master_pos.descriptors,
+                                                                                            pipeline_frame.homography_matrix );
+
+                        if ( pipeline_frame.homography_found ) {
+                            pipeline_frame.outcome = getStableFrameTemporally(pipeline_frame.frame, pipeline_frame.homography_matrix, drop_area, crop_area,
+                                                                              pipeline_frame.frame_number, pipeline_frame.d, segment->D, selected_frames,
+                                                                              master_pre.frame_number, master_pos.frame_number,
+                                                                              master_pre.keypoints, master_pos.keypoints,
+                                                                              master_pre.descriptors, master_pos.descriptors,
+                                                                              worker_settings, pipeline_frame.msg_buffer, pipeline_frame.result);
+                            selected_frames[pipeline_frame.frame_number] = pipeline_frame.outcome.selected_frame;
+                        }
+                    }
+
+                    pipeline_frame.done.set_value();
+                }
+            }
+        } ) );
+    }
 
-        }
+    std::shared_ptr<PipelineSegment> segment;
+    while ( ordered_segments.pop(segment) ) {
+        for ( unsigned int j = 0 ; j < segment->frames.size() ; j++ ) {
+            std::shared_ptr<PipelineFrame> pipeline_frame;
+            pipeline_frame.swap(segment->frames[j]);
 
-        ////////////////////////////////////////
-        /// WRITING THE RESULT TO THE OUTPUT ///
-        ////////////////////////////////////////
-        if ( experiment_settings.save_video_in_disk ){
-            result_cropped = result(crop_area);
-            writeToOutput(save_video, result_cropped, i);
+            int i = pipeline_frame->frame_number;
+
+            if(i == number) {
+                std::cout << " -> " << cnt*(100/percentage) << "% ";
+                cnt++;
+                number = i_min + round(cnt*((i_max-i_min)/percentage));
+                std::flush(std::cout);
+            }
+
+            pipeline_frame->done.get_future().wait();
+
+            if ( pipeline_frame->is_master ) {
+                // Only show the master without homography.
+                result = pipeline_frame->frame(crop_area);
+                msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(i) << " | [M] Kept. [Master]" << std::endl), BOTH);
+                num_of_good_frames++;
+
+            } else if ( pipeline_frame->homography_found ) {
+                result = pipeline_frame->result;
+                pipeline_frame->msg_buffer.flush(msg_handler);
+
+            } else {
+                result = pipeline_frame->frame(crop_area);
+                num_of_fails_in_homography++;
+                msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(i) << " | [F] Failed on finding an intermediate homography." << std::endl), BOTH);
+            }
+
+            ////////////////////////////////////////
+            /// WRITING THE RESULT TO THE OUTPUT ///
+            ////////////////////////////////////////
+            if ( experiment_settings.save_video_in_disk ){
+                writeToOutput(save_video, result, i);
+            }
+            //EXECUTE_VIEW
         }
-        //EXECUTE_VIEW
     }
 
+    scheduler.join();
+    for ( unsigned int i_worker = 0 ; i_worker < workers.size() ; i_worker++ )
+        workers[i_worker].join();
+
+    // The masters of the last segment are used by the frames after the last master.
+    i_master = i_master_last;
+    D = master_frames[i_master+1] - master_frames[i_master];
+    keypoints_frame_pre = loadMasterFeatures(feature_store, master_features[i_master]).keypoints;
+    keypoints_frame_pos = loadMasterFeatures(feature_store, master_features[i_master+1]).keypoints;
+    descriptors_frame_pre = master_features[i_master].descriptors;
+    descriptors_frame_pos = master_features[i_master+1].descriptors;
+
+    if ( i_min < i_max )
+        video.set( CV_CAP_PROP_POS_FRAMES , i_max );
+
     //Processing the last master (No homography is required)
     if ( range_max > master_frames[master_frames.size()-1] ) {
         // Last master frame without homography.
         video >> current_frame;
-        result = current_frame.clone();
+        result = current_frame(crop_area);
+        current_frame.release();
         msg_handler.reportStatus(SSTR(" Frame : " << master_frames[master_frames.size()-1] << " | [M] Kept. [Master]" << std::endl), BOTH);
         num_of_good_frames++;
 
@@ -496,8 +748,7 @@ int main( int argc , char* argv[] )
         /// WRITING THE RESULT TO THE OUTPUT ///
         ////////////////////////////////////////
         if ( experiment_settings.save_video_in_disk ){
-            result_cropped = result(crop_area);
-            writeToOutput(save_video, result_cropped, master_frames[master_frames.size()-1]);
+            writeToOutput(save_video, result, master_frames[master_frames.size()-1]);
         }
         //EXECUTE_VIEW
     }
@@ -520,17 +771,24 @@ int main( int argc , char* argv[] )
         d = last_index - i;
         //s = instability_costs[i][d];
 
-        getKeypointsAndDescriptors(current_frame, keypoints_current_frame, descriptors_current_frame);
+        feature_store.getKeypointsAndDescriptors(i, current_frame, keypoints_current_frame, descriptors_current_frame);
 
         if ( findHomographyMatrix( keypoints_current_frame, keypoints_frame_pre, descriptors_current_frame, descriptors_frame_pre, homography_matrix ) ) {
 
-            //getStableFrameSpatially(current_frame, homography_matrix, drop_area, crop_area, i, s, S, selected_frames,
-            //               keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos, 1, msg_handler, result);
-            getStableFrameTemporally(current_frame, homography_matrix, drop_area, crop_area, i, d, D, selected_frames,
-                           keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos, 1, msg_handler, result);
+            //selected_frames[i] = getStableFrameSpatially(current_frame, homography_matrix, drop_area, crop_area, i, s, S, selected_frames,
+            //               master_frames[i_master], master_frames[i_master+1],
+            //               keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos, msg_handler, result).selected_frame;
+            MessageBuffer msg_buffer;
+            selected_frames[i] = getStableFrameTemporally(current_frame, homography_matrix, drop_area, crop_area, i, d, D, selected_frames,
+                           master_frames[i_master], master_frames[i_master+1],
+                           keypoints_frame_pre, keypoints_frame_pos, descriptors_frame_pre, descriptors_frame_pos,
+                           experiment_settings, msg_buffer, result).selected_frame;
+            msg_buffer.flush(msg_handler);
 
         } else {
-            result = current_frame.clone();
+            // The crop of the decoded frame is handed over, and the next frame is decoded into a new buffer.
+            result = current_frame(crop_area);
+            current_frame.release();
             num_of_fails_in_homography++;
             msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(i) << " | [F] Failed on finding a homography matrix to the last master." << std::endl), BOTH);
         }
@@ -539,8 +797,7 @@ int main( int argc , char* argv[] )
         /// WRITING THE RESULT TO THE OUTPUT ///
         ////////////////////////////////////////
         if ( experiment_settings.save_video_in_disk ){
-            result_cropped = result(crop_area);
-            writeToOutput(save_video, result_cropped, i);
+            writeToOutput(save_video, result, i);
         }
         //EXECUTE_VIEW
     }
@@ -550,15 +807,22 @@ int main( int argc , char* argv[] )
 
     msg_handler.reportStatus(SSTR(std::endl), BOTH);
 
+    // Waits for the frames still in the queue of the encoder.
+    save_video.release();
+
     if ( experiment_settings.save_video_in_disk ) {
         msg_handler.reportStatus(SSTR(" --> Stabilized video saved in: " << std::endl
                                       << experiment_settings.save_video_filename << std::endl
                                       << "Number of frames saved: " << saved_frames << std::endl
+                                      << "Maximum depth of the encoder queue: " << save_video.getMaxQueueDepth() << " of " << VIDEO_SINK_QUEUE_SIZE
+                                      << " frames, " << save_video.getNumStalls() << " frames waited for the encoder" << std::endl
                                       << std::endl), SCREEN);
 
         msg_handler.reportStatus(SSTR(" --> Stabilized video saved in: " << std::endl
                                       << experiment_settings.save_video_filename << std::endl
                                       << "Number of frames saved: " << saved_frames << std::endl
+                                      << "Maximum depth of the encoder queue: " << save_video.getMaxQueueDepth() << " of " << VIDEO_SINK_QUEUE_SIZE
+                                      << " frames, " << save_video.getNumStalls() << " frames waited for the encoder" << std::endl
                                       << std::endl), LOG_FILE);
     }
 
@@ -567,6 +831,8 @@ int main( int argc , char* argv[] )
                                   << ".Number of dropped frames: " << num_of_dropped_frames << std::endl
                                   << ".Number of good frames: " << num_of_good_frames << std::endl
                                   << ".Number of frames where homography has failed: " << num_of_fails_in_homography << std::endl
+                                  << ".Number of scratch buffers allocated: " << ScratchArena::getNumAllocations() << " in " << ScratchArena::getNumRequests() << " requests" << std::endl
+                                  << ".Number of candidate frames scored from the cache: " << CandidateScoreCache::getInstance().getNumHits() << " of " << CandidateScoreCache::getInstance().getNumLookups() << std::endl
                                   << std::endl), SCREEN);
 
     // -----------------------------------------------------------------------------------------------------------------------------------
@@ -576,10 +842,11 @@ int main( int argc , char* argv[] )
                                   << ".Number of dropped frames: " << num_of_dropped_frames << std::endl
                                   << ".Number of good frames: " << num_of_good_frames << std::endl
                                   << ".Number of frames where homography has failed: " << num_of_fails_in_homography << std::endl
+                                  << ".Number of scratch buffers allocated: " << ScratchArena::getNumAllocations() << " in " << ScratchArena::getNumRequests() << " requests" << std::endl
+                                  << ".Number of candidate frames scored from the cache: " << CandidateScoreCache::getInstance().getNumHits() << " of " << CandidateScoreCache::getInstance().getNumLookups() << std::endl
                                   << std::endl), LOG_FILE);
     // -----------------------------------------------------------------------------------------------------------------------------------
 
-    save_video.release();
     video.release();
 
     msg_handler.reportStatus(SSTR("\n Process finished: " << currentDateTime() << std::endl << std::endl), BOTH);
@@ -608,128 +875,206 @@ std::string getItFormatted(int frame_number){
  * @author Washington Luis de Souza Ramos
  * @date 10/09/2016
  */
-void writeToOutput(cv::VideoWriter& save_video, cv::Mat& image, uint frame_number){
+void writeToOutput(VideoSink& save_video, cv::Mat& image, uint frame_number){
     if ( FRAME_NUMBER_RESULT ){
         cv::putText(image, SSTR(getItFormatted(frame_number)), cv::Point(150,150), cv::FONT_HERSHEY_TRIPLEX, 2.5, cv::Scalar(0,0,255));
     }
-    save_video << image;
+    save_video.write(image);
     saved_frames++;
     //cv::imshow("Frame", image);
     //cv::waitKey(0);
 }
 
 /**
- * @brief getStableFrameTemporally - Returns a frame stabilized given the parameters.
+ * @brief runFrameStateMachine - Stabilizes an output frame, moving through the FrameState states until a final one. The
+ *          selection of the frame is only written in the outcome, so frames whose neighbours are not being replaced can
+ *          run at the same time.
  * @param input_frame
  * @param homography_matrix
  * @param drop_area
  * @param crop_area
  * @param frame_number
- * @param d - Temporal distance to the previous master
- * @param D - Temporal distance between the masters
- * @param selected_frames
- * @param image_master_pre
- * @param image_master_pos
- * @param trial - The number of the current attempt
- * @param msg_handler - The message handler
- * @param stable_frame
+ * @param selected_frame - Index of the input frame in the original video
+ * @param select_new_frame - Selects a frame to replace the given one, returning its index and its image
+ * @param find_homography - Finds the homography of a selected frame given its features
+ * @param settings - The settings used by the reconstruction
+ * @param msg_buffer - The buffer of the frame messages
+ * @param stable_frame - Crop area of the stabilized frame
+ * @return The outcome of the frame
  *
- * @author Washington Luis de Souza Ramos
- * @date 10/09/2016
+ * @date 17/10/2026
  */
-void getStableFrameTemporally(cv::Mat& input_frame, cv::Mat& homography_matrix,
-                    const cv::Rect &drop_area, const cv::Rect &crop_area,
-                    int frame_number, int d, int D, cv::vector<int> &selected_frames,
-                    const std::vector<cv::KeyPoint> &keypoints_master_pre, const std::vector<cv::KeyPoint> &keypoints_master_pos,
-                    const cv::Mat &descriptors_master_pre, const cv::Mat &descriptors_master_pos,
-                    int attempt, MessageHandler &msg_handler, cv::Mat& stable_frame){
-
-    cv::Mat reconstructed_frame;
-    int N = experiment_settings.segment_size;
-
-    //Get the coverage when applying the given homography to the frame
-    HomogCoverage coverage = getHomogCoverage(input_frame, homography_matrix, drop_area, crop_area);
-
-    if(coverage == CROP_AREA){
-
-        /// CASE 1: Homography makes it good, frame is kept.
-        msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [K] Kept." << std::endl), BOTH);
-        num_of_good_frames++;
-
-        applyHomographyMatrix( input_frame , homography_matrix , stable_frame );
-    }else if (coverage == DROP_AREA){
-
-        /// CASE 2: Homography makes it regular, frame needs to be reconstructed
-        if ( reconstructImage(input_frame , homography_matrix, selected_frames[frame_number], experiment_settings, drop_area, crop_area, reconstructed_frame) ){
-            stable_frame = reconstructed_frame.clone();
-            num_of_reconstructed_frames++;
-            msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [R] Reconstructed using the original video." << std::endl), BOTH);
-        } else {
+FrameOutcome runFrameStateMachine(const cv::Mat& input_frame, const cv::Mat& homography_matrix,
+                    const cv::Rect& drop_area, const cv::Rect& crop_area, int frame_number, int selected_frame,
+                    const std::function<int(const int, cv::Mat&)>& select_new_frame,
+                    const std::function<bool(const std::vector<cv::KeyPoint>&, const cv::Mat&, cv::Mat&)>& find_homography,
+                    const EXPERIMENT& settings, MessageBuffer& msg_buffer, cv::Mat& stable_frame){
+
+    FrameOutcome outcome = { frame_number , selected_frame , FRAME_KEEP , 0 , 0 };
+    FrameState state = FRAME_KEEP;
+    bool finished = false;
+
+    cv::Mat frame = input_frame, homography = homography_matrix, reconstructed_frame;
+
+    while ( !finished ) {
+        switch ( state ) {
+        case FRAME_KEEP: {
+            //Get the coverage when applying the given homography to the frame
+            HomogCoverage coverage = getHomogCoverage(frame, homography, drop_area, crop_area);
+
+            if ( coverage == CROP_AREA ) {
+                /// CASE 1: Homography makes it good, frame is kept.
+                msg_buffer.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [K] Kept." << std::endl), BOTH);
+                applyHomographyMatrix( frame , homography , crop_area , stable_frame );
+                finished = true;
+            } else if ( coverage == DROP_AREA ) {
+                /// CASE 2: Homography makes it regular, frame needs to be reconstructed
+                state = FRAME_RECONSTRUCT;
+            } else {
+                /// CASE 3: Homography makes it awful, a new frame needs to be selected
+                state = FRAME_RESELECT;
+            }
+            break;
+        }
+        case FRAME_RECONSTRUCT:
+            if ( reconstructImage(frame , homography, outcome.selected_frame, settings, drop_area, crop_area, reconstructed_frame) ) {
+                stable_frame = reconstructed_frame(crop_area);
+                msg_buffer.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [R] Reconstructed using the original video." << std::endl), BOTH);
+                finished = true;
+            } else {
+                /// CASE 2.1: Reconstruction failed, a new frame needs to be selected
+                msg_buffer.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [E] Reconstruction failed using " << NUM_MAX_IMAGES_TO_RECONSTRUCT
+                                             << " previous and posterior frames. A new frame will be selected in the original video." << std::endl), BOTH);
+                outcome.failed_reconstructions++;
+                state = FRAME_RESELECT;
+            }
+            break;
+        case FRAME_RESELECT: {
             cv::Mat new_frame;
-
-            // Failed on reconstructing the image. A new frame will be selected.
-            msg_handler.reportStatus(SSTR(" Frame : " << SSTR ( getItFormatted(frame_number) ) << " | [E] Reconstruction failed using " << NUM_MAX_IMAGES_TO_RECONSTRUCT
-                                          << " previous and posterior frames. A new frame will be selected in the original video." << std::endl), BOTH);
-
-            /// CASE 2.1: Homography makes it awful, a new frame needs to be selected
-            int new_frame_index = selectNewFrame ( d , D , N , selected_frames[frame_number] ,
-                                                   selected_frames[frame_number-1] , selected_frames[frame_number+1] ,
-                    keypoints_master_pre, keypoints_master_pos,
-                    descriptors_master_pre, descriptors_master_pos,
-                    crop_area , experiment_settings , new_frame );
-            selected_frames[frame_number] = new_frame_index ;
+            int new_frame_index = select_new_frame(outcome.selected_frame, new_frame);
+            outcome.attempts++;
 
             // Frame will be dropped because it does not cover the threshold area.
-            msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped, a new one was selected in the original video. Trying it again [" << attempt << "]..." << std::endl), BOTH);
+            msg_buffer.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped, a new one was selected in the original video. Trying it again [" << outcome.attempts << "]..." << std::endl), BOTH);
 
-            if(attempt <= MAX_DROP_ATTEMPTS){
+            // No candidate was selected, so the last tried frame is used.
+            if ( new_frame.empty() ) {
+                state = FRAME_GIVE_UP;
+                break;
+            }
 
-                if(attempt == 1)//Counts only one drop
-                    num_of_dropped_frames++;
+            frame = new_frame;
+            outcome.selected_frame = new_frame_index;
 
-                if ( findIntermediateHomographyMatrix( d , D , N , new_frame,
-                                                       keypoints_master_pre, keypoints_master_pos,
-                                                       descriptors_master_pre, descriptors_master_pos, homography_matrix ) ) {
-                    getStableFrameTemporally(new_frame, homography_matrix, drop_area, crop_area, frame_number, d, D, selected_frames,
-                                   keypoints_master_pre, keypoints_master_pos, descriptors_master_pre, descriptors_master_pos, ++attempt, msg_handler, stable_frame);
-                }
-            } else {
-                stable_frame = new_frame.clone();
-                msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped! Gave up on trying to reconstruct this frame. Using the original frame instead." << std::endl), BOTH);
+            // A frame selected again is tried again, since the attempt where the selection gives up decides the frame used.
+            if ( outcome.attempts > MAX_DROP_ATTEMPTS ) {
+                state = FRAME_GIVE_UP;
+                break;
             }
-            num_of_dropped_frames++;
+
+            std::vector<cv::KeyPoint> keypoints_new_frame;
+            cv::Mat descriptors_new_frame;
+            FeatureStore::getStore(settings.original_video_filename).getKeypointsAndDescriptors(new_frame_index, new_frame,
+                                                                                               keypoints_new_frame, descriptors_new_frame);
+
+            // Without a homography the new frame is replaced again, from its own position.
+            if ( find_homography(keypoints_new_frame, descriptors_new_frame, homography) )
+                state = FRAME_KEEP;
+            else
+                msg_buffer.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [F] Failed on finding an intermediate homography to the new frame." << std::endl), BOTH);
+            break;
+        }
+        case FRAME_GIVE_UP:
+            // The frame may be shared with the FrameCache, and the buffer of the result is written by the next frames.
+            stable_frame = frame(crop_area).clone();
+            msg_buffer.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped! Gave up on trying to reconstruct this frame. Using the original frame instead." << std::endl), BOTH);
+            finished = true;
+            break;
         }
+    }
 
-    }else{
-        cv::Mat new_frame;
+    outcome.state = state;
 
-        /// CASE 3: Homography makes it awful, a new frame needs to be selected
-        int new_frame_index = selectNewFrame ( d , D , N , selected_frames[frame_number] ,
-                                               selected_frames[frame_number-1], selected_frames[frame_number+1],
-                keypoints_master_pre, keypoints_master_pos,
-                descriptors_master_pre, descriptors_master_pos,
-                crop_area , experiment_settings , new_frame );
-        selected_frames[frame_number] = new_frame_index ;
+    // Each frame is counted once by its final state, and once as a drop if a new frame was selected.
+    if ( outcome.attempts > 0 )
+        num_of_dropped_frames++;
+    if ( outcome.state == FRAME_KEEP )
+        num_of_good_frames++;
+    else if ( outcome.state == FRAME_RECONSTRUCT )
+        num_of_reconstructed_frames++;
 
-        // Frame will be dropped because it does not cover the threshold area.
-        msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped, a new one was selected in the original video. Trying it again [" << attempt << "]..." << std::endl), BOTH);
+    const char *state_names[] = { "Keep" , "Reconstruct" , "Reselect" , "GiveUp" };
+    msg_buffer.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | Outcome: " << state_names[outcome.state]
+                                 << " | Selected frame: " << outcome.selected_frame << " | Attempts: " << outcome.attempts
+                                 << " | Failed reconstructions: " << outcome.failed_reconstructions << std::endl), LOG_FILE);
 
-        if(attempt <= MAX_DROP_ATTEMPTS){
+    return outcome;
+}
 
-            if(attempt == 1)//Counts only one drop
-                num_of_dropped_frames++;
+/**
+ * @brief getStableFrameTemporally - Returns a frame stabilized given the parameters.
+ * @param input_frame
+ * @param homography_matrix
+ * @param drop_area
+ * @param crop_area
+ * @param frame_number
+ * @param d - Temporal distance to the previous master
+ * @param D - Temporal distance between the masters
+ * @param selected_frames - Only read, the caller stores the selected frame of the outcome
+ * @param master_pre - Index of the previous master frame
+ * @param master_pos - Index of the posterior master frame
+ * @param image_master_pre
+ * @param image_master_pos
+ * @param settings - The settings used by the reconstruction and by the selection
+ * @param msg_buffer - The buffer of the frame messages
+ * @param stable_frame - Crop area of the stabilized frame
+ * @return The outcome of the frame
+ *
+ * @author Washington Luis de Souza Ramos
+ * @date 10/09/2016
+ */
+FrameOutcome getStableFrameTemporally(cv::Mat& input_frame, cv::Mat& homography_matrix,
+                    const cv::Rect &drop_area, const cv::Rect &crop_area,
+                    int frame_number, int d, int D, const cv::vector<int> &selected_frames, int master_pre, int master_pos,
+                    const std::vector<cv::KeyPoint> &keypoints_master_pre, const std::vector<cv::KeyPoint> &keypoints_master_pos,
+                    const cv::Mat &descriptors_master_pre, const cv::Mat &descriptors_master_pos,
+                    const EXPERIMENT& settings, MessageBuffer &msg_buffer, cv::Mat& stable_frame){
+
+    int N = settings.segment_size;
+
+    return runFrameStateMachine(input_frame, homography_matrix, drop_area, crop_area, frame_number, selected_frames[frame_number],
+                                [&]( const int index , cv::Mat &new_frame ) {
+        return selectNewFrame ( d , D , N , index , selected_frames[frame_number-1], selected_frames[frame_number+1], master_pre, master_pos,
+                                keypoints_master_pre, keypoints_master_pos, descriptors_master_pre, descriptors_master_pos,
+                                crop_area , settings , new_frame );
+    } , [&]( const std::vector<cv::KeyPoint> &keypoints_new_frame , const cv::Mat &descriptors_new_frame , cv::Mat &new_homography_matrix ) {
+        return findIntermediateHomographyMatrix( d , D , N , keypoints_new_frame, descriptors_new_frame,
+                                                 keypoints_master_pre, keypoints_master_pos,
+                                                 descriptors_master_pre, descriptors_master_pos, new_homography_matrix );
+    } , settings, msg_buffer, stable_frame);
+}
 
-            if ( findIntermediateHomographyMatrix( d , D , N , new_frame,
-                                                   keypoints_master_pre, keypoints_master_pos,
-                                                   descriptors_master_pre, descriptors_master_pos, homography_matrix ) ) {
-                getStableFrameTemporally(new_frame, homography_matrix, drop_area, crop_area, frame_number, d, D, selected_frames,
-                               keypoints_master_pre, keypoints_master_pos, descriptors_master_pre, descriptors_master_pos, ++attempt, msg_handler, stable_frame);
-            }
-        }else{
-            stable_frame = new_frame.clone();
-            msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped! Gave up on trying to reconstruct this frame. Using the original frame instead." << std::endl), BOTH);
-        }
-    }
+/**
+ * @brief loadMasterFeatures - Loads the features of a master frame the first time they are requested, reading the frame
+ *          only if they are not stored. Safe to be called by several threads.
+ * @param feature_store - The feature store of the accelerated video
+ * @param master - The master frame
+ * @return The master with its features loaded
+ *
+ * @date 17/10/2026
+ */
+const MasterFeatures& loadMasterFeatures(FeatureStore& feature_store, MasterFeatures& master){
+
+    std::call_once(master.loaded, [&]() {
+        if ( feature_store.lookup(master.frame_number, master.keypoints, master.descriptors) )
+            return;
+
+        cv::Mat image_master;
+        FrameCache::getInstance().getFrame(experiment_settings.video_filename, master.frame_number, image_master);
+        feature_store.getKeypointsAndDescriptors(master.frame_number, image_master, master.keypoints, master.descriptors);
+    } );
+
+    return master;
 }
 
 /**
@@ -741,105 +1086,39 @@ void getStableFrameTemporally(cv::Mat& input_frame, cv::Mat& homography_matrix,
  * @param frame_number
  * @param s - Spatial distance to the previous master (using the instability costs)
  * @param S - Spatial distance between the masters (using the instability costs)
- * @param selected_frames
+ * @param selected_frames - Only read, the caller stores the selected frame of the outcome
+ * @param master_pre - Index of the previous master frame
+ * @param master_pos - Index of the posterior master frame
  * @param image_master_pre
  * @param image_master_pos
- * @param trial - The number of the current attempt
  * @param msg_handler - The message handler
- * @param stable_frame
+ * @param stable_frame - Crop area of the stabilized frame
+ * @return The outcome of the frame
  *
  * @author Washington Luis de Souza Ramos
  * @date 10/09/2016
  */
-void getStableFrameSpatially(cv::Mat& input_frame, cv::Mat& homography_matrix,
+FrameOutcome getStableFrameSpatially(cv::Mat& input_frame, cv::Mat& homography_matrix,
                     const cv::Rect &drop_area, const cv::Rect &crop_area,
-                    int frame_number, float s, float S, cv::vector<int> &selected_frames,
+                    int frame_number, float s, float S, const cv::vector<int> &selected_frames, int master_pre, int master_pos,
                     const std::vector<cv::KeyPoint> &keypoints_master_pre, const std::vector<cv::KeyPoint> &keypoints_master_pos,
                     const cv::Mat &descriptors_master_pre, const cv::Mat &descriptors_master_pos,
-                    int attempt, MessageHandler &msg_handler, cv::Mat& stable_frame){
+                    MessageHandler &msg_handler, cv::Mat& stable_frame){
 
-    cv::Mat reconstructed_frame;
+    MessageBuffer msg_buffer;
 
-    //Get the coverage when applying the given homography to the frame
-    HomogCoverage coverage = getHomogCoverage(input_frame, homography_matrix, drop_area, crop_area);
+    FrameOutcome outcome = runFrameStateMachine(input_frame, homography_matrix, drop_area, crop_area, frame_number, selected_frames[frame_number],
+                                                [&]( const int index , cv::Mat &new_frame ) {
+        return selectNewFrame ( s, S, index , selected_frames[frame_number-1] , selected_frames[frame_number+1] , master_pre, master_pos,
+                                keypoints_master_pre, keypoints_master_pos, descriptors_master_pre, descriptors_master_pos,
+                                crop_area , experiment_settings , new_frame );
+    } , [&]( const std::vector<cv::KeyPoint> &keypoints_new_frame , const cv::Mat &descriptors_new_frame , cv::Mat &new_homography_matrix ) {
+        return findIntermediateHomographyMatrix( s, S, keypoints_new_frame, descriptors_new_frame,
+                                                 keypoints_master_pre, keypoints_master_pos,
+                                                 descriptors_master_pre, descriptors_master_pos, new_homography_matrix );
+    } , experiment_settings, msg_buffer, stable_frame);
 
-    if(coverage == CROP_AREA){
+    msg_buffer.flush(msg_handler);
 
-        /// CASE 1: Homography makes it good, frame is kept.
-        msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [K] Kept." << std::endl), BOTH);
-        num_of_good_frames++;
-
-        applyHomographyMatrix( input_frame , homography_matrix , stable_frame );
-    }else if (coverage == DROP_AREA){
-
-        /// CASE 2: Homography makes it regular, frame needs to be reconstructed
-        if ( reconstructImage(input_frame , homography_matrix, selected_frames[frame_number], experiment_settings, drop_area, crop_area, reconstructed_frame) ){
-            stable_frame = reconstructed_frame.clone();
-            num_of_reconstructed_frames++;
-            msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [R] Reconstructed using the original video." << std::endl), BOTH);
-        } else {
-            cv::Mat new_frame;
-
-            // Failed on reconstructing the image. A new frame will be selected.
-            msg_handler.reportStatus(SSTR(" Frame : " << SSTR ( getItFormatted(frame_number) ) << " | [E] Reconstruction failed using " << NUM_MAX_IMAGES_TO_RECONSTRUCT
-                                          << " previous and posterior frames. A new frame will be selected in the original video." << std::endl), BOTH);
-
-            /// CASE 2.1: Homography makes it awful, a new frame needs to be selected
-            int new_frame_index = selectNewFrame ( s, S, selected_frames[frame_number] ,
-                                                   selected_frames[frame_number-1] , selected_frames[frame_number+1] ,
-                    keypoints_master_pre, keypoints_master_pos,
-                    descriptors_master_pre, descriptors_master_pos,
-                    crop_area , experiment_settings , new_frame );
-            selected_frames[frame_number] = new_frame_index ;
-
-            // Frame will be dropped because it does not cover the threshold area.
-            msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped, a new one was selected in the original video. Trying it again [" << attempt << "]..." << std::endl), BOTH);
-
-            if(attempt <= MAX_DROP_ATTEMPTS){
-
-                if ( findIntermediateHomographyMatrix( s, S, new_frame,
-                                                       keypoints_master_pre, keypoints_master_pos,
-                                                       descriptors_master_pre, descriptors_master_pos, homography_matrix ) ) {
-                    getStableFrameSpatially(new_frame, homography_matrix, drop_area, crop_area, frame_number, s, S, selected_frames,
-                                   keypoints_master_pre, keypoints_master_pos, descriptors_master_pre, descriptors_master_pos, ++attempt, msg_handler, stable_frame);
-                }
-            } else {
-                stable_frame = new_frame.clone();
-                msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped! Gave up on trying to reconstruct this frame. Using the original frame instead." << std::endl), BOTH);
-            }
-            if(attempt == 1)//Counts only one drop
-                num_of_dropped_frames++;
-        }
-
-    }else{
-        cv::Mat new_frame;
-
-        /// CASE 3: Homography makes it awful, a new frame needs to be selected
-        int new_frame_index = selectNewFrame ( s, S, selected_frames[frame_number] ,
-                                               selected_frames[frame_number-1], selected_frames[frame_number+1],
-                keypoints_master_pre, keypoints_master_pos,
-                descriptors_master_pre, descriptors_master_pos,
-                crop_area , experiment_settings , new_frame );
-        selected_frames[frame_number] = new_frame_index ;
-
-        // Frame will be dropped because it does not cover the threshold area.
-        msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped, a new one was selected in the original video. Trying it again [" << attempt << "]..." << std::endl), BOTH);
-
-        if(attempt <= MAX_DROP_ATTEMPTS){
-
-            if ( findIntermediateHomographyMatrix( s, S, new_frame,
-                                                   keypoints_master_pre, keypoints_master_pos,
-                                                   descriptors_master_pre, descriptors_master_pos, homography_matrix ) ) {
-                getStableFrameSpatially(new_frame, homography_matrix, drop_area, crop_area, frame_number, s, S, selected_frames,
-                               keypoints_master_pre, keypoints_master_pos, descriptors_master_pre, descriptors_master_pos, ++attempt, msg_handler, stable_frame);
-            }
-        } else {
-            stable_frame = new_frame.clone();
-            msg_handler.reportStatus(SSTR(" Frame : " << getItFormatted(frame_number) << " | [D] Dropped! Gave up on trying to reconstruct this frame. Using the original frame instead." << std::endl), BOTH);
-        }
-
-        if(attempt == 1)//Counts only one drop
-            num_of_dropped_frames++;
-    }
+    return outcome;
 }
-
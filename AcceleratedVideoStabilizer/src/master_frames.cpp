@@ -25,6 +25,10 @@
  *
  */
 
+#include <algorithm>
+#include <chrono>
+#include <sstream>
+
 #include "executables/execute_commands.h"
 
 #include "headers/master_frames.h"
@@ -50,6 +54,93 @@ int length ( int number )
     return (counter);
 }
 
+/**
+ * @brief Function that chooses the master of a segment: the frame with the largest sum of RANSAC inliers of the
+ *          homographies from the other frames of the segment to it. Ties are won by the earlier frame.
+ *
+ * The pairs of frames are evaluated only when needed. With MASTER_SYMMETRIC_PAIRS, the inliers of a pair are computed
+ * once and used in both directions. A pair not evaluated yet has at most as many inliers as the keypoints of its source
+ * frame, so a candidate is abandoned as soon as its score plus this bound for the remaining pairs can not beat the best
+ * candidate. The candidates are tried from the one with more keypoints, which usually finds a good score first, and
+ * only one of each MASTER_CANDIDATE_STRIDE frames is a candidate.
+ *
+ * @param segment_keypoints - keypoints of each frame of the segment.
+ * @param segment_descriptors - descriptors of each frame of the segment.
+ * @param num_evaluations - object to save the number of homographies computed.
+ *
+ * @return \c int - index of the master in the segment.
+ *
+ * @date 17/10/2026
+ */
+static int findSegmentMaster ( const std::vector< std::vector< cv::KeyPoint > > &segment_keypoints ,
+                               const std::vector<cv::Mat> &segment_descriptors , int &num_evaluations ) {
+
+    const int size_segment = int(segment_keypoints.size());
+
+    // Inliers of the homography from the frame i to the frame j in pair_inliers[i*size_segment + j], -1 if not evaluated.
+    std::vector<int> pair_inliers ( size_segment * size_segment , -1 ),
+            max_pair_inliers ( size_segment , 0 ),
+            candidates;
+
+    for ( int i = 0 ; i < size_segment ; i++ ) {
+        if ( int(segment_keypoints[i].size()) >= MIN_NUMBER_OF_GOOD_MATCHES )
+            max_pair_inliers[i] = int(segment_keypoints[i].size());
+        if ( i % MASTER_CANDIDATE_STRIDE == 0 )
+            candidates.push_back(i);
+    }
+
+    std::stable_sort( candidates.begin() , candidates.end() , [&segment_keypoints] ( const int a , const int b ) {
+        return segment_keypoints[a].size() > segment_keypoints[b].size();
+    });
+
+    int max_inliers = 0,
+            master_index = 0;
+    num_evaluations = 0;
+
+    for ( unsigned int i_candidate = 0 ; i_candidate < candidates.size() ; i_candidate++ ) {
+
+        const int i_master = candidates[i_candidate];
+
+        // Upper bound of the score, exact when all the pairs are evaluated.
+        int bound = 0;
+        for ( int i_frame = 0 ; i_frame < size_segment ; i_frame++ )
+            if ( i_frame != i_master )
+                bound += pair_inliers[i_frame*size_segment + i_master] >= 0 ? pair_inliers[i_frame*size_segment + i_master]
+                                                                            : ( segment_keypoints[i_master].empty() ? 0 : max_pair_inliers[i_frame] );
+
+        for ( int i_frame = 0 ; i_frame < size_segment ; i_frame++ ) {
+
+            if ( bound < max_inliers || ( bound == max_inliers && i_master > master_index ) )
+                break;
+
+            int &inliers = pair_inliers[i_frame*size_segment + i_master];
+            if ( i_frame == i_master || inliers >= 0 )
+                continue;
+
+            inliers = 0;
+            if ( !segment_keypoints[i_master].empty() && max_pair_inliers[i_frame] > 0 ) {
+                // Only the number of inliers is used, so the homography is not refined.
+                inliers = countHomographyInliers(segment_keypoints[i_frame], segment_keypoints[i_master],
+                                                 segment_descriptors[i_frame], segment_descriptors[i_master]);
+                num_evaluations++;
+            }
+
+            bound += inliers - ( segment_keypoints[i_master].empty() ? 0 : max_pair_inliers[i_frame] );
+
+            if ( MASTER_SYMMETRIC_PAIRS )
+                pair_inliers[i_master*size_segment + i_frame] = inliers;
+        }
+
+        //Update master frame and inliers
+        if ( bound > max_inliers || ( bound == max_inliers && i_master < master_index ) ) {
+            master_index = i_master;
+            max_inliers = bound;
+        }
+    }
+
+    return master_index;
+}
+
 /**
  * @brief Function that calculates the master frames in a sequence given a N in the field segmentSize in the experiment_settings in a non-parallel (sequential) way.
  *
@@ -65,16 +156,13 @@ std::vector<int> findMasterFrames ( const EXPERIMENT& experiment_settings ){
     int size_segment = experiment_settings.segment_size;
 
     // Create the images
-    cv::Mat homographyMatrix,
-            ransacMask,
-            frame;
+    cv::Mat frame;
 
     cv::VideoCapture video ( experiment_settings.video_filename );
 
     int num_segments = (int)(video.get(CV_CAP_PROP_FRAME_COUNT)/size_segment),
-            inliers = 0,
-            max_inliers = 0,
-            master_index = 0;
+            master_index = 0,
+            num_evaluations = 0;
 
     // -------------------------------------------------------------
     // DEBUG
@@ -85,6 +173,7 @@ std::vector<int> findMasterFrames ( const EXPERIMENT& experiment_settings ){
 
     std::vector<int> masters ( num_segments );
     std::vector< std::vector< cv::KeyPoint > > segment_keypoints ( size_segment );
+    FeatureStore &feature_store = FeatureStore::getStore(experiment_settings.video_filename);
     std::vector<cv::Mat> segment_descriptors ( size_segment );
 
 
@@ -93,45 +182,28 @@ std::vector<int> findMasterFrames ( const EXPERIMENT& experiment_settings ){
     // Iterate over all segments from 1 to n in the video.
     for ( int i_seg = 0 ; i_seg < num_segments*size_segment ; i_seg += size_segment ) {
 
-        max_inliers = 0;
-        master_index = i_seg;
-
         //Getting keypoints and descriptors to avoid unnecessary computation
         for ( int i = 0 ; i < size_segment ; i ++ ){
+            //Stored frames are only skipped, without being decoded
+            if ( feature_store.lookup(i_seg+i, segment_keypoints[i], segment_descriptors[i]) ) {
+                video.grab();
+                continue;
+            }
+
             //Load frame
             video >> frame;
 
             //Preload kpts and descriptors
-            getKeypointsAndDescriptors(frame, segment_keypoints[i], segment_descriptors[i]);
+            feature_store.getKeypointsAndDescriptors(i_seg+i, frame, segment_keypoints[i], segment_descriptors[i]);
         }
 
-        for ( int i_master = i_seg ; i_master < i_seg + size_segment ; i_master++ ){
-
-            inliers = 0;
-
-            for ( int i_frame = i_seg ; i_frame < i_seg + size_segment ; i_frame++ ){
-
-                if (i_frame == i_master)
-                    continue;
-
-                if ( findHomographyMatrix(segment_keypoints[i_frame%size_segment], segment_keypoints[i_master%size_segment],
-                                          segment_descriptors[i_frame%size_segment], segment_descriptors[i_master%size_segment],
-                                          homographyMatrix, ransacMask) )
-                    inliers += cv::sum(ransacMask)[0];
-            }
-
-            //Update master frame and inliers
-            if ( inliers > max_inliers ){
-                master_index = i_master;
-                max_inliers = inliers;
-            }
-
-        }
+        master_index = i_seg + findSegmentMaster(segment_keypoints, segment_descriptors, num_evaluations);
 
         // -------------------------------------------------------------
         // DEBUG
         std::cout << "Segment " << SSTR ( std::setfill('0') << std::setw(log_number_length) << i_seg / size_segment << "/" << num_segments)
-                  << " | Master: " << SSTR ( std::setfill('0') << std::setw(log_number_length) << master_index ) << std::endl;
+                  << " | Master: " << SSTR ( std::setfill('0') << std::setw(log_number_length) << master_index )
+                  << " | Homographies: " << num_evaluations << "/" << size_segment*(size_segment-1) << std::endl;
         // -------------------------------------------------------------
 
         masters[i_seg/size_segment] = master_index;
@@ -142,9 +214,67 @@ std::vector<int> findMasterFrames ( const EXPERIMENT& experiment_settings ){
     return masters;
 }
 
+/**
+ * @brief Consecutive segments decoded for the master frames search, processed by a single worker. The frames whose
+ *          features are already stored are not decoded and stay empty.
+ */
+struct MasterTask {
+    int                     first_segment;
+    int                     num_segments;
+    std::vector<cv::Mat>    frames;
+};
+
+/**
+ * @brief Time spent by a thread of the master frames search doing useful work.
+ */
+struct MasterThreadUsage {
+    int                     num_segments = 0;
+    double                  busy_seconds = 0;
+};
+
+/**
+ * @brief Function that returns the number of seconds elapsed since the start time.
+ *
+ * @param start - start time.
+ *
+ * @return \c double
+ *
+ * @date 17/10/2026
+ */
+static double secondsSince ( const std::chrono::steady_clock::time_point &start ) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool parseMasterSchedule ( const std::string &name , MasterSchedule &schedule ) {
+    if ( name.empty() || name == "dynamic" )
+        schedule = DYNAMIC_SCHEDULE;
+    else if ( name == "guided" )
+        schedule = GUIDED_SCHEDULE;
+    else
+        return false;
+
+    return true;
+}
+
+int getNumberOfThreads ( const EXPERIMENT &experiment_settings ) {
+    if ( !experiment_settings.running_parallel )
+        return 1;
+    if ( experiment_settings.num_threads > 0 )
+        return experiment_settings.num_threads;
+    return std::max(1, omp_get_num_procs());
+}
+
 /**
  * @brief Function that calculates the master frames in a sequence given a N in the field segmentSize in the experiment_settings in a parallel way.
  *
+ * The video is split in MASTER_DECODER_THREADS contiguous chunks of segments, each one read sequentially by a decoder
+ * thread. A decoder opens its video reader only when it finds the first frame without stored features, and seeks only
+ * to skip long runs of stored frames. The decoded frames, in gray scale, are shared through a bounded queue with the
+ * workers, which compute the features and choose the master of each segment. With the dynamic schedule each task has
+ * one segment. With the guided schedule the tasks start larger and shrink as the chunk ends, up to
+ * MASTER_GUIDED_MAX_SEGMENTS segments. A worker takes the next task as soon as it finishes the previous one, so the load
+ * is balanced even when the segments have very different costs. The time each thread spent working is printed in the end.
+ *
  * @param experiment_settings - object with the experiment settings.
  *
  * @return \c std::vector<int> - vector with the master frames found in the sequence.
@@ -156,98 +286,162 @@ std::vector<int> findMasterFramesParallel ( const EXPERIMENT& experiment_setting
 
     int size_segment = experiment_settings.segment_size;
 
-    int num_procs = omp_get_num_procs();
+    int num_workers = getNumberOfThreads(experiment_settings);
+
+    MasterSchedule schedule = DYNAMIC_SCHEDULE;
+    parseMasterSchedule(experiment_settings.master_schedule, schedule);
 
     // -------------------------------------------------------------
     // DEBUG
-    std::cout << "Number of cores: " << num_procs << std::endl
+    std::cout << "Number of cores: " << omp_get_num_procs() << std::endl
+              << "Number of worker threads: " << num_workers << std::endl
+              << "Schedule: " << ( schedule == GUIDED_SCHEDULE ? "guided" : "dynamic" ) << std::endl
               << std::endl;
     // -------------------------------------------------------------
 
-    std::vector<cv::VideoCapture> video(num_procs);
-    for (int i = 0; i < num_procs; i++)
-        video[i] = cv::VideoCapture(experiment_settings.video_filename);
-
-    // Create the images
-    std::vector<cv::Mat> homographyMatrix(num_procs),
-            ransacMask(num_procs),
-            frame(num_procs);
-
-    int num_segments = (int)(video[0].get(CV_CAP_PROP_FRAME_COUNT)/size_segment),
-            max_inliers [num_procs],
-            master_index [num_procs];
+    int num_frames = (int)cv::VideoCapture(experiment_settings.video_filename).get(CV_CAP_PROP_FRAME_COUNT),
+            num_segments = num_frames/size_segment,
+            num_decoders = std::max(1, std::min(MASTER_DECODER_THREADS, num_segments));
 
-    int log_number_length = length((int)video[0].get(CV_CAP_PROP_FRAME_COUNT));
+    int log_number_length = length(num_frames);
 
     // -------------------------------------------------------------
     // DEBUG
-    std::cout << "Number of frames: " << (int)video[0].get(CV_CAP_PROP_FRAME_COUNT) << std::endl
+    std::cout << "Number of frames: " << num_frames << std::endl
               << "Number of segments: " << num_segments << std::endl
               << std::endl;
     // -------------------------------------------------------------
 
     std::vector<int> masters ( num_segments );
+    FeatureStore &feature_store = FeatureStore::getStore(experiment_settings.video_filename);
+
+    BlockingQueue< std::shared_ptr<MasterTask> > decoded_tasks ( PIPELINE_SEGMENTS_PER_WORKER * num_workers );
+
+    std::vector<MasterThreadUsage> decoder_usage ( num_decoders ),
+            worker_usage ( num_workers );
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    // Each decoder reads its chunk of segments from the first to the last frame.
+    std::vector<std::thread> decoders;
+    for ( int i_decoder = 0 ; i_decoder < num_decoders ; i_decoder++ )
+        decoders.push_back(std::thread([&, i_decoder] {
+            int first_segment = int( (long long)num_segments * i_decoder / num_decoders ),
+                    last_segment = int( (long long)num_segments * (i_decoder+1) / num_decoders ),
+                    next_frame = -1;
+
+            cv::VideoCapture video;
+            cv::Mat frame;
+
+            for ( int i_seg = first_segment ; i_seg < last_segment ; ) {
+                std::chrono::steady_clock::time_point task_start = std::chrono::steady_clock::now();
+
+                std::shared_ptr<MasterTask> task = std::make_shared<MasterTask>();
+                task->first_segment = i_seg;
+                task->num_segments = 1;
+                if ( schedule == GUIDED_SCHEDULE )
+                    task->num_segments = std::max(1, std::min(MASTER_GUIDED_MAX_SEGMENTS, (last_segment - i_seg) * num_decoders / (2*num_workers)));
+                task->num_segments = std::min(task->num_segments, last_segment - i_seg);
+                task->frames.resize(task->num_segments*size_segment);
+
+                for ( int i = 0 ; i < int(task->frames.size()) ; i++ ) {
+                    int i_frame = i_seg*size_segment + i;
+
+                    if ( feature_store.contains(i_frame) )
+                        continue;
+
+                    // The reader is opened with the first frame to be decoded and seeks only over long runs of stored frames.
+                    if ( !video.isOpened() ) {
+                        video.open(experiment_settings.video_filename);
+                        next_frame = 0;
+                    }
+                    if ( i_frame < next_frame || i_frame - next_frame > FRAME_CACHE_MAX_SEQUENTIAL_SKIP ) {
+                        video.set(CV_CAP_PROP_POS_FRAMES, i_frame);
+                        next_frame = i_frame;
+                    }
+                    for ( ; next_frame < i_frame ; next_frame++ )
+                        video.grab();
+
+                    next_frame++;
+                    if ( video.read(frame) && !frame.empty() )
+                        cv::cvtColor(frame, task->frames[i], CV_BGR2GRAY);
+                }
+
+                i_seg += task->num_segments;
+
+                decoder_usage[i_decoder].num_segments += task->num_segments;
+                decoder_usage[i_decoder].busy_seconds += secondsSince(task_start);
+
+                if ( !decoded_tasks.push(task) )
+                    break;
+            }
 
-    // Iterate over all segments from 1 to n in the video in a parallel form.
-#pragma omp parallel for
-    for ( int i_seg = 0 ; i_seg < num_segments*size_segment ; i_seg = i_seg + size_segment ) {
+            video.release();
+        }));
 
-        int threadId = omp_get_thread_num();
-        max_inliers[threadId] = 0;
-        master_index[threadId] = i_seg;
+    std::vector<std::thread> workers;
+    for ( int i_worker = 0 ; i_worker < num_workers ; i_worker++ )
+        workers.push_back(std::thread([&, i_worker] {
+            std::shared_ptr<MasterTask> task;
 
-        std::vector< std::vector< cv::KeyPoint > > segment_keypoints ( size_segment );
-        std::vector<cv::Mat> segment_descriptors ( size_segment );
+            while ( decoded_tasks.pop(task) ) {
+                std::chrono::steady_clock::time_point task_start = std::chrono::steady_clock::now();
 
-        //Getting keypoints and descriptors to avoid unnecessary computation
-        for ( int i = 0 ; i < size_segment ; i ++ ){
-            //Load frame
-            video[threadId].set(CV_CAP_PROP_POS_FRAMES, (i_seg+i));
-            video[threadId].read(frame.at(threadId));
-            cv::cvtColor(frame.at(threadId), frame.at(threadId), CV_BGR2GRAY);
+                for ( int i_seg = task->first_segment ; i_seg < task->first_segment + task->num_segments ; i_seg++ ) {
+                    int num_evaluations = 0,
+                            first_frame = i_seg*size_segment;
 
-            //Preload kpts and descriptors
-            getKeypointsAndDescriptors(frame.at(threadId), segment_keypoints[i], segment_descriptors[i]);
-        }
+                    std::vector< std::vector< cv::KeyPoint > > segment_keypoints ( size_segment );
+                    std::vector<cv::Mat> segment_descriptors ( size_segment );
 
-        for ( int i_master = i_seg ; i_master < i_seg + size_segment ; i_master++ ){
+                    //Getting keypoints and descriptors to avoid unnecessary computation
+                    for ( int i = 0 ; i < size_segment ; i ++ ) {
+                        cv::Mat &frame = task->frames[(i_seg - task->first_segment)*size_segment + i];
+                        feature_store.getKeypointsAndDescriptors(first_frame+i, frame, segment_keypoints[i], segment_descriptors[i]);
 
-            int inliers = 0;
+                        // The decoded frame is not needed anymore.
+                        frame.release();
+                    }
 
-            for ( int i_frame = i_seg ; i_frame < i_seg + size_segment ; i_frame++ ) {
+                    int master_index = first_frame + findSegmentMaster(segment_keypoints, segment_descriptors, num_evaluations);
 
-                if (i_frame == i_master)
-                    continue;
+                    // -------------------------------------------------------------
+                    // DEBUG
+                    std::cout << SSTR ( "Segment " << std::setfill('0') << std::setw(log_number_length) << i_seg
+                                        << " | Master: " << std::setfill('0') << std::setw(log_number_length) << master_index
+                                        << " | Homographies: " << num_evaluations << "/" << size_segment*(size_segment-1) << std::endl );
+                    // -------------------------------------------------------------
 
-                if(i_frame == 128)
-                    std::cout << "Chegou!" << std::endl;
+                    masters[i_seg] = master_index;
+                }
 
-                if ( findHomographyMatrix(segment_keypoints[i_frame%size_segment], segment_keypoints[i_master%size_segment],
-                                          segment_descriptors[i_frame%size_segment], segment_descriptors[i_master%size_segment],
-                                          homographyMatrix.at(threadId), ransacMask.at(threadId)) )
-                    inliers += cv::sum(ransacMask.at(threadId))[0];
+                worker_usage[i_worker].num_segments += task->num_segments;
+                worker_usage[i_worker].busy_seconds += secondsSince(task_start);
             }
+        }));
 
-            //Update master frame and inliers
-            if ( inliers > max_inliers[threadId] ){
-                master_index[threadId] = i_master;
-                max_inliers[threadId] = inliers;
-            }
+    for ( unsigned int i = 0 ; i < decoders.size() ; i++ )
+        decoders[i].join();
+    decoded_tasks.close();
 
-        }
-
-        // -------------------------------------------------------------
-        // DEBUG
-        std::cout << "Segment " << SSTR ( std::setfill('0') << std::setw(log_number_length) << i_seg / size_segment )
-                  << " | Master: " << SSTR ( std::setfill('0') << std::setw(log_number_length) << master_index[threadId] ) << std::endl;
-        // -------------------------------------------------------------
+    for ( unsigned int i = 0 ; i < workers.size() ; i++ )
+        workers[i].join();
 
-        masters[i_seg/size_segment] = master_index[threadId];
+    double elapsed_seconds = std::max(secondsSince(start), 1e-9);
 
-    }
-
-    for ( int i = 0 ; i < num_procs ; i++ )
-        video[i].release();
+    // -------------------------------------------------------------
+    // DEBUG
+    std::ostringstream usage_report;
+    usage_report << std::fixed << std::setprecision(2) << std::endl
+                 << "Master frames search: " << elapsed_seconds << " s" << std::endl;
+    for ( int i = 0 ; i < num_decoders ; i++ )
+        usage_report << "  Decoder " << i << ": " << decoder_usage[i].num_segments << " segments | busy "
+                     << decoder_usage[i].busy_seconds << " s (" << 100*decoder_usage[i].busy_seconds/elapsed_seconds << "%)" << std::endl;
+    for ( int i = 0 ; i < num_workers ; i++ )
+        usage_report << "  Worker " << i << ": " << worker_usage[i].num_segments << " segments | busy "
+                     << worker_usage[i].busy_seconds << " s (" << 100*worker_usage[i].busy_seconds/elapsed_seconds << "%)" << std::endl;
+    std::cout << usage_report.str() << std::endl;
+    // -------------------------------------------------------------
 
     return masters;
 }
@@ -113,3 +113,22 @@ void MessageHandler::reportStatus(std::string status, Stream stream){
         break;
     }
 }
+
+/**
+ * @brief MessageBuffer::reportStatus Keeps the given status to be reported to the log file, screen, or both.
+ * @param status
+ * @param stream
+ */
+void MessageBuffer::reportStatus(std::string status, Stream stream){
+    messages.push_back(std::make_pair(status, stream));
+}
+
+/**
+ * @brief MessageBuffer::flush Reports the kept status messages in the order they were given and clears the buffer.
+ * @param msg_handler
+ */
+void MessageBuffer::flush(MessageHandler &msg_handler){
+    for ( unsigned int i = 0 ; i < messages.size() ; i++ )
+        msg_handler.reportStatus(messages[i].first, messages[i].second);
+    messages.clear();
+}
@@ -0,0 +1,594 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+/**
+ * @file perspective_warp.cpp
+ *
+ * Bilinear perspective warp of the frames and masks, with the source coordinates computed by SIMD instructions.
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "headers/perspective_warp.h"
+
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+#define PERSPECTIVE_WARP_X86            1
+#include <immintrin.h>
+#else
+#define PERSPECTIVE_WARP_X86            0
+#endif
+
+/** Bits of the sub-pixel position of the source coordinates, as the INTER_BITS of the OpenCV. */
+#define WARP_SUBPIXEL_BITS              5
+#define WARP_SUBPIXEL_SIZE              ( 1 << WARP_SUBPIXEL_BITS )
+
+/** Bits of the interpolation weights, whose sum is 1 << WARP_WEIGHT_BITS. */
+#define WARP_WEIGHT_BITS                ( 2 * WARP_SUBPIXEL_BITS )
+#define WARP_WEIGHT_ROUND               ( 1 << ( WARP_WEIGHT_BITS - 1 ) )
+
+/** Largest source coordinate, in sub-pixels, so the neighbours of a pixel do not overflow an int. */
+#define WARP_MAX_COORDINATE             1073741824.0
+
+/** Number of warps of each homography measured by the benchmarkPerspectiveWarp. */
+#define WARP_BENCHMARK_REPETITIONS      10
+
+/** Instructions used to compute the source coordinates and to interpolate the pixels. */
+enum WarpPath { WARP_PATH_SCALAR, WARP_PATH_SSE41, WARP_PATH_AVX2 };
+
+/** Pixels of the source image. The data is NULL, and the channels 0, when only the mask is warped. */
+struct WarpSource {
+    const uchar *data;
+    size_t      step;
+    int         rows;
+    int         cols;
+    int         channels;
+};
+
+/**
+ * Source pixel of each pixel of a row of a tile: the top-left neighbour of the source coordinates and the bilinear
+ * weights of the top and bottom neighbours, packed as the pairs of 16 bits multiplied by the _mm_madd_epi16.
+ */
+struct WarpTileRow {
+    int x               [PERSPECTIVE_WARP_TILE_COLS];
+    int y               [PERSPECTIVE_WARP_TILE_COLS];
+    int weights_top     [PERSPECTIVE_WARP_TILE_COLS];
+    int weights_bottom  [PERSPECTIVE_WARP_TILE_COLS];
+};
+
+/**
+ * @brief Function that chooses the fastest path supported by the processor.
+ *
+ * @return \c WarpPath - the path.
+ *
+ * @date 17/10/2026
+ */
+static WarpPath getBestWarpPath ( void ){
+#if PERSPECTIVE_WARP_X86
+    __builtin_cpu_init();
+    if ( __builtin_cpu_supports("avx2") )
+        return WARP_PATH_AVX2;
+    if ( __builtin_cpu_supports("sse4.1") )
+        return WARP_PATH_SSE41;
+#endif
+    return WARP_PATH_SCALAR;
+}
+
+static const WarpPath best_warp_path = getBestWarpPath();
+
+/**
+ * @brief Function that saves the source pixel of a pixel of the row, given its source coordinates in sub-pixels.
+ *
+ * @param X - source column, in sub-pixels.
+ * @param Y - source row, in sub-pixels.
+ * @param i - index of the pixel in the row.
+ * @param row - object to save the source pixel.
+ *
+ * @date 17/10/2026
+ */
+static inline void setSourcePixel ( const int X, const int Y, const int i, WarpTileRow &row ){
+    const int ax = X & ( WARP_SUBPIXEL_SIZE - 1 ),
+            ay = Y & ( WARP_SUBPIXEL_SIZE - 1 );
+
+    row.x[i] = X >> WARP_SUBPIXEL_BITS;
+    row.y[i] = Y >> WARP_SUBPIXEL_BITS;
+    row.weights_top[i] = ( WARP_SUBPIXEL_SIZE - ax ) * ( WARP_SUBPIXEL_SIZE - ay ) | ( ax * ( WARP_SUBPIXEL_SIZE - ay ) ) << 16;
+    row.weights_bottom[i] = ( WARP_SUBPIXEL_SIZE - ax ) * ay | ( ax * ay ) << 16;
+}
+
+/**
+ * @brief Function that computes the source pixels of a row of a tile in double precision, as the cv::warpPerspective.
+ *
+ * @param M - inverse of the homography matrix, from the result to the source, by rows.
+ * @param x0 - first column of the tile.
+ * @param y - row.
+ * @param begin - index of the first pixel computed.
+ * @param end - index after the last pixel computed.
+ * @param row - object to save the source pixels.
+ *
+ * @date 17/10/2026
+ */
+static void getSourcePixelsScalar ( const double *M, const int x0, const int y, const int begin, const int end, WarpTileRow &row ){
+    const double X0 = M[1] * y + M[2],
+            Y0 = M[4] * y + M[5],
+            W0 = M[7] * y + M[8];
+
+    for ( int i = begin ; i < end ; i++ ) {
+        const int x = x0 + i;
+        double W = W0 + M[6] * x;
+        W = W ? WARP_SUBPIXEL_SIZE / W : 0.0;
+
+        const double X = std::max( -WARP_MAX_COORDINATE , std::min( WARP_MAX_COORDINATE , ( X0 + M[0] * x ) * W ) ),
+                Y = std::max( -WARP_MAX_COORDINATE , std::min( WARP_MAX_COORDINATE , ( Y0 + M[3] * x ) * W ) );
+
+        setSourcePixel( cvRound(X) , cvRound(Y) , i , row );
+    }
+}
+
+/**
+ * @brief Function that interpolates a pixel with some neighbours out of the source image, which are black, and
+ *          its mask, which is the weight of the neighbours inside the source image.
+ *
+ * @param source - source image.
+ * @param row - source pixels of the row.
+ * @param i - index of the pixel in the row.
+ * @param pixel - object to save the pixel. It is not used when only the mask is warped.
+ * @param mask - object to save the mask, or NULL.
+ *
+ * @date 17/10/2026
+ */
+static inline void interpolateBorderPixel ( const WarpSource &source, const WarpTileRow &row, const int i, uchar *pixel, uchar *mask ){
+    const int weights[4] = { row.weights_top[i] & 0xFFFF , row.weights_top[i] >> 16 ,
+                             row.weights_bottom[i] & 0xFFFF , row.weights_bottom[i] >> 16 };
+    int sums[4] = { 0 , 0 , 0 , 0 },
+            weight_inside = 0;
+
+    for ( int k = 0 ; k < 4 ; k++ ) {
+        const int x = row.x[i] + ( k & 1 ),
+                y = row.y[i] + ( k >> 1 );
+        if ( unsigned(x) >= unsigned(source.cols) || unsigned(y) >= unsigned(source.rows) )
+            continue;
+
+        weight_inside += weights[k];
+        for ( int c = 0 ; c < source.channels ; c++ )
+            sums[c] += source.data[ y * source.step + x * source.channels + c ] * weights[k];
+    }
+
+    for ( int c = 0 ; c < source.channels ; c++ )
+        pixel[c] = uchar( ( sums[c] + WARP_WEIGHT_ROUND ) >> WARP_WEIGHT_BITS );
+    if ( mask )
+        *mask = uchar( ( weight_inside * 255 + WARP_WEIGHT_ROUND ) >> WARP_WEIGHT_BITS );
+}
+
+/**
+ * @brief Function that interpolates the pixels of a row of a tile and their mask. The pixels whose four neighbours are
+ *          inside the source image are covered by it, so their mask is white.
+ *
+ * @param source - source image.
+ * @param row - source pixels of the row.
+ * @param begin - index of the first pixel interpolated.
+ * @param end - index after the last pixel interpolated.
+ * @param pixels - object to save the pixels of the row, or NULL when only the mask is warped.
+ * @param mask - object to save the mask of the row, or NULL.
+ *
+ * @date 17/10/2026
+ */
+static void interpolateRowScalar ( const WarpSource &source, const WarpTileRow &row, const int begin, const int end, uchar *pixels, uchar *mask ){
+    const int cn = source.channels;
+
+    for ( int i = begin ; i < end ; i++ ) {
+        if ( unsigned(row.x[i]) >= unsigned(source.cols - 1) || unsigned(row.y[i]) >= unsigned(source.rows - 1) ) {
+            interpolateBorderPixel( source , row , i , pixels + i * cn , mask ? mask + i : NULL );
+            continue;
+        }
+
+        const uchar *top = source.data + row.y[i] * source.step + row.x[i] * cn,
+                *bottom = top + source.step;
+        const int w00 = row.weights_top[i] & 0xFFFF , w01 = row.weights_top[i] >> 16,
+                w10 = row.weights_bottom[i] & 0xFFFF , w11 = row.weights_bottom[i] >> 16;
+
+        for ( int c = 0 ; c < cn ; c++ )
+            pixels[i * cn + c] = uchar( ( top[c] * w00 + top[c + cn] * w01 + bottom[c] * w10 + bottom[c + cn] * w11
+                                          + WARP_WEIGHT_ROUND ) >> WARP_WEIGHT_BITS );
+        if ( mask )
+            mask[i] = 255;
+    }
+}
+
+#if PERSPECTIVE_WARP_X86
+
+/**
+ * @brief Function that packs the source pixels of four pixels of a row, given their source coordinates in sub-pixels.
+ *
+ * @param X - source columns, in sub-pixels.
+ * @param Y - source rows, in sub-pixels.
+ * @param i - index of the first pixel in the row.
+ * @param row - object to save the source pixels.
+ *
+ * @date 17/10/2026
+ */
+__attribute__((target("sse4.1")))
+static inline void setSourcePixelsSSE41 ( const __m128i X, const __m128i Y, const int i, WarpTileRow &row ){
+    const __m128i subpixel_mask = _mm_set1_epi32( WARP_SUBPIXEL_SIZE - 1 ),
+            subpixel_size = _mm_set1_epi32( WARP_SUBPIXEL_SIZE ),
+            ax = _mm_and_si128( X , subpixel_mask ),
+            ay = _mm_and_si128( Y , subpixel_mask ),
+            bx = _mm_sub_epi32( subpixel_size , ax ),
+            by = _mm_sub_epi32( subpixel_size , ay );
+
+    _mm_storeu_si128( (__m128i*)( row.x + i ) , _mm_srai_epi32( X , WARP_SUBPIXEL_BITS ) );
+    _mm_storeu_si128( (__m128i*)( row.y + i ) , _mm_srai_epi32( Y , WARP_SUBPIXEL_BITS ) );
+    _mm_storeu_si128( (__m128i*)( row.weights_top + i ) ,
+                      _mm_or_si128( _mm_mullo_epi32( bx , by ) , _mm_slli_epi32( _mm_mullo_epi32( ax , by ) , 16 ) ) );
+    _mm_storeu_si128( (__m128i*)( row.weights_bottom + i ) ,
+                      _mm_or_si128( _mm_mullo_epi32( bx , ay ) , _mm_slli_epi32( _mm_mullo_epi32( ax , ay ) , 16 ) ) );
+}
+
+/**
+ * @brief Function that computes the source pixels of a row of a tile as the getSourcePixelsScalar, two pixels at a time.
+ *          The operations are the same, in double precision, so the results are the same of the scalar code.
+ *
+ * @param M - inverse of the homography matrix, from the result to the source, by rows.
+ * @param x0 - first column of the tile.
+ * @param y - row.
+ * @param n - number of pixels in the row.
+ * @param row - object to save the source pixels.
+ *
+ * @date 17/10/2026
+ */
+__attribute__((target("sse4.1")))
+static void getSourcePixelsSSE41 ( const double *M, const int x0, const int y, const int n, WarpTileRow &row ){
+    const __m128d X0 = _mm_set1_pd( M[1] * y + M[2] ),
+            Y0 = _mm_set1_pd( M[4] * y + M[5] ),
+            W0 = _mm_set1_pd( M[7] * y + M[8] ),
+            M0 = _mm_set1_pd( M[0] ),
+            M3 = _mm_set1_pd( M[3] ),
+            M6 = _mm_set1_pd( M[6] ),
+            subpixel_size = _mm_set1_pd( WARP_SUBPIXEL_SIZE ),
+            max_coordinate = _mm_set1_pd( WARP_MAX_COORDINATE ),
+            min_coordinate = _mm_set1_pd( -WARP_MAX_COORDINATE );
+
+    int i = 0;
+    for ( ; i + 4 <= n ; i += 4 ) {
+        __m128i X[2], Y[2];
+        for ( int half = 0 ; half < 2 ; half++ ) {
+            const __m128d x = _mm_setr_pd( x0 + i + 2 * half , x0 + i + 2 * half + 1 ),
+                    W = _mm_add_pd( W0 , _mm_mul_pd( M6 , x ) ),
+                    W_inv = _mm_and_pd( _mm_div_pd( subpixel_size , W ) , _mm_cmpneq_pd( W , _mm_setzero_pd() ) );
+
+            X[half] = _mm_cvtpd_epi32( _mm_max_pd( _mm_min_pd( _mm_mul_pd( _mm_add_pd( X0 , _mm_mul_pd( M0 , x ) ) , W_inv ) , max_coordinate ) , min_coordinate ) );
+            Y[half] = _mm_cvtpd_epi32( _mm_max_pd( _mm_min_pd( _mm_mul_pd( _mm_add_pd( Y0 , _mm_mul_pd( M3 , x ) ) , W_inv ) , max_coordinate ) , min_coordinate ) );
+        }
+
+        setSourcePixelsSSE41( _mm_unpacklo_epi64( X[0] , X[1] ) , _mm_unpacklo_epi64( Y[0] , Y[1] ) , i , row );
+    }
+
+    getSourcePixelsScalar( M , x0 , y , i , n , row );
+}
+
+/**
+ * @brief Function that computes the source pixels of a row of a tile as the getSourcePixelsSSE41, four pixels at a time.
+ *
+ * @param M - inverse of the homography matrix, from the result to the source, by rows.
+ * @param x0 - first column of the tile.
+ * @param y - row.
+ * @param n - number of pixels in the row.
+ * @param row - object to save the source pixels.
+ *
+ * @date 17/10/2026
+ */
+__attribute__((target("avx2")))
+static void getSourcePixelsAVX2 ( const double *M, const int x0, const int y, const int n, WarpTileRow &row ){
+    const __m256d X0 = _mm256_set1_pd( M[1] * y + M[2] ),
+            Y0 = _mm256_set1_pd( M[4] * y + M[5] ),
+            W0 = _mm256_set1_pd( M[7] * y + M[8] ),
+            M0 = _mm256_set1_pd( M[0] ),
+            M3 = _mm256_set1_pd( M[3] ),
+            M6 = _mm256_set1_pd( M[6] ),
+            subpixel_size = _mm256_set1_pd( WARP_SUBPIXEL_SIZE ),
+            max_coordinate = _mm256_set1_pd( WARP_MAX_COORDINATE ),
+            min_coordinate = _mm256_set1_pd( -WARP_MAX_COORDINATE ),
+            offsets = _mm256_setr_pd( 0 , 1 , 2 , 3 );
+
+    int i = 0;
+    for ( ; i + 4 <= n ; i += 4 ) {
+        const __m256d x = _mm256_add_pd( _mm256_set1_pd( x0 + i ) , offsets ),
+                W = _mm256_add_pd( W0 , _mm256_mul_pd( M6 , x ) ),
+                W_inv = _mm256_and_pd( _mm256_div_pd( subpixel_size , W ) , _mm256_cmp_pd( W , _mm256_setzero_pd() , _CMP_NEQ_OQ ) );
+
+        const __m128i X = _mm256_cvtpd_epi32( _mm256_max_pd( _mm256_min_pd( _mm256_mul_pd( _mm256_add_pd( X0 , _mm256_mul_pd( M0 , x ) ) , W_inv ) , max_coordinate ) , min_coordinate ) ),
+                Y = _mm256_cvtpd_epi32( _mm256_max_pd( _mm256_min_pd( _mm256_mul_pd( _mm256_add_pd( Y0 , _mm256_mul_pd( M3 , x ) ) , W_inv ) , max_coordinate ) , min_coordinate ) );
+
+        setSourcePixelsSSE41( X , Y , i , row );
+    }
+
+    getSourcePixelsScalar( M , x0 , y , i , n , row );
+}
+
+/**
+ * @brief Function that interpolates the pixels of a row of a tile as the interpolateRowScalar. The pixels of three
+ *          channels are interpolated one at a time, with the channels of the two neighbours of a row multiplied
+ *          together by the _mm_madd_epi16, and the pixels of one channel four at a time.
+ *
+ * @param source - source image.
+ * @param row - source pixels of the row.
+ * @param n - number of pixels in the row.
+ * @param pixels - object to save the pixels, or NULL when only the mask is warped.
+ * @param mask - object to save the mask, or NULL.
+ *
+ * @date 17/10/2026
+ */
+__attribute__((target("sse4.1")))
+static void interpolateRowSSE41 ( const WarpSource &source, const WarpTileRow &row, const int n, uchar *pixels, uchar *mask ){
+    const unsigned int last_x = unsigned(source.cols - 1),
+            last_y = unsigned(source.rows - 1);
+    const __m128i round = _mm_set1_epi32( WARP_WEIGHT_ROUND );
+
+    if ( source.channels == 3 ) {
+        // Spreads the channels of two neighbours (b0 g0 r0 b1 g1 r1) to the pairs (b0 b1) (g0 g1) (r0 r1) of 16 bits.
+        const __m128i spread = _mm_setr_epi8( 0 , -1 , 3 , -1 , 1 , -1 , 4 , -1 , 2 , -1 , 5 , -1 , -1 , -1 , -1 , -1 );
+
+        for ( int i = 0 ; i < n ; i++ ) {
+            if ( unsigned(row.x[i]) >= last_x || unsigned(row.y[i]) >= last_y ) {
+                interpolateBorderPixel( source , row , i , pixels + i * 3 , mask ? mask + i : NULL );
+                continue;
+            }
+
+            const uchar *top = source.data + row.y[i] * source.step + row.x[i] * 3,
+                    *bottom = top + source.step;
+            __m128i top_pair, bottom_pair;
+
+            // The 8 bytes loaded have 2 bytes after the neighbours, which are only read inside the row.
+            if ( row.x[i] + 2 < source.cols ) {
+                top_pair = _mm_loadl_epi64( (const __m128i*)top );
+                bottom_pair = _mm_loadl_epi64( (const __m128i*)bottom );
+            } else {
+                uchar neighbours[16] = { 0 };
+                memcpy( neighbours , top , 6 );
+                memcpy( neighbours + 8 , bottom , 6 );
+                top_pair = _mm_loadl_epi64( (const __m128i*)neighbours );
+                bottom_pair = _mm_loadl_epi64( (const __m128i*)( neighbours + 8 ) );
+            }
+
+            __m128i sum = _mm_add_epi32( _mm_madd_epi16( _mm_shuffle_epi8( top_pair , spread ) , _mm_set1_epi32( row.weights_top[i] ) ),
+                                         _mm_madd_epi16( _mm_shuffle_epi8( bottom_pair , spread ) , _mm_set1_epi32( row.weights_bottom[i] ) ) );
+            sum = _mm_srli_epi32( _mm_add_epi32( sum , round ) , WARP_WEIGHT_BITS );
+            sum = _mm_packus_epi16( _mm_packs_epi32( sum , sum ) , sum );
+
+            const int pixel = _mm_cvtsi128_si32( sum );
+            pixels[i * 3] = uchar( pixel );
+            pixels[i * 3 + 1] = uchar( pixel >> 8 );
+            pixels[i * 3 + 2] = uchar( pixel >> 16 );
+            if ( mask )
+                mask[i] = 255;
+        }
+        return;
+    }
+
+    if ( source.channels != 1 ) {
+        interpolateRowScalar( source , row , 0 , n , pixels , mask );
+        return;
+    }
+
+    // The neighbours of a row of each pixel are the pairs of 16 bits of the madd, as the weights.
+    int i = 0;
+    for ( ; i + 4 <= n ; i += 4 ) {
+        bool inside = true;
+        for ( int k = i ; k < i + 4 ; k++ )
+            inside = inside && unsigned(row.x[k]) < last_x && unsigned(row.y[k]) < last_y;
+
+        if ( !inside ) {
+            interpolateRowScalar( source , row , i , i + 4 , pixels , mask );
+            continue;
+        }
+
+        int top_pairs[4], bottom_pairs[4];
+        for ( int k = 0 ; k < 4 ; k++ ) {
+            const uchar *top = source.data + row.y[i + k] * source.step + row.x[i + k],
+                    *bottom = top + source.step;
+            top_pairs[k] = top[0] | top[1] << 16;
+            bottom_pairs[k] = bottom[0] | bottom[1] << 16;
+        }
+
+        __m128i sum = _mm_add_epi32( _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)top_pairs ) ,
+                                                     _mm_loadu_si128( (const __m128i*)( row.weights_top + i ) ) ),
+                                     _mm_madd_epi16( _mm_loadu_si128( (const __m128i*)bottom_pairs ) ,
+                                                     _mm_loadu_si128( (const __m128i*)( row.weights_bottom + i ) ) ) );
+        sum = _mm_srli_epi32( _mm_add_epi32( sum , round ) , WARP_WEIGHT_BITS );
+        sum = _mm_packus_epi16( _mm_packs_epi32( sum , sum ) , sum );
+
+        const int four_pixels = _mm_cvtsi128_si32( sum );
+        memcpy( pixels + i , &four_pixels , 4 );
+        if ( mask )
+            memset( mask + i , 255 , 4 );
+    }
+
+    interpolateRowScalar( source , row , i , n , pixels , mask );
+}
+
+#endif
+/**
+ * @brief Function that warps the source image, its mask or both, tile by tile, with the given path.
+ *
+ * @param source - source image. Only its size is used when the image_result is NULL.
+ * @param homography_matrix - homography matrix from the source to the results.
+ * @param result_size - size of the results.
+ * @param image_result - object to save the warped image, or NULL.
+ * @param mask_result - object to save the warped mask, or NULL.
+ * @param path - instructions used.
+ *
+ * @date 17/10/2026
+ */
+static void warpTiles ( const WarpSource &source, const cv::Mat &homography_matrix, const cv::Size &result_size,
+                        cv::Mat *image_result, cv::Mat *mask_result, const WarpPath path ){
+    // The result pixels are mapped to the source by the inverse, as in the cv::warpPerspective.
+    cv::Mat_<double> inverse;
+    cv::invert( cv::Mat_<double>(homography_matrix) , inverse );
+
+    double M[9];
+    for ( int k = 0 ; k < 9 ; k++ )
+        M[k] = inverse( k / 3 , k % 3 );
+
+    if ( image_result )
+        image_result->create( result_size , CV_8UC(source.channels) );
+    if ( mask_result )
+        mask_result->create( result_size , CV_8UC1 );
+
+    WarpTileRow row;
+
+    for ( int y0 = 0 ; y0 < result_size.height ; y0 += PERSPECTIVE_WARP_TILE_ROWS )
+        for ( int x0 = 0 ; x0 < result_size.width ; x0 += PERSPECTIVE_WARP_TILE_COLS ) {
+            const int y1 = std::min( y0 + PERSPECTIVE_WARP_TILE_ROWS , result_size.height ),
+                    n = std::min( PERSPECTIVE_WARP_TILE_COLS , result_size.width - x0 );
+
+            for ( int y = y0 ; y < y1 ; y++ ) {
+                uchar *pixels = image_result ? image_result->ptr<uchar>(y) + x0 * source.channels : NULL,
+                        *mask = mask_result ? mask_result->ptr<uchar>(y) + x0 : NULL;
+
+                switch ( path ) {
+#if PERSPECTIVE_WARP_X86
+                case WARP_PATH_AVX2:
+                    getSourcePixelsAVX2( M , x0 , y , n , row );
+                    interpolateRowSSE41( source , row , n , pixels , mask );
+                    break;
+                case WARP_PATH_SSE41:
+                    getSourcePixelsSSE41( M , x0 , y , n , row );
+                    interpolateRowSSE41( source , row , n , pixels , mask );
+                    break;
+#endif
+                default:
+                    getSourcePixelsScalar( M , x0 , y , 0 , n , row );
+                    interpolateRowScalar( source , row , 0 , n , pixels , mask );
+                }
+            }
+        }
+}
+
+/**
+ * @brief Function that describes the pixels of an image to the warpTiles.
+ *
+ * @param image - the image.
+ *
+ * @return \c WarpSource - the description.
+ *
+ * @date 17/10/2026
+ */
+static WarpSource getWarpSource ( const cv::Mat &image ){
+    WarpSource source = { image.data , image.step , image.rows , image.cols , image.channels() };
+    return source;
+}
+
+void warpPerspectiveBilinear( const cv::Mat &image_src, const cv::Mat &homography_matrix, const cv::Size &result_size, cv::Mat &image_result )
+{
+    if ( image_src.type() != CV_8UC3 && image_src.type() != CV_8UC1 ) {
+        cv::warpPerspective( image_src , image_result , homography_matrix , result_size );
+        return;
+    }
+
+    warpTiles( getWarpSource(image_src) , homography_matrix , result_size , &image_result , NULL , best_warp_path );
+}
+
+void warpPerspectiveBilinear( const cv::Mat &image_src, const cv::Mat &homography_matrix, const cv::Size &result_size,
+                              cv::Mat &image_result, cv::Mat &mask_result )
+{
+    if ( image_src.type() != CV_8UC3 && image_src.type() != CV_8UC1 ) {
+        cv::warpPerspective( image_src , image_result , homography_matrix , result_size );
+        warpPerspectiveMask( image_src.size() , homography_matrix , result_size , mask_result );
+        return;
+    }
+
+    warpTiles( getWarpSource(image_src) , homography_matrix , result_size , &image_result , &mask_result , best_warp_path );
+}
+
+void warpPerspectiveMask( const cv::Size &image_size, const cv::Mat &homography_matrix, const cv::Size &result_size, cv::Mat &mask_result )
+{
+    const WarpSource source = { NULL , 0 , image_size.height , image_size.width , 0 };
+    warpTiles( source , homography_matrix , result_size , NULL , &mask_result , best_warp_path );
+}
+
+std::string benchmarkPerspectiveWarp( const cv::Mat &image )
+{
+    // Small rotations, translations and perspectives, as the ones between the frames of the videos.
+    std::vector<cv::Mat> homographies;
+    for ( int k = -2 ; k <= 2 ; k++ ) {
+        const double angle = 0.02 * k;
+        homographies.push_back( ( cv::Mat_<double>(3,3) << cos(angle) , -sin(angle) , 8.0 * k ,
+                                  sin(angle) , cos(angle) , -5.0 * k ,
+                                  1e-5 * k , -1e-5 * k , 1.0 ) );
+    }
+
+    cv::Mat gray_image;
+    cv::cvtColor( image , gray_image , CV_BGR2GRAY );
+    const cv::Mat white_mask ( image.size() , CV_8UC1 , cv::Scalar(255) );
+
+    const char *path_names[3] = { "scalar" , "SSE4.1" , "AVX2" };
+    const int num_paths = int(best_warp_path) + 1;
+
+    std::stringstream report;
+    report << std::fixed << std::setprecision(2);
+
+    // The frames are warped with their masks, as in the reconstruction, and the grayscale images alone.
+    for ( int with_mask = 1 ; with_mask >= 0 ; with_mask-- ) {
+        const cv::Mat &src = with_mask ? image : gray_image;
+        std::vector<cv::Mat> reference_images ( homographies.size() ),
+                reference_masks ( homographies.size() );
+
+        int64 ticks = cv::getTickCount();
+        for ( int r = 0 ; r < WARP_BENCHMARK_REPETITIONS ; r++ )
+            for ( unsigned int h = 0 ; h < homographies.size() ; h++ ) {
+                cv::warpPerspective( src , reference_images[h] , homographies[h] , src.size() );
+                if ( with_mask )
+                    cv::warpPerspective( white_mask , reference_masks[h] , homographies[h] , src.size() );
+            }
+        const double reference_time = ( cv::getTickCount() - ticks ) * 1000.0 / cv::getTickFrequency()
+                / ( WARP_BENCHMARK_REPETITIONS * homographies.size() );
+
+        report << ( with_mask ? "CV_8UC3 frame and mask" : "CV_8UC1 image" ) << " " << src.cols << "x" << src.rows
+               << ": cv::warpPerspective " << reference_time << " ms" << std::endl;
+
+        for ( int path = 0 ; path < num_paths ; path++ ) {
+            cv::Mat warped_image, warped_mask;
+            double max_difference = 0.0;
+
+            ticks = cv::getTickCount();
+            for ( int r = 0 ; r < WARP_BENCHMARK_REPETITIONS ; r++ )
+                for ( unsigned int h = 0 ; h < homographies.size() ; h++ ) {
+                    warpTiles( getWarpSource(src) , homographies[h] , src.size() , &warped_image ,
+                               with_mask ? &warped_mask : NULL , WarpPath(path) );
+
+                    if ( r == 0 ) {
+                        max_difference = std::max( max_difference , cv::norm( warped_image , reference_images[h] , cv::NORM_INF ) );
+                        if ( with_mask )
+                            max_difference = std::max( max_difference , cv::norm( warped_mask , reference_masks[h] , cv::NORM_INF ) );
+                    }
+                }
+            const double time = ( cv::getTickCount() - ticks ) * 1000.0 / cv::getTickFrequency()
+                    / ( WARP_BENCHMARK_REPETITIONS * homographies.size() );
+
+            report << "    " << path_names[path] << ": " << time << " ms (" << reference_time / time
+                   << "x), largest difference " << max_difference << std::endl;
+        }
+    }
+
+    return report.str();
+}
@@ -0,0 +1,229 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file reconstruction_window.cpp
+ *
+ * Sliding window of the original video frames used by the image reconstruction.
+ *
+ */
+
+#include <cstdlib>
+#include <atomic>
+#include <map>
+#include <memory>
+
+#include "headers/reconstruction_window.h"
+#include "headers/feature_store.h"
+
+/** Number of frames before and after the center of the window. */
+static const int    WINDOW_RADIUS   = NUM_MAX_IMAGES_TO_RECONSTRUCT;
+
+/** Bytes of the frames kept by the windows of all the threads. */
+static std::atomic<size_t> window_bytes_in_use ( 0 );
+
+ReconstructionWindow& ReconstructionWindow::getWindow ( const std::string &video_filename )
+{
+    static thread_local std::map< std::string , std::unique_ptr<ReconstructionWindow> > windows;
+
+    std::unique_ptr<ReconstructionWindow> &window = windows[video_filename];
+    if ( !window )
+        window.reset(new ReconstructionWindow(video_filename));
+    return *window;
+}
+
+ReconstructionWindow::ReconstructionWindow ( const std::string &video_filename ) :
+    video_filename(video_filename),
+    video(video_filename),
+    num_frames(-1),
+    next_index(0),
+    center(0),
+    slots(2*WINDOW_RADIUS+1)
+{
+    if ( video.isOpened() )
+        num_frames = int(video.get(CV_CAP_PROP_FRAME_COUNT));
+
+    for ( unsigned int i = 0 ; i < slots.size() ; i++ ) {
+        slots[i].index = -1;
+        slots[i].described = false;
+    }
+}
+
+bool ReconstructionWindow::isOpened ( void ) const
+{
+    return num_frames >= 0;
+}
+
+ReconstructionWindow::~ReconstructionWindow ( void )
+{
+    for ( unsigned int i = 0 ; i < slots.size() ; i++ )
+        releaseSlot(slots[i]);
+}
+
+int ReconstructionWindow::getFrameCount ( void ) const
+{
+    return num_frames;
+}
+
+/**
+ * @brief ReconstructionWindow::contains Checks if the frame is inside the window and inside the video.
+ * @param index - index of the frame in the video.
+ * @return \c bool
+ */
+bool ReconstructionWindow::contains ( const int index ) const
+{
+    return index >= 0 && index < num_frames && std::abs(index - center) <= WINDOW_RADIUS;
+}
+
+/**
+ * @brief ReconstructionWindow::getSlot Returns the slot of the ring buffer where the frame is kept.
+ * @param index - index of the frame in the video.
+ * @return \c Slot&
+ */
+ReconstructionWindow::Slot& ReconstructionWindow::getSlot ( const int index )
+{
+    return slots[index % slots.size()];
+}
+
+/**
+ * @brief ReconstructionWindow::storeFrame Keeps a decoded frame in its slot, counting it in the budget of the windows.
+ * @param slot - slot of the frame.
+ * @param index - index of the frame in the video.
+ * @param frame - decoded frame.
+ */
+void ReconstructionWindow::storeFrame ( Slot &slot , const int index , const cv::Mat &frame )
+{
+    releaseSlot(slot);
+
+    slot.index = index;
+    slot.frame = frame;
+    window_bytes_in_use += frame.total() * frame.elemSize();
+}
+
+/**
+ * @brief ReconstructionWindow::releaseSlot Releases the frame and the features of the slot.
+ * @param slot - slot to be released.
+ */
+void ReconstructionWindow::releaseSlot ( Slot &slot )
+{
+    window_bytes_in_use -= slot.frame.total() * slot.frame.elemSize();
+
+    slot.index = -1;
+    slot.frame.release();
+    slot.described = false;
+    slot.keypoints.clear();
+    slot.descriptors.release();
+}
+
+/**
+ * @brief ReconstructionWindow::enforceBudget Releases the frames of this window farthest from the center while the
+ *          windows of all the threads are over the budget. The windows of the other threads are not touched, so a
+ *          window may stay over the budget with only the requested frame.
+ * @param keep_index - index of the frame being requested, which is never released.
+ */
+void ReconstructionWindow::enforceBudget ( const int keep_index )
+{
+    const size_t budget = size_t(RECONSTRUCTION_WINDOW_BUDGET_MB) * 1024 * 1024;
+
+    while ( window_bytes_in_use > budget ) {
+        Slot *farthest = NULL;
+        for ( unsigned int i = 0 ; i < slots.size() ; i++ )
+            if ( slots[i].index >= 0 && slots[i].index != keep_index &&
+                 ( farthest == NULL || std::abs(slots[i].index - center) > std::abs(farthest->index - center) ) )
+                farthest = &slots[i];
+
+        if ( farthest == NULL )
+            return;
+
+        releaseSlot(*farthest);
+    }
+}
+
+void ReconstructionWindow::moveTo ( const int center )
+{
+    this->center = center;
+
+    for ( unsigned int i = 0 ; i < slots.size() ; i++ )
+        if ( slots[i].index >= 0 && !contains(slots[i].index) )
+            releaseSlot(slots[i]);
+}
+
+/**
+ * @brief ReconstructionWindow::decode Decodes the frame into its slot. The frames read on the way, when the frame is
+ *          close enough to be reached without seeking, are also kept if they are inside the window.
+ * @param index - index of the frame in the video. It must be inside the window.
+ */
+void ReconstructionWindow::decode ( const int index )
+{
+    // Short forward jumps are cheaper to decode than to seek, since a seek restarts from the previous key frame.
+    if ( next_index < 0 || index < next_index || index - next_index > FRAME_CACHE_MAX_SEQUENTIAL_SKIP ) {
+        video.set(CV_CAP_PROP_POS_FRAMES, index);
+        next_index = index;
+    }
+
+    cv::Mat decoded_frame;
+    while ( next_index <= index ) {
+        // Each decoded frame needs its own buffer, since the slot keeps a reference to it.
+        decoded_frame = cv::Mat();
+        if ( !video.read(decoded_frame) || decoded_frame.empty() ) {
+            next_index = -1;
+            return;
+        }
+
+        Slot &slot = getSlot(next_index);
+        if ( contains(next_index) && slot.index != next_index ) {
+            storeFrame(slot, next_index, decoded_frame);
+            enforceBudget(index);
+        }
+        next_index++;
+    }
+}
+
+bool ReconstructionWindow::getFrame ( const int index , cv::Mat &frame )
+{
+    frame.release();
+
+    if ( !contains(index) )
+        return false;
+
+    Slot &slot = getSlot(index);
+    if ( slot.index != index )
+        decode(index);
+
+    if ( slot.index == index )
+        frame = slot.frame;
+
+    return !frame.empty();
+}
+
+bool ReconstructionWindow::getFeatures ( const int index , std::vector<cv::KeyPoint> &keypoints , cv::Mat &descriptors )
+{
+    cv::Mat frame;
+    if ( !getFrame(index, frame) )
+        return false;
+
+    Slot &slot = getSlot(index);
+    if ( !slot.described ) {
+        FeatureStore::getStore(video_filename).getKeypointsAndDescriptors(index, frame, slot.keypoints, slot.descriptors);
+        slot.described = true;
+    }
+
+    keypoints = slot.keypoints;
+    descriptors = slot.descriptors;
+    return true;
+}
@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file scratch_arena.cpp
+ *
+ * Reuse of the temporary matrices of the per-frame functions.
+ *
+ */
+
+#include <atomic>
+
+#include "headers/scratch_arena.h"
+
+/** Number of buffers borrowed and allocated by all the arenas. */
+static std::atomic<unsigned long>   num_requests    ( 0 );
+static std::atomic<unsigned long>   num_allocations ( 0 );
+
+ScratchArena::Buffer::Buffer ( const int rows , const int cols , const int type )
+{
+    ScratchArena::getArena().acquire(rows, cols, type, mat);
+    data = mat.data;
+}
+
+ScratchArena::Buffer::Buffer ( const cv::Size size , const int type )
+{
+    ScratchArena::getArena().acquire(size.height, size.width, type, mat);
+    data = mat.data;
+}
+
+ScratchArena::Buffer::~Buffer ( void )
+{
+    ScratchArena::getArena().release(mat, mat.data != data);
+}
+
+ScratchArena& ScratchArena::getArena ( void )
+{
+    static thread_local ScratchArena arena;
+    return arena;
+}
+
+unsigned long ScratchArena::getNumRequests ( void )
+{
+    return num_requests;
+}
+
+unsigned long ScratchArena::getNumAllocations ( void )
+{
+    return num_allocations;
+}
+
+ScratchArena::ScratchArena ( void )
+{
+    free_buffers.reserve(SCRATCH_ARENA_MAX_BUFFERS + 1);
+}
+
+/**
+ * @brief ScratchArena::acquire Takes the most recently returned free buffer with the size and type, or allocates one.
+ * @param rows - number of rows of the buffer.
+ * @param cols - number of columns of the buffer.
+ * @param type - type of the buffer.
+ * @param buffer - object to receive the buffer.
+ */
+void ScratchArena::acquire ( const int rows , const int cols , const int type , cv::Mat &buffer )
+{
+    num_requests++;
+
+    for ( int i = int(free_buffers.size()) - 1 ; i >= 0 ; i-- )
+        if ( free_buffers[i].rows == rows && free_buffers[i].cols == cols && free_buffers[i].type() == type ) {
+            buffer = free_buffers[i];
+            free_buffers.erase(free_buffers.begin() + i);
+            return;
+        }
+
+    num_allocations++;
+    buffer.create(rows, cols, type);
+}
+
+/**
+ * @brief ScratchArena::release Puts the buffer back in the free list, dropping the least recently returned buffer when
+ *          the list is full. A buffer still shared with another matrix is not kept, since it would be overwritten.
+ * @param buffer - buffer borrowed. It is released.
+ * @param reallocated - the buffer was allocated again while borrowed.
+ */
+void ScratchArena::release ( cv::Mat &buffer , const bool reallocated )
+{
+    if ( reallocated )
+        num_allocations++;
+
+    if ( !buffer.empty() && buffer.isContinuous() && buffer.refcount && *buffer.refcount == 1 ) {
+        free_buffers.push_back(buffer);
+        if ( free_buffers.size() > SCRATCH_ARENA_MAX_BUFFERS )
+            free_buffers.erase(free_buffers.begin());
+    }
+
+    buffer.release();
+}
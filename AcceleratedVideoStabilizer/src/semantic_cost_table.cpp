@@ -0,0 +1,130 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file semantic_cost_table.cpp
+ *
+ * In-memory table with the semantic costs of the frame transitions.
+ *
+ * Loads the CSV file with the semantic costs once and answers the transition queries without touching the disk.
+ *
+ */
+
+#include "headers/semantic_cost_table.h"
+
+SemanticCostTable::SemanticCostTable ( void ) :
+    shift(0.0),
+    num_lines(0),
+    band_width(0)
+{
+}
+
+/**
+ * @brief SemanticCostTable::load Reads the whole CSV file with the semantic costs of the frame transitions.
+ * @param filename - complete path and filename of the csv file with the semantic costs.
+ * @return \c bool \b true if the file was read, \b false if it could not be opened.
+ */
+bool SemanticCostTable::load ( const std::string &filename ){
+
+    std::ifstream file ( filename.c_str(), std::ios::in );
+
+    if ( !file.is_open() )
+        return false;
+
+    std::vector< std::vector<double> > lines;
+    std::string line, cell;
+
+    band_width = 0;
+
+    while ( std::getline(file, line) ) {
+        std::istringstream line_stream( line );
+        std::vector<double> line_costs;
+
+        while ( std::getline(line_stream, cell, ',') )
+            line_costs.push_back( std::atof(cell.c_str()) );
+
+        band_width = std::max( band_width, int(line_costs.size()) );
+        lines.push_back( line_costs );
+    }
+
+    file.close();
+
+    // The first value of the header is the number of the first frame described in the file.
+    shift = ( lines.empty() || lines[0].empty() ) ? 0.0 : lines[0][0];
+    num_lines = int(lines.size());
+
+    costs.assign( size_t(num_lines) * size_t(band_width), 0.0 );
+    line_lengths.assign( num_lines, 0 );
+
+    for ( int i = 0 ; i < num_lines ; i++ ) {
+        line_lengths[i] = int(lines[i].size());
+        std::copy( lines[i].begin(), lines[i].end(), costs.begin() + size_t(i) * size_t(band_width) );
+    }
+
+    this->filename = filename;
+
+    return true;
+}
+
+/**
+ * @brief SemanticCostTable::isLoaded Checks if the table was already filled by a call to load().
+ * @return \c bool
+ */
+bool SemanticCostTable::isLoaded ( void ) const {
+    return !filename.empty();
+}
+
+/**
+ * @brief SemanticCostTable::getFilename Returns the name of the file loaded into the table.
+ * @return \c std::string
+ */
+const std::string& SemanticCostTable::getFilename ( void ) const {
+    return filename;
+}
+
+/**
+ * @brief SemanticCostTable::getCost Returns the semantic cost of the transition from the frame_src to the frame_dst.
+ * @param frame_src - first frame of the transition.
+ * @param frame_dst - last frame of the transition.
+ * @param cost - object to save the complementary value ( 1 - x ) of the semantic cost.
+ * @return \c bool \b false if the transition is not described in the file.
+ */
+bool SemanticCostTable::getCost ( const int frame_src , const int frame_dst , double &cost ) const {
+
+    int transition = frame_dst - frame_src;
+
+    // Same value returned by the line-by-line reader when there is no transition to look for.
+    if ( transition <= 0 ) {
+        cost = 1.0 - shift;
+        return true;
+    }
+
+    // The two header lines come before the line of the frame described by the shift value.
+    int line_number = (frame_src-shift+1)+1;
+
+    // Lines out of the file were answered with the header line by the line-by-line reader, keep the same values.
+    if ( line_number < 0 || line_number >= num_lines )
+        line_number = 0;
+
+    if ( line_number >= num_lines || transition > line_lengths[line_number] )
+        return false;
+
+    cost = 1.0 - costs[ size_t(line_number) * size_t(band_width) + size_t(transition - 1) ];
+
+    return true;
+}
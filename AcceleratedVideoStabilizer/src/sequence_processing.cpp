@@ -21,84 +21,24 @@
  *
  * Functions related with sequence processing, such as find intermediate homography, get transition weight, select new frame.
  *
- * Calculate intermediate homography matrix. Calculate matrix operations root and pow. Calculate frame weight. Get transition weight. Select new frame from original video.
+ * Calculate intermediate homography matrix. Calculate frame weight. Get transition weight. Select new frame from original video.
  *
  */
 
+#include <functional>
+#include <thread>
+#include <utility>
+
 #include "definitions/experiment_struct.h"
 
 #include "headers/sequence_processing.h"
 #include "headers/homography.h"
-
-/**
- * @brief Function that calculates the n-ith root of a matrix. Uses the Armadillo lib.
- *
- * @see http://arma.sourceforge.net/
- *
- * @param matrix - matrix to calculate the \c root-th root.
- * @param root - root index.
- * @param matrix_result - object to save the result of the matrix root.
- *
- * @return
- *      \c bool \b true - if the root can be found. \n
- *      \c bool \b false - if the root can not be found.
- *
- * @author Michel Melo da Silva
- * @date 05/05/2016
- */
-bool matrixRoot ( cv::Mat &matrix, int root, cv::Mat &matrix_result ) {
-    arma::mat arma_mat(reinterpret_cast<double*>(matrix.data), matrix.rows, matrix.cols );
-    arma_mat = arma_mat.t();
-
-    int iterations = std::log(root)/std::log(2);
-    arma::cx_mat aux (arma_mat, arma::zeros(arma_mat.n_rows, arma_mat.n_cols)) ;
-
-    arma::cx_mat arma_mat_check_shur ;
-    arma::vec arma_vec_check_singluar;
-
-    for (int i = 0; i < iterations; ++i) {
-        // Check if the matrix is singular and the schur decomposition.
-        if ( !arma::schur( arma_mat_check_shur , aux ) || !arma::svd( arma_vec_check_singluar , aux ) ){
-            return false;
-        }
-        aux = arma::sqrtmat(aux);
-    }
-
-    arma_mat = real(aux).t();
-
-    matrix_result = cv::Mat( arma_mat.n_rows, arma_mat.n_cols, CV_64F, arma_mat.memptr() ).clone();
-
-    return true;
-}
-
-/**
- * @brief Function that calculates the n-ith pow of a matrix. Uses the Armadillo lib.
- *
- * @see http://arma.sourceforge.net/
- *
- * @param matrix - matrix to calculate the \c pow-th pow.
- * @param pow - pow index.
- * @param matrix_result - object to save the result of the matrix pow.
- *
- * @return \c void
- *
- * @author Washington Luis de Souza Ramos
- * @date 06/04/2016
- */
-void matrixPow ( cv::Mat &matrix, int pow, cv::Mat &matrix_result ) {
-
-    matrix_result = cv::Mat::eye(matrix.size(), matrix.type());// matrix.clone();
-    cv::Mat base = matrix.clone();
-
-    while(pow)
-    {
-        if(pow & 1)
-            matrix_result *= base;
-        pow >>= 1;
-        base *= base;
-    }
-
-}
+#include "headers/homography_interpolation.h"
+#include "headers/frame_cache.h"
+#include "headers/feature_store.h"
+#include "headers/candidate_score_cache.h"
+#include "headers/master_frames.h"
+#include "headers/blocking_queue.h"
 
 /**
  * @brief Function that calculates the homography matrix that leave the frame_i to the intermediate plan between the plans of frame_master_pre and frame_master_pre
@@ -125,9 +65,7 @@ bool findIntermediateHomographyMatrix ( const int d, const int D, const int N ,
 
     cv::Mat homography_matrix_to_master_pre,
             homography_matrix_to_master_pos,
-            H_pre_exp(3,3,CV_64F),
             H_pre(3,3,CV_64F),
-            H_pos_exp(3,3,CV_64F),
             H_pos(3,3,CV_64F);
 
     bool bool_pre = false,
@@ -138,13 +76,11 @@ bool findIntermediateHomographyMatrix ( const int d, const int D, const int N ,
             exp_pre = root - exp_pos;
 
     if ( findHomographyMatrix ( frame_i, frame_master_pre, homography_matrix_to_master_pre ) ) {
-        matrixPow(homography_matrix_to_master_pre, exp_pre, H_pre_exp);
-        bool_pre = matrixRoot(H_pre_exp, root, H_pre);
+        bool_pre = HomographyPower(homography_matrix_to_master_pre).pow(exp_pre, root, H_pre);
     }
 
     if ( findHomographyMatrix ( frame_i, frame_master_pos, homography_matrix_to_master_pos ) ) {
-        matrixPow(homography_matrix_to_master_pos, exp_pos, H_pos_exp);
-        bool_pos = matrixRoot(H_pos_exp, root, H_pos);
+        bool_pos = HomographyPower(homography_matrix_to_master_pos).pow(exp_pos, root, H_pos);
     }
 
     // raiz "root" de homography_matrix_to_master_pre elevado a "exp" ) vezes ( raiz "root" de homography_matrix_to_master_pre elevado a "exp_pos" );
@@ -191,11 +127,46 @@ bool findIntermediateHomographyMatrix ( const int d, const int D, const int N ,
                                         cv::Mat& homography_matrix_result ){
 
     std::vector<cv::KeyPoint> keypoints_frame_i;
-    cv::Mat descriptors_frame_i, ransac_mask;//TODO: Remove useless ransac_mask (create a new findHomography function)
+    cv::Mat descriptors_frame_i;
 
     //Load the descriptors of the frame i
     getKeypointsAndDescriptors(frame_i, keypoints_frame_i, descriptors_frame_i);
 
+    return findIntermediateHomographyMatrix( d, D, N, keypoints_frame_i, descriptors_frame_i,
+                                             keypoints_master_pre, keypoints_master_pos,
+                                             descriptors_master_pre, descriptors_master_pos, homography_matrix_result );
+}
+
+/**
+ * @brief Function that calculates the homography matrix that leave the frame_i to the intermediate plan between
+ *          the frames related to the previous and posterior master, with respect to the distance between them.
+ *
+ * @param d - distance between the current frame and the previous master frame.
+ * @param D - distance between previous master frame and the posterior master frame.
+ * @param N - size of the segments.
+ * @param keypoints_frame_i - keypoints of the current frame.
+ * @param descriptors_frame_i - descriptors of the current frame.
+ * @param keypoints_master_pre - keypoints of the previous master.
+ * @param keypoints_master_pos - keypoints of the posterior master.
+ * @param descriptors_master_pre - descriptors of the previous master.
+ * @param descriptors_master_pos - descriptors of the posterior master.
+ * @param homography_matrix_result - object to save the result homography matrix.
+ *
+ * @return
+ *      \c bool \b true - if there is enough points in both images and good matches between them to find a homography matrix. \n
+ *      \c bool \c false - if there is not enough points in both images or good matches between them to find a homography matrix.
+ *
+ * @date 17/10/2026
+ */
+bool findIntermediateHomographyMatrix ( const int d, const int D, const int N ,
+                                        const std::vector<cv::KeyPoint> &keypoints_frame_i,
+                                        const cv::Mat &descriptors_frame_i,
+                                        const std::vector<cv::KeyPoint> &keypoints_master_pre,
+                                        const std::vector<cv::KeyPoint> &keypoints_master_pos,
+                                        const cv::Mat &descriptors_master_pre,
+                                        const cv::Mat &descriptors_master_pos,
+                                        cv::Mat& homography_matrix_result ){
+
     if(keypoints_master_pre.empty() && descriptors_master_pre.empty()){
         return findHomographyMatrix(keypoints_frame_i, keypoints_master_pos,
                                                      descriptors_frame_i, descriptors_master_pos,
@@ -208,9 +179,7 @@ bool findIntermediateHomographyMatrix ( const int d, const int D, const int N ,
 
     cv::Mat homography_matrix_to_master_pre,
             homography_matrix_to_master_pos,
-            H_pre_exp(3,3,CV_64F),
             H_pre(3,3,CV_64F),
-            H_pos_exp(3,3,CV_64F),
             H_pos(3,3,CV_64F);
 
     bool bool_pre = false,
@@ -221,15 +190,13 @@ bool findIntermediateHomographyMatrix ( const int d, const int D, const int N ,
             exp_pre = root - exp_pos;
 
     if (findHomographyMatrix (keypoints_frame_i, keypoints_master_pre, descriptors_frame_i,
-                              descriptors_master_pre, homography_matrix_to_master_pre, ransac_mask)) {
-        matrixPow(homography_matrix_to_master_pre, exp_pre, H_pre_exp);
-        bool_pre = matrixRoot(H_pre_exp, root, H_pre);
+                              descriptors_master_pre, homography_matrix_to_master_pre, true)) {
+        bool_pre = HomographyPower(homography_matrix_to_master_pre).pow(exp_pre, root, H_pre);
     }
 
     if (findHomographyMatrix (keypoints_frame_i, keypoints_master_pos, descriptors_frame_i,
-                              descriptors_master_pos, homography_matrix_to_master_pos, ransac_mask)) {
-        matrixPow(homography_matrix_to_master_pos, exp_pos, H_pos_exp);
-        bool_pos = matrixRoot(H_pos_exp, root, H_pos);
+                              descriptors_master_pos, homography_matrix_to_master_pos, true)) {
+        bool_pos = HomographyPower(homography_matrix_to_master_pos).pow(exp_pos, root, H_pos);
     }
 
     // raiz "root" de homography_matrix_to_master_pre elevado a "exp" ) vezes ( raiz "root" de homography_matrix_to_master_pre elevado a "exp_pos" );
@@ -272,11 +239,45 @@ bool findIntermediateHomographyMatrix (const float s, const float S, const cv::M
                                         cv::Mat& homography_matrix_result){
 
     std::vector<cv::KeyPoint> keypoints_frame_i;
-    cv::Mat descriptors_frame_i, ransac_mask;//TODO: Remove useless ransac_mask (create a new findHomography function)
+    cv::Mat descriptors_frame_i;
 
     //Load the descriptors of the frame i
     getKeypointsAndDescriptors(frame_i, keypoints_frame_i, descriptors_frame_i);
 
+    return findIntermediateHomographyMatrix( s, S, keypoints_frame_i, descriptors_frame_i,
+                                             keypoints_master_pre, keypoints_master_pos,
+                                             descriptors_master_pre, descriptors_master_pos, homography_matrix_result );
+}
+
+/**
+ * @brief Function that calculates the homography matrix that leave the frame_i to the intermediate plan between
+ *          the frames related to the previous and posterior master, with respect to the distance between them.
+ *
+ * @param s - frame shift value between the previous master frame and the current frame.
+ * @param S - frame shift between previous master frame and the posterior master frame.
+ * @param keypoints_frame_i - keypoints of the current frame.
+ * @param descriptors_frame_i - descriptors of the current frame.
+ * @param keypoints_master_pre - keypoints of the previous master.
+ * @param keypoints_master_pos - keypoints of the posterior master.
+ * @param descriptors_master_pre - descriptors of the previous master.
+ * @param descriptors_master_pos - descriptors of the posterior master.
+ * @param homography_matrix_result - object to save the result homography matrix.
+ *
+ * @return
+ *      \c bool \b true - if there is enough points in both images and good matches between them to find a homography matrix. \n
+ *      \c bool \c false - if there is not enough points in both images or good matches between them to find a homography matrix.
+ *
+ * @date 17/10/2026
+ */
+bool findIntermediateHomographyMatrix (const float s, const float S,
+                                        const std::vector<cv::KeyPoint> &keypoints_frame_i,
+                                        const cv::Mat &descriptors_frame_i,
+                                        const std::vector<cv::KeyPoint> &keypoints_master_pre,
+                                        const std::vector<cv::KeyPoint> &keypoints_master_pos,
+                                        const cv::Mat &descriptors_master_pre,
+                                        const cv::Mat &descriptors_master_pos,
+                                        cv::Mat& homography_matrix_result){
+
     if((keypoints_master_pre.empty() && descriptors_master_pre.empty()) || s == S){
         return findHomographyMatrix(keypoints_frame_i, keypoints_master_pos,
                                                      descriptors_frame_i, descriptors_master_pos,
@@ -289,9 +290,7 @@ bool findIntermediateHomographyMatrix (const float s, const float S, const cv::M
 
     cv::Mat homography_matrix_to_master_pre,
             homography_matrix_to_master_pos,
-            H_pre_exp(3,3,CV_64F),
             H_pre(3,3,CV_64F),
-            H_pos_exp(3,3,CV_64F),
             H_pos(3,3,CV_64F);
 
     bool bool_pre = false,
@@ -303,15 +302,13 @@ bool findIntermediateHomographyMatrix (const float s, const float S, const cv::M
             exp_pre = root - exp_pos;
 
     if (findHomographyMatrix (keypoints_frame_i, keypoints_master_pre, descriptors_frame_i,
-                              descriptors_master_pre, homography_matrix_to_master_pre, ransac_mask)) {
-        matrixPow(homography_matrix_to_master_pre, exp_pre, H_pre_exp);
-        bool_pre = matrixRoot(H_pre_exp, root, H_pre);
+                              descriptors_master_pre, homography_matrix_to_master_pre, true)) {
+        bool_pre = HomographyPower(homography_matrix_to_master_pre).pow(exp_pre, root, H_pre);
     }
 
     if (findHomographyMatrix (keypoints_frame_i, keypoints_master_pos, descriptors_frame_i,
-                              descriptors_master_pos, homography_matrix_to_master_pos, ransac_mask)) {
-        matrixPow(homography_matrix_to_master_pos, exp_pos, H_pos_exp);
-        bool_pos = matrixRoot(H_pos_exp, root, H_pos);
+                              descriptors_master_pos, homography_matrix_to_master_pos, true)) {
+        bool_pos = HomographyPower(homography_matrix_to_master_pos).pow(exp_pos, root, H_pos);
     }
 
     // raiz "root" de homography_matrix_to_master_pre elevado a "exp" ) vezes ( raiz "root" de homography_matrix_to_master_pre elevado a "exp_pos" );
@@ -381,6 +378,86 @@ double semantic_weight ( const int index_previous , const int index_current , co
     return getSemanticCost(experiment_settings, index_previous , index_current ) + getSemanticCost(experiment_settings, index_current, index_posterior) ;
 }
 
+/**
+ * @brief Function that returns the features of a frame from the FeatureStore, decoding and describing the frame only if
+ *          they are not stored yet.
+ *
+ * @param feature_store - feature store of the video.
+ * @param video_filename - complete path and filename of the video.
+ * @param index - index of the frame in the video.
+ * @param keypoints - object to receive the keypoints of the frame, empty if it can not be decoded.
+ * @param descriptors - object to receive the descriptors of the frame.
+ *
+ * @date 17/10/2026
+ */
+static void getStoredFeatures ( FeatureStore &feature_store , const std::string &video_filename , const int index ,
+                                std::vector<cv::KeyPoint> &keypoints , cv::Mat &descriptors ) {
+
+    if ( feature_store.lookup(index, keypoints, descriptors) )
+        return;
+
+    cv::Mat frame;
+    FrameCache::getInstance().getFrame(video_filename, index, frame);
+    feature_store.getKeypointsAndDescriptors(index, frame, keypoints, descriptors);
+}
+
+/**
+ * @brief Function that scores the candidates of the selectNewFrame that are not in the CandidateScoreCache. The calling
+ *          thread decodes the candidates in order, so the FrameCache reads the window sequentially, and hands them to
+ *          worker threads through a bounded queue. Each worker scores a candidate at a time and keeps its score in the
+ *          cache. As in the serial loop, the candidates after a frame that can not be decoded are not evaluated.
+ *
+ * @param experiment_settings - experiment settings struct.
+ * @param candidates - indexes of the candidates in the original video, in order.
+ * @param missing - positions in the candidates of the ones to be scored, in order.
+ * @param keys - keys of the candidates in the cache.
+ * @param scores - object to save the scores of the candidates, in the same positions.
+ * @param score_candidate - function that scores a candidate given its index and its frame. It is called by several threads.
+ *
+ * @return \c int - number of candidates that can be evaluated, all of them unless a frame can not be decoded.
+ *
+ * @date 17/10/2026
+ */
+static int scoreCandidates ( const EXPERIMENT &experiment_settings , const std::vector<int> &candidates , const std::vector<int> &missing ,
+                             const std::vector<CandidateScoreCache::Key> &keys , std::vector<CandidateScoreCache::Score> &scores ,
+                             const std::function< CandidateScoreCache::Score ( const int , const cv::Mat& ) > &score_candidate ) {
+
+    FrameCache &frame_cache = FrameCache::getInstance();
+    CandidateScoreCache &score_cache = CandidateScoreCache::getInstance();
+
+    const int num_workers = std::max(1, std::min(getNumberOfThreads(experiment_settings), int(missing.size())));
+    int num_candidates = int(candidates.size());
+
+    // Each decoded candidate is a read-only header of the FrameCache, with its position in the candidates.
+    BlockingQueue< std::pair<int, cv::Mat> > decoded_candidates ( SELECTION_FRAMES_PER_WORKER * num_workers );
+
+    std::vector<std::thread> workers;
+    for ( int i_worker = 0 ; i_worker < num_workers ; i_worker++ )
+        workers.push_back(std::thread([&] {
+            std::pair<int, cv::Mat> candidate;
+
+            while ( decoded_candidates.pop(candidate) ) {
+                scores[candidate.first] = score_candidate(candidates[candidate.first], candidate.second);
+                score_cache.insert(keys[candidate.first], scores[candidate.first]);
+            }
+        }));
+
+    for ( unsigned int k = 0 ; k < missing.size() ; k++ ) {
+        cv::Mat frame;
+        if ( !frame_cache.getFrame(experiment_settings.original_video_filename, candidates[missing[k]], frame) ) {
+            num_candidates = missing[k];
+            break;
+        }
+        decoded_candidates.push(std::make_pair(missing[k], frame));
+    }
+    decoded_candidates.close();
+
+    for ( unsigned int i = 0 ; i < workers.size() ; i++ )
+        workers[i].join();
+
+    return num_candidates;
+}
+
 /**
  * @brief Function that selects a new frame in the original video using the values of semantic information of the transition from the frame_src to the frame_dst calculted by
  *          MATLAB and saved in a CSV file, the area ratio of the iamge after apply the homography transformation and the RANSCAC inliers from the previous and posterior frames
@@ -392,11 +469,13 @@ double semantic_weight ( const int index_previous , const int index_current , co
  * @param index - index of the frame that will be replaced.
  * @param index_previous - index of the last frame in the reduced video.
  * @param index_posterior - index of the next frame in the reduced video.
+ * @param master_pre - index of the previous master frame in the accelerated video.
+ * @param master_pos - index of the posterior master frame in the accelerated video.
  * @param image_master_previous - image with the master previous
  * @param image_master_posterior - image with the master posterior
  * @param crop_area - crop area of the video.
  * @param experiment_settings - experiment settings struct.
- * @param new_frame - image that will receive the new selected frame.
+ * @param new_frame - object to receive the read-only header of the new selected frame, shared with the FrameCache.
  *
  * @return \c int - returns the index of the new selected frame.
  *
@@ -404,22 +483,20 @@ double semantic_weight ( const int index_previous , const int index_current , co
  * @date 30/04/2016
  */
 int selectNewFrame ( const int d, const int D, const int N , const int index , const int index_previous , const int index_posterior ,
+                     const int master_pre , const int master_pos ,
                      const std::vector<cv::KeyPoint> &keypoints_master_pre, const std::vector<cv::KeyPoint> &keypoints_master_pos,
                      const cv::Mat &descriptors_master_pre, const cv::Mat &descriptors_master_pos, const cv::Rect& crop_area ,
                      const EXPERIMENT& experiment_settings , cv::Mat& new_frame ) {
 
-    cv::VideoCapture video ( experiment_settings.original_video_filename );
+    FrameCache &frame_cache = FrameCache::getInstance();
 
-    if ( !video.isOpened() ) {
+    if ( !frame_cache.isOpened(experiment_settings.original_video_filename) ) {
         std::cout << " --(!) ERROR: Can not open the original video \"" << experiment_settings.original_video_filename << "\"." << std::endl;
         exit(-5);
     }
 
-    cv::Mat image_index_previous ,
-            image_index_posterior ,
-            current_frame ,
-            homography_matrix ,
-            ransac_mask ;
+    FeatureStore &feature_store = FeatureStore::getStore(experiment_settings.original_video_filename);
+    CandidateScoreCache &score_cache = CandidateScoreCache::getInstance();
 
     int index_previous_process = index_previous ,
             index_posterior_process = index_posterior ,
@@ -430,69 +507,94 @@ int selectNewFrame ( const int d, const int D, const int N , const int index , c
         index_posterior_process = std::min(index_posterior, index_previous_process + 100);
     }
 
-    video.set(CV_CAP_PROP_POS_FRAMES, index_posterior_process);
-    video.read(image_index_posterior);
-    video.set(CV_CAP_PROP_POS_FRAMES, index_previous_process);
-    video.read(image_index_previous);
+    std::vector<int> candidates;
+    for ( int i = index_previous_process+1 ; i < index_posterior_process ; i++ )
+        if ( i != index )
+            candidates.push_back(i);
+
+    std::vector<CandidateScoreCache::Key> keys ( candidates.size() );
+    std::vector<CandidateScoreCache::Score> scores ( candidates.size() );
+    std::vector<int> missing;
+
+    for ( unsigned int k = 0 ; k < candidates.size() ; k++ ) {
+        const CandidateScoreCache::Key key = { candidates[k] , index_previous_process , index_posterior_process , master_pre , master_pos , N ,
+                                               float(d) , float(D) , false };
+        keys[k] = key;
+        if ( !score_cache.lookup(keys[k], scores[k]) )
+            missing.push_back(k);
+    }
+
+    int num_candidates = int(candidates.size());
 
-    double weight_max = 0.0f;
+    // The features of the ends of the window are only needed when a candidate is not in the cache, and are described once for all candidates.
+    if ( !missing.empty() ) {
+        std::vector<cv::KeyPoint> keypoints_index_previous ,
+                keypoints_index_posterior ;
+        cv::Mat descriptors_index_previous ,
+                descriptors_index_posterior ;
 
-    // In this moment the read head is at the position index_previous plus one.
-    for ( int i = index_previous_process+1 ; i < index_posterior_process ; i++ ) {
+        getStoredFeatures( feature_store , experiment_settings.original_video_filename , index_previous_process ,
+                           keypoints_index_previous , descriptors_index_previous );
+        getStoredFeatures( feature_store , experiment_settings.original_video_filename , index_posterior_process ,
+                           keypoints_index_posterior , descriptors_index_posterior );
 
-        if ( i == index)
-            continue;
+        num_candidates = scoreCandidates( experiment_settings , candidates , missing , keys , scores ,
+                                          [&]( const int i , const cv::Mat &current_frame ) {
+            CandidateScoreCache::Score score = { 0 , 0 , 0.0 };
+            cv::Mat homography_matrix ,
+                    descriptors_frame_i ;
+            std::vector<cv::KeyPoint> keypoints_frame_i;
 
-        int inliers_previous = 0 ,
-                inliers_posterior = 0 ;
+            feature_store.getKeypointsAndDescriptors(i, current_frame, keypoints_frame_i, descriptors_frame_i);
 
-        double area_ratio = 0.0f,
-                current_weight = 0.0f,
-                semantic_cost = 0.0f;
+            // The inliers to the ends of the window keep the minimum distance threshold of the matches between the images.
+            score.inliers_previous = countHomographyInliers(keypoints_frame_i, keypoints_index_previous, descriptors_frame_i, descriptors_index_previous, 0, false);
+            score.inliers_posterior = countHomographyInliers(keypoints_frame_i, keypoints_index_posterior, descriptors_frame_i, descriptors_index_posterior, 0, false);
 
-        video >> current_frame ;
+            if ( findIntermediateHomographyMatrix( d, D, N, keypoints_frame_i, descriptors_frame_i, keypoints_master_pre, keypoints_master_pos,
+                                                   descriptors_master_pre, descriptors_master_pos, homography_matrix ) ) {
 
-        if ( findHomographyMatrix(current_frame, image_index_previous, homography_matrix, ransac_mask) )
-            inliers_previous = cv::sum(ransac_mask)[0];
+                score.area_ratio = 1 - getAreaRatio( current_frame , homography_matrix , crop_area ) ;
 
-        if ( findHomographyMatrix(current_frame, image_index_posterior, homography_matrix, ransac_mask) )
-            inliers_posterior = cv::sum(ransac_mask)[0];
+                if ( score.area_ratio < MAXIMUM_AREA_ALLOWED )
+                    score.area_ratio = 0.0f;
 
-        if ( findIntermediateHomographyMatrix( d, D, N, current_frame, keypoints_master_pre, keypoints_master_pos,
-                                               descriptors_master_pre, descriptors_master_pos, homography_matrix ) ) {
+            }
 
-            area_ratio = 1 - getAreaRatio( current_frame , homography_matrix , crop_area ) ;
+            return score;
+        } );
+    }
 
-            if ( area_ratio < MAXIMUM_AREA_ALLOWED )
-                area_ratio = 0.0f;
+    // The reduction follows the order of the candidates, so the first of the best weights is selected as in the serial loop.
+    double weight_max = 0.0f;
 
-        }
+    for ( int k = 0 ; k < num_candidates ; k++ ) {
 
-        semantic_cost = semantic_weight( index_previous_process , i , index_posterior_process , experiment_settings ) ;
+        const CandidateScoreCache::Score &score = scores[k];
 
-        current_weight = frameWeight( inliers_previous, inliers_posterior , area_ratio ,  semantic_cost );
+        double semantic_cost = semantic_weight( index_previous_process , candidates[k] , index_posterior_process , experiment_settings ) ,
+                current_weight = frameWeight( score.inliers_previous, score.inliers_posterior , score.area_ratio ,  semantic_cost );
 
         if ( current_weight > weight_max ) {
-            new_frame = current_frame.clone();
             weight_max = current_weight;
-            new_index = i;
+            new_index = candidates[k];
         }
 
         //        std::cout << "Previous: " << index_previous << std::endl;
         //        std::cout << "Posterior: " << index_posterior << std::endl;
         //        std::cout << "Index: " << index << std::endl;
-        //        std::cout << "Inliers previous: " << inliers_previous << std::endl;
-        //        std::cout << "Inliers posterior: " << inliers_posterior << std::endl;
-        //        std::cout << "Area ratio: " << area_ratio << std::endl;
-        //        std::cout << "Area ratio Gaussian value: " << gaussianValue(area_ratio) << std::endl;
+        //        std::cout << "Inliers previous: " << score.inliers_previous << std::endl;
+        //        std::cout << "Inliers posterior: " << score.inliers_posterior << std::endl;
+        //        std::cout << "Area ratio: " << score.area_ratio << std::endl;
+        //        std::cout << "Area ratio Gaussian value: " << gaussianValue(score.area_ratio) << std::endl;
         //        std::cout << "Semantic cost: " << semantic_cost << std::endl;
         //        std::cout << "current cost: " << current_weight << std::endl;
-
-        //        cv::rectangle( result , crop_area , cv::Scalar(0,255,0) , 2 ) ;
-        //        cv::imshow("nova_video", result);
-        //        cv::waitKey(0);
     }
 
+    // The scores of the cache do not need the frames, so only the selected one is read.
+    if ( new_index != index_previous_process )
+        frame_cache.getFrame(experiment_settings.original_video_filename, new_index, new_frame);
+
     return new_index ;
 
 }
@@ -507,11 +609,13 @@ int selectNewFrame ( const int d, const int D, const int N , const int index , c
  * @param index - index of the frame that will be replaced.
  * @param index_previous - index of the last frame in the reduced video.
  * @param index_posterior - index of the next frame in the reduced video.
+ * @param master_pre - index of the previous master frame in the accelerated video.
+ * @param master_pos - index of the posterior master frame in the accelerated video.
  * @param image_master_previous - image with the master previous
  * @param image_master_posterior - image with the master posterior
  * @param crop_area - crop area of the video.
  * @param experiment_settings - experiment settings struct.
- * @param new_frame - image that will receive the new selected frame.
+ * @param new_frame - object to receive the read-only header of the new selected frame, shared with the FrameCache.
  *
  * @return \c int - returns the index of the new selected frame.
  *
@@ -519,29 +623,20 @@ int selectNewFrame ( const int d, const int D, const int N , const int index , c
  * @date 08/09/2016
  */
 int selectNewFrame ( const float s, const float S, const int index , const int index_previous , const int index_posterior ,
+                     const int master_pre , const int master_pos ,
                      const std::vector<cv::KeyPoint> &keypoints_master_pre, const std::vector<cv::KeyPoint> &keypoints_master_pos,
                      const cv::Mat &descriptors_master_pre, const cv::Mat &descriptors_master_pos, const cv::Rect& crop_area ,
                      const EXPERIMENT& experiment_settings , cv::Mat& new_frame ) {
 
-    cv::VideoCapture video ( experiment_settings.original_video_filename );
+    FrameCache &frame_cache = FrameCache::getInstance();
 
-    if ( !video.isOpened() ) {
+    if ( !frame_cache.isOpened(experiment_settings.original_video_filename) ) {
         std::cout << " --(!) ERROR: Can not open the original video \"" << experiment_settings.original_video_filename << "\"." << std::endl;
         exit(-5);
     }
 
-    cv::Mat image_index_previous ,
-            image_index_posterior ,
-            current_frame ,
-            homography_matrix ,
-            result ;
-
-    video.set(CV_CAP_PROP_POS_FRAMES, index_posterior);
-    video.read(image_index_posterior);
-    video.set(CV_CAP_PROP_POS_FRAMES, index_previous);
-    video.read(image_index_previous);
-
-    double weight_max = 0.0d;
+    FeatureStore &feature_store = FeatureStore::getStore(experiment_settings.original_video_filename);
+    CandidateScoreCache &score_cache = CandidateScoreCache::getInstance();
 
     int index_previous_process = index_previous ,
             index_posterior_process = index_posterior ,
@@ -550,61 +645,75 @@ int selectNewFrame ( const float s, const float S, const int index , const int i
     if ( index_posterior-index_previous > 100 ) {
         index_previous_process = std::max(index_previous, index_posterior - 100);
         index_posterior_process = std::min(index_posterior, index_previous + 100);
-        video.set(CV_CAP_PROP_POS_FRAMES, index_previous_process);
     }
 
-    // In this moment the read head is at the position index_previous plus one.
-    for ( int i = index_previous_process+1 ; i < index_posterior_process ; i++ ) {
-
-        if ( i == index)
-            continue;
+    std::vector<int> candidates;
+    for ( int i = index_previous_process+1 ; i < index_posterior_process ; i++ )
+        if ( i != index )
+            candidates.push_back(i);
+
+    std::vector<CandidateScoreCache::Key> keys ( candidates.size() );
+    std::vector<CandidateScoreCache::Score> scores ( candidates.size() );
+    std::vector<int> missing;
+
+    for ( unsigned int k = 0 ; k < candidates.size() ; k++ ) {
+        const CandidateScoreCache::Key key = { candidates[k] , index_previous_process , index_posterior_process , master_pre , master_pos , 0 ,
+                                               s , S , true };
+        keys[k] = key;
+        if ( !score_cache.lookup(keys[k], scores[k]) )
+            missing.push_back(k);
+    }
 
-        int inliers_previous = 0 ,
-                inliers_posterior = 0 ;
+    int num_candidates = int(candidates.size());
 
-        double area_ratio = 0.0d ,
-                current_weight = 0.0d ,
-                semantic_cost = 0.0d ;
+    if ( !missing.empty() )
+        num_candidates = scoreCandidates( experiment_settings , candidates , missing , keys , scores ,
+                                          [&]( const int i , const cv::Mat &current_frame ) {
+            CandidateScoreCache::Score score = { 0 , 0 , 0.0 };
+            cv::Mat homography_matrix;
 
-        video >> current_frame ;
+            std::vector<cv::KeyPoint> keypoints_frame_i;
+            cv::Mat descriptors_frame_i;
 
-        std::vector<cv::KeyPoint> keypoints_frame_i;
-        cv::Mat descriptors_frame_i, ransac_mask;//TODO: Remove useless ransac_mask (create a new findHomography function)
+            //Load the descriptors of the frame i
+            feature_store.getKeypointsAndDescriptors(i, current_frame, keypoints_frame_i, descriptors_frame_i);
 
-        //Load the descriptors of the frame i
-        getKeypointsAndDescriptors(current_frame, keypoints_frame_i, descriptors_frame_i);
+            score.inliers_previous = countHomographyInliers(keypoints_frame_i, keypoints_master_pre, descriptors_frame_i, descriptors_master_pre);
+            score.inliers_posterior = countHomographyInliers(keypoints_frame_i, keypoints_master_pos, descriptors_frame_i, descriptors_master_pos);
 
-        if (findHomographyMatrix (keypoints_frame_i, keypoints_master_pre, descriptors_frame_i,
-                                  descriptors_master_pre, homography_matrix, ransac_mask))
-            inliers_previous = cv::sum(ransac_mask)[0];
+            if (findIntermediateHomographyMatrix( s , S , keypoints_frame_i, descriptors_frame_i, keypoints_master_pre, keypoints_master_pos,
+                                                   descriptors_master_pre, descriptors_master_pos, homography_matrix )) {
 
-        if (findHomographyMatrix (keypoints_frame_i, keypoints_master_pos, descriptors_frame_i,
-                                  descriptors_master_pos, homography_matrix, ransac_mask))
-            inliers_posterior = cv::sum(ransac_mask)[0];
+                score.area_ratio = 1 - getAreaRatio( current_frame , homography_matrix , crop_area ) ;
 
-        if (findIntermediateHomographyMatrix( s , S , current_frame, keypoints_master_pre, keypoints_master_pos,
-                                               descriptors_master_pre, descriptors_master_pos, homography_matrix )) {
+                if ( score.area_ratio < MAXIMUM_AREA_ALLOWED )
+                    score.area_ratio = 0.0d;
 
-            applyHomographyMatrix( current_frame , homography_matrix , result );
+            }
 
-            area_ratio = 1 - getAreaRatio( current_frame , homography_matrix , crop_area ) ;
+            return score;
+        } );
 
-            if ( area_ratio < MAXIMUM_AREA_ALLOWED )
-                area_ratio = 0.0d;
+    // The reduction follows the order of the candidates, so the first of the best weights is selected as in the serial loop.
+    double weight_max = 0.0d;
 
-        }
+    for ( int k = 0 ; k < num_candidates ; k++ ) {
 
-        semantic_cost = semantic_weight( index_previous , i , index_posterior , experiment_settings ) ;
+        const CandidateScoreCache::Score &score = scores[k];
 
-        current_weight = frameWeight( inliers_previous, inliers_posterior , area_ratio ,  semantic_cost );
+        double semantic_cost = semantic_weight( index_previous , candidates[k] , index_posterior , experiment_settings ) ,
+                current_weight = frameWeight( score.inliers_previous, score.inliers_posterior , score.area_ratio ,  semantic_cost );
 
         if ( current_weight > weight_max ) {
-            new_frame = current_frame.clone();
             weight_max = current_weight;
-            new_index = i;
+            new_index = candidates[k];
         }
 
     }
 
+    // The scores of the cache do not need the frames, so only the selected one is read.
+    if ( new_index != index_previous_process )
+        frame_cache.getFrame(experiment_settings.original_video_filename, new_index, new_frame);
+
     return new_index;
 }
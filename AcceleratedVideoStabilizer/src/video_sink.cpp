@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file video_sink.cpp
+ *
+ * Encoding of the output video in a dedicated thread.
+ *
+ */
+
+#include "headers/video_sink.h"
+
+VideoSink::VideoSink ( void ) :
+    max_queue_depth(0),
+    num_stalls(0)
+{
+}
+
+VideoSink::~VideoSink ( void )
+{
+    release();
+}
+
+bool VideoSink::open ( const std::string &filename , const int fourcc , const double fps , const cv::Size frame_size )
+{
+    release();
+
+    if ( !writer.open(filename, fourcc, fps, frame_size) )
+        return false;
+
+    frames.reset(new BlockingQueue<cv::Mat>(VIDEO_SINK_QUEUE_SIZE));
+    encoder = std::thread(&VideoSink::encode, this);
+    return true;
+}
+
+bool VideoSink::isOpened ( void ) const
+{
+    return writer.isOpened();
+}
+
+void VideoSink::write ( const cv::Mat &frame )
+{
+    cv::Mat buffer;
+    {
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        if ( !free_buffers.empty() ) {
+            buffer = free_buffers.back();
+            free_buffers.pop_back();
+        }
+    }
+
+    // The buffer is only allocated while the queue is growing.
+    frame.copyTo(buffer);
+
+    size_t depth = frames->size();
+    if ( depth >= VIDEO_SINK_QUEUE_SIZE )
+        num_stalls++;
+
+    frames->push(buffer);
+
+    if ( depth + 1 > max_queue_depth )
+        max_queue_depth = std::min(depth + 1, size_t(VIDEO_SINK_QUEUE_SIZE));
+}
+
+void VideoSink::release ( void )
+{
+    if ( encoder.joinable() ) {
+        frames->close();
+        encoder.join();
+    }
+
+    writer.release();
+}
+
+size_t VideoSink::getQueueDepth ( void ) const
+{
+    return frames ? frames->size() : 0;
+}
+
+size_t VideoSink::getMaxQueueDepth ( void ) const
+{
+    return max_queue_depth;
+}
+
+unsigned long VideoSink::getNumStalls ( void ) const
+{
+    return num_stalls;
+}
+
+bool VideoSink::parseCodec ( const std::string &name , int &fourcc )
+{
+    if ( name.empty() ) {
+        fourcc = CV_FOURCC('m','p','4','v');
+        return true;
+    }
+
+    if ( name.size() != 4 )
+        return false;
+
+    fourcc = CV_FOURCC(name[0], name[1], name[2], name[3]);
+    return true;
+}
+
+/**
+ * @brief VideoSink::encode Loop of the encoder thread, which saves the frames of the queue in order until it is closed.
+ */
+void VideoSink::encode ( void )
+{
+    cv::Mat frame;
+    while ( frames->pop(frame) ) {
+        writer << frame;
+
+        std::lock_guard<std::mutex> lock(buffers_mutex);
+        free_buffers.push_back(frame);
+        frame.release();
+    }
+}
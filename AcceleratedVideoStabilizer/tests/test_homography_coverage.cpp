@@ -0,0 +1,217 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file test_homography_coverage.cpp
+ *
+ * Checks the getHomogCoverage against the coverage of the first versions, which warped a white 3-channel mask of the
+ * whole image and counted the pixels of the ROI left black by the Otsu threshold. The decisions are compared over
+ * random homographies and drop and crop areas. They may only differ when the area ratio of the raster is within one
+ * pixel of border from the MAXIMUM_AREA_ALLOWED, where the raster and the exact area round differently.
+ *
+ * Returns 0 if all the checks pass.
+ *
+ */
+
+#include <iostream>
+
+#include <opencv2/core/core.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "definitions/define.h"
+#include "headers/homography.h"
+
+/** Number of random homographies checked. */
+#define TEST_NUM_HOMOGRAPHIES           2000
+
+/** Size of the frames. Small, so the warps of the baseline are fast. */
+#define TEST_FRAME_WIDTH                320
+#define TEST_FRAME_HEIGHT               240
+
+/**
+ * @brief Copy of the applyHomographyMatrix of the first versions, used by the baseline coverage.
+ *
+ * @param image_src - image where the homography matrix will be applied.
+ * @param homography_matrix - homography matrix.
+ * @param image_result - object to save the image after the application of the homography matrix.
+ *
+ * @return \c bool - false if the consistency is not maintained. In this case the image_result is a copy of the image_src.
+ */
+static bool applyBaselineHomography ( const cv::Mat &image_src, const cv::Mat &homography_matrix, cv::Mat &image_result ){
+    std::vector<cv::Point2f> img_corners(4);
+    img_corners[0] = cv::Point2f ( 0             , 0);
+    img_corners[1] = cv::Point2f ( image_src.cols , 0 );
+    img_corners[2] = cv::Point2f ( 0             , image_src.rows );
+    img_corners[3] = cv::Point2f ( image_src.cols , image_src.rows );
+    std::vector<cv::Point2f> new_img_corners(4);
+
+    perspectiveTransform( img_corners, new_img_corners, homography_matrix);
+
+    int height = image_src.rows,
+        width = image_src.cols;
+
+    for (int i = 0 ; i < 4 ; i++){
+        if ( int(ceil(new_img_corners.at(i).x)) > width )
+            width = int(ceil(new_img_corners.at(i).x));
+        if ( int(ceil(new_img_corners.at(i).y)) > height )
+            height = int(ceil(new_img_corners.at(i).y));
+    }
+
+    if ( ! checkHomographyConsistency( new_img_corners )
+         || width > 4 * image_src.cols
+         || height > 4 * image_src.rows ){
+        image_result = image_src.clone();
+        return false;
+    }
+
+    cv::warpPerspective( image_src, image_result, homography_matrix , cv::Size(width, height) );
+    return true;
+}
+
+/**
+ * @brief Copy of the getAreaRatio of the first versions: warps a white mask with the type of the image and counts the
+ *          pixels of the ROI left black.
+ *
+ * @param image_src - The source image.
+ * @param homography_matrix - The homography matrix.
+ * @param frame_limits - The region of interest (ROI).
+ *
+ * @return \c double - The ratio between non-image area and the whole frame area.
+ */
+static double getBaselineAreaRatio ( const cv::Mat& image_src, const cv::Mat& homography_matrix, const cv::Rect& frame_limits ){
+
+    cv::Mat homography_mask = cv::Mat(image_src.rows, image_src.cols, image_src.type(), cv::Scalar::all(255)),
+            frame_mask,
+            intersection_mask,
+            homography_mask_result;
+
+    applyBaselineHomography(homography_mask, homography_matrix, homography_mask_result);
+    frame_mask = cv::Mat::zeros(homography_mask_result.rows, homography_mask_result.cols, image_src.type());
+    frame_mask(frame_limits) = cv::Scalar::all(255);
+    intersection_mask = frame_mask & homography_mask_result;
+
+    cv::cvtColor(intersection_mask, intersection_mask, CV_BGR2GRAY);
+
+    cv::Mat intersection_mask_bw;
+    cv::threshold(intersection_mask(frame_limits), intersection_mask_bw, 1, 255, CV_THRESH_BINARY_INV | CV_THRESH_OTSU);
+
+   return cv::countNonZero(intersection_mask_bw)/double(frame_limits.height*frame_limits.width);
+}
+
+/**
+ * @brief Function that checks if a different decision of the coverage of a ROI is explained by the rounding of the
+ *          raster: the area ratio of the baseline is within one pixel of border of the ROI from the threshold.
+ *
+ * @param baseline_area_ratio - area ratio of the baseline.
+ * @param frame_limits - The region of interest (ROI).
+ *
+ * @return \c bool
+ */
+static bool isBorderline ( const double baseline_area_ratio, const cv::Rect& frame_limits ){
+    const double border = 2.0 * ( frame_limits.width + frame_limits.height ) / double(frame_limits.width * frame_limits.height);
+    return std::fabs( baseline_area_ratio - MAXIMUM_AREA_ALLOWED ) <= border;
+}
+
+/**
+ * @brief Function that creates a random homography around the center of the frame. Most of them are the small motions
+ *          of the stabilization, and some have strong perspective, so the inconsistent projections are also checked.
+ *
+ * @param rng - random number generator.
+ *
+ * @return \c cv::Mat - the homography, CV_64F.
+ */
+static cv::Mat getRandomHomography ( cv::RNG &rng ){
+    const double cx = TEST_FRAME_WIDTH / 2.0,
+            cy = TEST_FRAME_HEIGHT / 2.0,
+            strong = rng.uniform(0.0, 1.0) < 0.1 ? 10.0 : 1.0,
+            angle = rng.uniform(-0.05, 0.05) * strong,
+            scale = 1.0 + rng.uniform(-0.1, 0.1),
+            tx = rng.uniform(-0.08, 0.08) * TEST_FRAME_WIDTH * strong,
+            ty = rng.uniform(-0.08, 0.08) * TEST_FRAME_HEIGHT * strong,
+            px = rng.uniform(-2e-4, 2e-4) * strong,
+            py = rng.uniform(-2e-4, 2e-4) * strong;
+
+    cv::Mat to_origin = ( cv::Mat_<double>(3,3) << 1, 0, -cx, 0, 1, -cy, 0, 0, 1 ),
+            motion = ( cv::Mat_<double>(3,3) << scale * std::cos(angle), -scale * std::sin(angle), tx,
+                                                scale * std::sin(angle),  scale * std::cos(angle), ty,
+                                                px, py, 1 ),
+            to_center = ( cv::Mat_<double>(3,3) << 1, 0, cx, 0, 1, cy, 0, 0, 1 );
+
+    return to_center * motion * to_origin;
+}
+
+/**
+ * @brief Function that creates a ROI centered in the frame, with a random portion of the frame cut in each border and
+ *          a small random shift.
+ *
+ * @param rng - random number generator.
+ * @param min_portion - minimum portion of the frame cut in each border.
+ * @param max_portion - maximum portion of the frame cut in each border.
+ *
+ * @return \c cv::Rect - the ROI, inside the frame.
+ */
+static cv::Rect getRandomArea ( cv::RNG &rng, const double min_portion, const double max_portion ){
+    const double portion = rng.uniform(min_portion, max_portion);
+    const int x = int(TEST_FRAME_WIDTH * portion) + rng.uniform(-2, 3),
+            y = int(TEST_FRAME_HEIGHT * portion) + rng.uniform(-2, 3);
+
+    return cv::Rect( x, y, TEST_FRAME_WIDTH - 2 * int(TEST_FRAME_WIDTH * portion), TEST_FRAME_HEIGHT - 2 * int(TEST_FRAME_HEIGHT * portion) ) &
+            cv::Rect( 0, 0, TEST_FRAME_WIDTH, TEST_FRAME_HEIGHT );
+}
+
+int main ( void ){
+    const cv::Mat frame ( TEST_FRAME_HEIGHT , TEST_FRAME_WIDTH , CV_8UC3 , cv::Scalar::all(0) );
+    cv::RNG rng;
+
+    int num_coverages[3] = { 0, 0, 0 },
+            num_borderline = 0,
+            num_mismatches = 0;
+
+    for ( int i = 0 ; i < TEST_NUM_HOMOGRAPHIES ; i++ ) {
+        const cv::Mat homography = getRandomHomography(rng);
+        const cv::Rect crop_area = getRandomArea(rng, 0.02, 0.1),
+                drop_area = getRandomArea(rng, 0.15, 0.3);
+
+        const double baseline_crop = getBaselineAreaRatio(frame, homography, crop_area),
+                baseline_drop = getBaselineAreaRatio(frame, homography, drop_area);
+        const HomogCoverage baseline = baseline_crop <= MAXIMUM_AREA_ALLOWED ? CROP_AREA :
+                                       baseline_drop <= MAXIMUM_AREA_ALLOWED ? DROP_AREA : NO_AREA,
+                coverage = getHomogCoverage(frame, homography, drop_area, crop_area);
+
+        num_coverages[baseline]++;
+        if ( coverage == baseline )
+            continue;
+
+        // The crop area is decided first, and the drop area only when both agree that the crop area is not covered.
+        const bool crop_differs = ( baseline == CROP_AREA ) != ( coverage == CROP_AREA );
+        if ( crop_differs ? isBorderline(baseline_crop, crop_area) : isBorderline(baseline_drop, drop_area) ) {
+            num_borderline++;
+            continue;
+        }
+
+        num_mismatches++;
+        std::cout << " --(!) Coverage " << coverage << " instead of " << baseline << " with crop area ratio " << baseline_crop
+                  << " and drop area ratio " << baseline_drop << " for the homography" << std::endl << homography << std::endl;
+    }
+
+    std::cout << TEST_NUM_HOMOGRAPHIES << " homographies: " << num_coverages[CROP_AREA] << " crop, " << num_coverages[DROP_AREA]
+              << " drop and " << num_coverages[NO_AREA] << " no area in the baseline. " << num_borderline
+              << " borderline differences, " << num_mismatches << " mismatches." << std::endl;
+
+    return num_mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,253 @@
+//////////////////////////////////////////////////////////////////////////////////////
+////   This file is part of SemanticFastForward_EPIC@ECCVW.
+//
+//    SemanticFastForward_EPIC@ECCVW is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    SemanticFastForward_JVCI is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU General Public License
+//    along with SemanticFastForward_EPIC@ECCVW.  If not, see <http://www.gnu.org/licenses/>.
+//
+///////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * @file test_homography_ransac.cpp
+ *
+ * Checks of the HomographyRansac: the PROSAC sampling schedule, the number of inliers against the cv::findHomography
+ * with CV_RANSAC on synthetic matches, and the agreement of the SIMD scoring paths with the scalar one.
+ *
+ * The source is included to reach its static functions. Returns 0 if all the checks pass.
+ *
+ */
+
+#include <iostream>
+
+#include "src/homography_ransac.cpp"
+
+/** Number of samples drawn in each phase of the PROSAC sampling check. */
+#define TEST_NUM_SAMPLES                10000
+
+/** Number of matches from which the PROSAC samples are drawn. */
+#define TEST_SAMPLING_RANGE             40
+
+/** Maximum difference of inliers to the cv::findHomography and to the ground truth: 5% of the matches, at least 2. Neither
+ *  estimator refines the consensus, so a model fitted to a noisy sample may miss some inliers far from its points. */
+#define TEST_INLIERS_TOLERANCE(N)       std::max( 2 , (N) / 20 )
+
+/**
+ * @brief Function that checks the PROSAC schedule: up to T'n the n-th match is in every sample, and after it the
+ *          samples are uniform over the n best matches.
+ *
+ * @return \c bool - true if the check passes.
+ *
+ * @date 17/10/2026
+ */
+static bool checkProsacSampling ( void ){
+    cv::RNG rng;
+    int sample[RANSAC_SAMPLE_SIZE];
+    const int n = TEST_SAMPLING_RANGE,
+            T_n_prime = TEST_NUM_SAMPLES;
+
+    for ( int t = 1 ; t <= T_n_prime ; t++ ) {
+        drawProsacSample(rng, t, n, T_n_prime, sample);
+        if ( sample[RANSAC_SAMPLE_SIZE-1] != n-1 ) {
+            std::cout << " --(!) The n-th match is not in the sample of the iteration " << t << " before T'n." << std::endl;
+            return false;
+        }
+        for ( int i = 0 ; i < RANSAC_SAMPLE_SIZE-1 ; i++ )
+            if ( sample[i] < 0 || sample[i] >= n-1 ) {
+                std::cout << " --(!) The sample of the iteration " << t << " has a match out of the n-1 best ones." << std::endl;
+                return false;
+            }
+    }
+
+    // Each match is in RANSAC_SAMPLE_SIZE of each n uniform samples.
+    int with_last = 0;
+    for ( int t = T_n_prime + 1 ; t <= T_n_prime + TEST_NUM_SAMPLES ; t++ ) {
+        drawProsacSample(rng, t, n, T_n_prime, sample);
+        for ( int i = 0 ; i < RANSAC_SAMPLE_SIZE ; i++ ) {
+            if ( sample[i] < 0 || sample[i] >= n ) {
+                std::cout << " --(!) The sample of the iteration " << t << " has a match out of the n best ones." << std::endl;
+                return false;
+            }
+            with_last += sample[i] == n-1;
+        }
+    }
+
+    const double expected = double(TEST_NUM_SAMPLES) * RANSAC_SAMPLE_SIZE / n;
+    if ( std::fabs(with_last - expected) > 0.3 * expected ) {
+        std::cout << " --(!) The n-th match is in " << with_last << " of the uniform samples, expected about " << expected << "." << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Function that creates matches between random points and their projection by a homography, with some of them
+ *          replaced by random outliers.
+ *
+ * @param rng - random number generator.
+ * @param num_matches - number of matches.
+ * @param inlier_ratio - ratio of matches that follow the homography.
+ * @param inliers_first - if true, the inliers have the smallest distances, as the matches of real frames usually have.
+ *          Otherwise the distances are random, and the PROSAC must do as well as a RANSAC without ordering.
+ * @param keypoints_src - object to save the keypoints of the source frame.
+ * @param keypoints_dst - object to save the keypoints of the destination frame.
+ * @param matches - object to save the matches.
+ *
+ * @return \c int - the number of inliers.
+ *
+ * @date 17/10/2026
+ */
+static int createSyntheticMatches ( cv::RNG &rng, const int num_matches, const double inlier_ratio, const bool inliers_first,
+                                    std::vector<cv::KeyPoint> &keypoints_src, std::vector<cv::KeyPoint> &keypoints_dst,
+                                    std::vector<cv::DMatch> &matches ){
+    const double H[9] = { 1.05, 0.02, 12.0, -0.03, 0.98, -7.0, 1e-5, 2e-5, 1.0 };
+    const double width = 1280, height = 720;
+
+    keypoints_src.resize(num_matches);
+    keypoints_dst.resize(num_matches);
+    matches.resize(num_matches);
+
+    int num_inliers = 0;
+    for ( int i = 0 ; i < num_matches ; i++ ) {
+        const double x = rng.uniform(0.0, width),
+                y = rng.uniform(0.0, height);
+        const bool inlier = rng.uniform(0.0, 1.0) < inlier_ratio;
+
+        keypoints_src[i].pt = cv::Point2f(float(x), float(y));
+        if ( inlier ) {
+            const double w = H[6]*x + H[7]*y + H[8];
+            keypoints_dst[i].pt = cv::Point2f(float( ( H[0]*x + H[1]*y + H[2] ) / w + rng.gaussian(0.5) ),
+                                              float( ( H[3]*x + H[4]*y + H[5] ) / w + rng.gaussian(0.5) ));
+            num_inliers++;
+        }
+        else
+            keypoints_dst[i].pt = cv::Point2f(float(rng.uniform(0.0, width)), float(rng.uniform(0.0, height)));
+
+        matches[i].queryIdx = i;
+        matches[i].trainIdx = i;
+        matches[i].distance = float(rng.uniform(0.0, 0.1) + ( inliers_first && !inlier ? 0.1 : 0.0 ));
+    }
+
+    return num_inliers;
+}
+
+/**
+ * @brief Function that compares the inliers of the HomographyRansac with the cv::findHomography with CV_RANSAC and with
+ *          the ground truth, on synthetic matches with several sizes, inlier ratios and orders.
+ *
+ * @return \c bool - true if the check passes.
+ *
+ * @date 17/10/2026
+ */
+static bool checkSyntheticParity ( void ){
+    const int num_matches[] = { 60, 300, 1000 };
+    const double inlier_ratios[] = { 0.3, 0.5, 0.8 };
+
+    HomographyRansac &estimator = HomographyRansac::getEstimator();
+    cv::RNG rng;
+    bool passed = true;
+
+    for ( int i_size = 0 ; i_size < 3 ; i_size++ )
+        for ( int i_ratio = 0 ; i_ratio < 3 ; i_ratio++ )
+            for ( int inliers_first = 0 ; inliers_first < 2 ; inliers_first++ ) {
+                const int N = num_matches[i_size];
+
+                std::vector<cv::KeyPoint> keypoints_src, keypoints_dst;
+                std::vector<cv::DMatch> matches;
+                const int num_inliers = createSyntheticMatches(rng, N, inlier_ratios[i_ratio], inliers_first != 0,
+                                                               keypoints_src, keypoints_dst, matches);
+
+                cv::Mat homography_matrix, ransac_mask;
+                estimator.findHomography(keypoints_src, keypoints_dst, matches, homography_matrix, ransac_mask);
+                const int mask_inliers = cv::countNonZero(ransac_mask),
+                        count_inliers = estimator.countInliers(keypoints_src, keypoints_dst, matches);
+
+                std::vector<cv::Point2f> points_src, points_dst;
+                for ( int i = 0 ; i < N ; i++ ) {
+                    points_src.push_back(keypoints_src[i].pt);
+                    points_dst.push_back(keypoints_dst[i].pt);
+                }
+                cv::Mat opencv_mask;
+                cv::findHomography(points_src, points_dst, CV_RANSAC, RANSAC_REPROJECTION_THRESHOLD, opencv_mask);
+                const int opencv_inliers = cv::countNonZero(opencv_mask);
+
+                const bool ok = count_inliers == mask_inliers &&
+                        std::abs(count_inliers - opencv_inliers) <= TEST_INLIERS_TOLERANCE(N) &&
+                        std::abs(count_inliers - num_inliers) <= TEST_INLIERS_TOLERANCE(N);
+
+                std::cout << "    " << N << " matches, " << inlier_ratios[i_ratio] << " inliers" << ( inliers_first ? " first" : " in random order" )
+                          << ": truth " << num_inliers << ", OpenCV " << opencv_inliers << ", mask " << mask_inliers
+                          << ", count " << count_inliers << ( ok ? "" : "  <-- FAILED" ) << std::endl;
+                passed = passed && ok;
+            }
+
+    return passed;
+}
+
+/**
+ * @brief Function that checks that the SIMD paths supported by the processor count the same inliers as the scalar one.
+ *
+ * @return \c bool - true if the check passes.
+ *
+ * @date 17/10/2026
+ */
+static bool checkScoringPaths ( void ){
+    // Not a multiple of the vector sizes, so the tails are checked.
+    const int num_points = 1003;
+    const float model[9] = { 1.0f, 0.0f, 0.5f, 0.0f, 1.0f, 0.2f, 1e-6f, 0.0f, 1.0f };
+
+    cv::RNG rng;
+    std::vector<float> src_x(num_points), src_y(num_points), dst_x(num_points), dst_y(num_points);
+    for ( int i = 0 ; i < num_points ; i++ ) {
+        src_x[i] = rng.uniform(0.0f, 1280.0f);
+        src_y[i] = rng.uniform(0.0f, 720.0f);
+        dst_x[i] = src_x[i] + rng.uniform(-5.0f, 5.0f);
+        dst_y[i] = src_y[i] + rng.uniform(-5.0f, 5.0f);
+    }
+
+    const float thresholds[] = { 1.0f, 4.0f, 9.0f, 25.0f };
+    for ( int i = 0 ; i < 4 ; i++ ) {
+        const int scalar = countInliersScalar(model, &src_x[0], &src_y[0], &dst_x[0], &dst_y[0], 0, num_points, thresholds[i]);
+#if HOMOGRAPHY_RANSAC_X86
+        if ( best_ransac_path >= RANSAC_PATH_SSE2 &&
+             countInliersSSE2(model, &src_x[0], &src_y[0], &dst_x[0], &dst_y[0], 0, num_points, thresholds[i]) != scalar ) {
+            std::cout << " --(!) The SSE2 path differs from the scalar one with threshold " << thresholds[i] << "." << std::endl;
+            return false;
+        }
+        if ( best_ransac_path >= RANSAC_PATH_AVX &&
+             countInliersAVX(model, &src_x[0], &src_y[0], &dst_x[0], &dst_y[0], 0, num_points, thresholds[i]) != scalar ) {
+            std::cout << " --(!) The AVX path differs from the scalar one with threshold " << thresholds[i] << "." << std::endl;
+            return false;
+        }
+#else
+        (void)scalar;
+#endif
+    }
+
+    return true;
+}
+
+int main ( void ){
+    bool passed = true;
+
+    std::cout << "PROSAC sampling:" << std::endl;
+    passed = checkProsacSampling() && passed;
+
+    std::cout << "Inliers of synthetic matches:" << std::endl;
+    passed = checkSyntheticParity() && passed;
+
+    std::cout << "Scoring paths:" << std::endl;
+    passed = checkScoringPaths() && passed;
+
+    std::cout << ( passed ? "All checks passed." : " --(!) Some checks failed." ) << std::endl;
+    return passed ? 0 : 1;
+}